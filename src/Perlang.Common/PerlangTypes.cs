@@ -38,7 +38,8 @@ public static class PerlangTypes
         // TODO: Support as_utf16() here too
         new CppPropertyGetter("length", new TypeReference(PerlangValueTypes.Int64), methodName: "length")
     ], extraMethods: [
-        new CppFunction("as_ascii", parameters: [], new TypeReference(perlang_cli.CreateNullToken(TokenType.IDENTIFIER, "ASCIIString", file_name: "", line: 0)))
+        new CppFunction("as_ascii", parameters: [], new TypeReference(perlang_cli.CreateNullToken(TokenType.IDENTIFIER, "ASCIIString", file_name: "", line: 0))),
+        new CppFunction("as_utf8", parameters: [], new TypeReference(perlang_cli.CreateNullToken(TokenType.IDENTIFIER, "UTF8String", file_name: "", line: 0)))
     ]);
 
     public static readonly CppType PerlangClass = new CppType("PerlangClass", "PerlangClass", wrapInSharedPtr: true);
@@ -108,6 +108,13 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
     private readonly IDictionary<string, string> classDefinitions;
     private readonly IDictionary<string, string> classImplementations;
 
+    /// <summary>
+    /// All distinct string literals encountered so far, mapped to the name of the C++ variable holding them. Each
+    /// literal is emitted once as a static variable, so that using a literal (for example in a loop) does not allocate
+    /// and validate a new string every time.
+    /// </summary>
+    private readonly IDictionary<(string CppType, string Literal), string> stringLiterals;
+
     /// <summary>
     /// The location in the output we are currently writing to. Can be an enum, function, etc.
     /// </summary>
@@ -142,6 +149,7 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
         this.enums = new Dictionary<string, string>();
         this.classDefinitions = new Dictionary<string, string>();
         this.classImplementations = new Dictionary<string, string>();
+        this.stringLiterals = new Dictionary<(string CppType, string Literal), string>();
 
         this.cppTypeRegistry = new CppTypeRegistry();
 
@@ -661,6 +669,21 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
 
 """);
 
+                if (stringLiterals.Count > 0) {
+                    streamWriter.WriteLine("//");
+                    streamWriter.WriteLine("// String literals");
+                    streamWriter.WriteLine("//");
+
+                    // These are only referenced from this file, so they are defined here rather than in the header
+                    // (which would give every translation unit including it a copy of its own). They are static since
+                    // the names are only unique within a single compilation.
+                    foreach (var ((cppType, literal), name) in stringLiterals) {
+                        streamWriter.WriteLine($"static const std::shared_ptr<{cppType}> {name} = {cppType}::make_shared_literal(\"{literal}\");");
+                    }
+
+                    streamWriter.WriteLine();
+                }
+
                 if (classImplementations.Count > 0) {
                     streamWriter.WriteLine("//");
                     streamWriter.WriteLine("// Perlang class implementations");
@@ -1101,18 +1124,20 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
                 else if (expr.Left.TypeReference.IsStringType && expr.Right.TypeReference.IsStringType)
                 {
                     // The dereference operator (*) must be used to dereference the std::shared_ptr instances
-                    // Parentheses required to workaround "indirection requires pointer operand" errors in the C++ compilation
-                    result.Append($"(*{leftCast}{expr.Left.Accept(this)} + *{rightCast}{expr.Right.Accept(this)})");
+                    //
+                    // concat_shared() is used instead of operator+, since the latter returns a std::unique_ptr which
+                    // gets a separate control block allocation when it is converted to std::shared_ptr.
+                    result.Append($"perlang::concat_shared(*{leftCast}{expr.Left.Accept(this)}, *{rightCast}{expr.Right.Accept(this)})");
                 }
                 else if (expr.Left.TypeReference.IsStringType && expr.Right.TypeReference.IsValidNumberType)
                 {
                     // The dereference operator (*) must be used to dereference the std::shared_ptr instance
-                    result.Append($"(*{leftCast}{expr.Left.Accept(this)} + {rightCast}{expr.Right.Accept(this)})");
+                    result.Append($"perlang::concat_shared(*{leftCast}{expr.Left.Accept(this)}, {rightCast}{expr.Right.Accept(this)})");
                 }
                 else if (expr.Left.TypeReference.IsValidNumberType && expr.Right.TypeReference.IsStringType)
                 {
                     // The dereference operator (*) must be used to dereference the std::shared_ptr instance
-                    result.Append($"({leftCast}{expr.Left.Accept(this)} + *{rightCast}{expr.Right.Accept(this)})");
+                    result.Append($"perlang::concat_shared({leftCast}{expr.Left.Accept(this)}, *{rightCast}{expr.Right.Accept(this)})");
                 }
                 else
                 {
@@ -1439,29 +1464,41 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
         return result.ToString();
     }
 
+    /// <summary>
+    /// Returns the name of the static C++ variable holding the given string literal, registering a new variable if this
+    /// is the first time the literal is encountered.
+    /// </summary>
+    /// <param name="cppType">The C++ type of the string.</param>
+    /// <param name="expr">The literal expression.</param>
+    /// <returns>The name of the C++ variable.</returns>
+    private string StringLiteralVariable(string cppType, Expr.Literal expr)
+    {
+        string literal = expr.ToString();
+
+        if (!stringLiterals.TryGetValue((cppType, literal), out string? name)) {
+            name = $"perlang_string_literal_{stringLiterals.Count}";
+            stringLiterals[(cppType, literal)] = name;
+        }
+
+        return name;
+    }
+
     public object VisitLiteralExpr(Expr.Literal expr)
     {
         using var result = NativeStringBuilder.Create();
 
         if (expr.Value is AsciiString)
         {
-            // The value is an ASCII string literal, so it is safe to use this factory method to wrap it in an AsciiString
-            // on the C++ side. (The "static string" is the important part here; because we know that it's a literal, we
-            // can assume "shared" ownership of it and assume that it will never be deallocated for the whole lifetime of
-            // the program.)
-            result.Append("perlang::ASCIIString::from_static_string(\"");
-            result.Append(expr);
-            result.Append("\")");
+            // The value is an ASCII string literal, so it is safe to use the non-validating make_shared_literal()
+            // factory method to wrap it in an ASCIIString on the C++ side. Because we know that it's a literal, we can
+            // assume "shared" ownership of it and assume that it will never be deallocated for the whole lifetime of the
+            // program.
+            result.Append(StringLiteralVariable("perlang::ASCIIString", expr));
         }
         else if (expr.Value is Utf8String)
         {
-            // The value is a UTF-8 string literal, so it is safe to use this factory method to wrap it in an UTF8String
-            // on the C++ side. (The "static string" is the important part here; because we know that it's a literal, we
-            // can assume "shared" ownership of it and assume that it will never be deallocated for the whole lifetime of
-            // the program.)
-            result.Append("perlang::UTF8String::from_static_string(\"");
-            result.Append(expr);
-            result.Append("\")");
+            // Likewise for UTF-8 string literals, which are wrapped in an UTF8String on the C++ side.
+            result.Append(StringLiteralVariable("perlang::UTF8String", expr));
         }
         else if (expr.Value is char c)
         {
@@ -2261,6 +2298,10 @@ public class PerlangCompiler : Expr.IVisitor<object?>, Stmt.IVisitor<object>, IT
                 if ({{tmpName}}.index() == 1) {
                     auto __err = std::get<1>({{tmpName}});
 
+                    // Output from print() is buffered, and abort() below would discard it. Flushing it first also makes
+                    // it appear before the error message.
+                    perlang::flush();
+
                     // TODO: Should not blindly use bytes() on the string here, but this will probably work as long as
                     // the string is ASCII or UTF-8 and the terminal can handle that. Could be problematic on e.g.
                     // Windows.
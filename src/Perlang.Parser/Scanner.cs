@@ -24,7 +24,9 @@ namespace Perlang.Parser;
 public class Scanner : IDisposable
 {
     // NOTE: When making changes here, remember to adjust highlightjs-perlang.js also to ensure syntax highlighting
-    // on the website matches the real set of keywords in the language.
+    // on the website matches the real set of keywords in the language. The keyword table in
+    // src/perlang_cli/src/reserved_keywords.cc must also be kept in sync, since it is used for looking up the keywords
+    // in ReservedKeywords (when it contains a different set of keywords, the slower hash-based lookup is used instead).
     private static readonly Dictionary<string, TokenType> ReservedKeywordsDictionary =
         new Dictionary<string, TokenType>
         {
@@ -118,7 +120,9 @@ public class Scanner : IDisposable
             { "asm", RESERVED_WORD }
         };
 
-    private static StringTokenTypeDictionary ReservedKeywords => ReservedKeywordsDictionary
+    // Created once and reused, since converting the dictionary to its native representation is far more expensive than
+    // the lookups performed on it.
+    private static readonly StringTokenTypeDictionary ReservedKeywords = ReservedKeywordsDictionary
         .ToPerlangStringTokenTypeDictionary();
 
     public static StringHashSet ReservedTypeKeywordStrings =>
@@ -13,7 +13,7 @@ void MutableStringTokenTypeDictionary::add(const char* key, TokenType::TokenType
 bool MutableStringTokenTypeDictionary::contains_key(const char* key)
 {
     // TODO: Replace with contains() once we are on C++20
-    return data_.count(perlang::ASCIIString::from_copied_string(key)) == 1;
+    return data_.count(string_key(key)) == 1;
 }
 
 std::vector<std::shared_ptr<perlang::String>> MutableStringTokenTypeDictionary::keys()
@@ -29,10 +29,16 @@ std::vector<std::shared_ptr<perlang::String>> MutableStringTokenTypeDictionary::
 
 TokenType::TokenType MutableStringTokenTypeDictionary::get(const char* key)
 {
-    return data_[perlang::ASCIIString::from_copied_string(key)];
+    // Unlike operator[], find() supports looking up the key without creating a String for it. Missing keys give the
+    // same result as operator[] would have, but without adding the key to the dictionary.
+    auto it = data_.find(string_key(key));
+
+    return it != data_.end() ? it->second : TokenType::TokenType {};
 }
 
 TokenType::TokenType MutableStringTokenTypeDictionary::get(std::shared_ptr<perlang::String> key)
 {
-    return data_[key];
+    auto it = data_.find(key);
+
+    return it != data_.end() ? it->second : TokenType::TokenType {};
 }
@@ -10,6 +10,22 @@
 
 #include "perlang_cli.h"
 
+//
+// String literals
+//
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_0 = perlang::ASCIIString::make_shared_literal("Unsupported base");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_1 = perlang::ASCIIString::make_shared_literal("##GIT_DESCRIBE_VERSION##");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_2 = perlang::ASCIIString::make_shared_literal("##GIT_COMMIT_ID##");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_3 = perlang::ASCIIString::make_shared_literal("##BUILD_TIMESTAMP##");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_4 = perlang::ASCIIString::make_shared_literal("##BUILD_USER##");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_5 = perlang::ASCIIString::make_shared_literal("##BUILD_HOST##");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_6 = perlang::ASCIIString::make_shared_literal("+");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_7 = perlang::ASCIIString::make_shared_literal("Perlang version: ");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_8 = perlang::ASCIIString::make_shared_literal("Built from git commit ");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_9 = perlang::ASCIIString::make_shared_literal(", ");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_10 = perlang::ASCIIString::make_shared_literal(" by ");
+static const std::shared_ptr<perlang::ASCIIString> perlang_string_literal_11 = perlang::ASCIIString::make_shared_literal("@");
+
 //
 // Perlang class implementations
 //
@@ -82,7 +98,7 @@ bool PerlangScanner::is_digit(char16_t c, NumericTokenBase::NumericTokenBase bas
             break;
         default:
             {
-                return bool{std::make_shared<perlang::ArgumentError>(perlang::ASCIIString::from_static_string("Unsupported base"))};
+                return bool{std::make_shared<perlang::ArgumentError>(perlang_string_literal_0)};
             }
             break;
     }
@@ -151,23 +167,23 @@ int32_t Token::line() {
 // Perlang function declarations
 //
 std::shared_ptr<perlang::String> get_git_describe_version() {
-    return perlang::ASCIIString::from_static_string("##GIT_DESCRIBE_VERSION##");
+    return perlang_string_literal_1;
 }
 
 std::shared_ptr<perlang::String> get_git_commit_id() {
-    return perlang::ASCIIString::from_static_string("##GIT_COMMIT_ID##");
+    return perlang_string_literal_2;
 }
 
 std::shared_ptr<perlang::String> get_build_timestamp() {
-    return perlang::ASCIIString::from_static_string("##BUILD_TIMESTAMP##");
+    return perlang_string_literal_3;
 }
 
 std::shared_ptr<perlang::String> get_build_user() {
-    return perlang::ASCIIString::from_static_string("##BUILD_USER##");
+    return perlang_string_literal_4;
 }
 
 std::shared_ptr<perlang::String> get_build_host() {
-    return perlang::ASCIIString::from_static_string("##BUILD_HOST##");
+    return perlang_string_literal_5;
 }
 
 void print_perlang_version() {
@@ -175,12 +191,12 @@ void print_perlang_version() {
 }
 
 std::shared_ptr<perlang::String> perlang_version() {
-    return (*(*get_git_describe_version() + *perlang::ASCIIString::from_static_string("+")) + *get_git_commit_id());
+    return perlang::concat_shared(*perlang::concat_shared(*get_git_describe_version(), *perlang_string_literal_6), *get_git_commit_id());
 }
 
 void perlang_detailed_version() {
-    perlang::print((*perlang::ASCIIString::from_static_string("Perlang version: ") + *perlang_version()));
-    perlang::print((*(*(*(*(*(*(*perlang::ASCIIString::from_static_string("Built from git commit ") + *get_git_commit_id()) + *perlang::ASCIIString::from_static_string(", ")) + *get_build_timestamp()) + *perlang::ASCIIString::from_static_string(" by ")) + *get_build_user()) + *perlang::ASCIIString::from_static_string("@")) + *get_build_host()));
+    perlang::print(perlang::concat_shared(*perlang_string_literal_7, *perlang_version()));
+    perlang::print(perlang::concat_shared(*perlang::concat_shared(*perlang::concat_shared(*perlang::concat_shared(*perlang::concat_shared(*perlang::concat_shared(*perlang::concat_shared(*perlang_string_literal_8, *get_git_commit_id()), *perlang_string_literal_9), *get_build_timestamp()), *perlang_string_literal_10), *get_build_user()), *perlang_string_literal_11), *get_build_host()));
 }
 
 //
@@ -303,10 +319,18 @@ bool is_null_token(Token* token)
 
 const char* get_token_lexeme(Token* token)
 {
-    // TODO: This (and the other similar methods) work, under the crude assumption that the underlying string is
-    // actually UTF-8 encoded (i.e. no UTF16String). When the 'as_utf8()' method exists in the String class, we should
-    // use that to ensure that we don't get any surprises here.
-    return token->lexeme()->bytes();
+    auto lexeme = token->lexeme();
+
+    if (lexeme->encoding() == perlang::StringEncoding::utf16) {
+        // The caller (the C# side) copies the returned string right away, so it's enough to keep the UTF-8 version
+        // alive until the next call on the same thread.
+        thread_local std::unique_ptr<perlang::UTF8String> utf8_lexeme;
+        utf8_lexeme = lexeme->as_utf8();
+
+        return utf8_lexeme->bytes();
+    }
+
+    return lexeme->bytes();
 }
 
 const char* get_token_string_literal(Token* token)
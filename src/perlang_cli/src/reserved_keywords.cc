@@ -0,0 +1,146 @@
+#include <array>
+#include <cstring>
+
+#include "reserved_keywords.h"
+
+namespace
+{
+    struct Keyword {
+        template <size_t N>
+        constexpr Keyword(const char (&text)[N], TokenType::TokenType type)
+            : text(text),
+              length(N - 1),
+              type(type)
+        {
+        }
+
+        const char* text;
+        size_t length;
+        TokenType::TokenType type;
+    };
+
+    // NOTE: This table must be sorted by keyword length, which is verified by a static_assert below.
+    constexpr Keyword keywords[] = {
+        { "if", TokenType::IF },
+        { "in", TokenType::IN },
+
+        { "asm", TokenType::RESERVED_WORD },
+        { "for", TokenType::FOR },
+        { "fun", TokenType::FUN },
+        { "let", TokenType::RESERVED_WORD },
+        { "new", TokenType::NEW },
+        { "try", TokenType::TRY },
+        { "var", TokenType::VAR },
+
+        { "byte", TokenType::RESERVED_WORD },
+        { "case", TokenType::CASE },
+        { "else", TokenType::ELSE },
+        { "enum", TokenType::ENUM },
+        { "lock", TokenType::RESERVED_WORD },
+        { "null", TokenType::PERLANG_NULL },
+        { "this", TokenType::THIS },
+        { "true", TokenType::TRUE },
+
+        { "async", TokenType::RESERVED_WORD },
+        { "await", TokenType::RESERVED_WORD },
+        { "break", TokenType::RESERVED_WORD },
+        { "catch", TokenType::RESERVED_WORD },
+        { "class", TokenType::CLASS },
+        { "false", TokenType::FALSE },
+        { "print", TokenType::PRINT },
+        { "sbyte", TokenType::RESERVED_WORD },
+        { "short", TokenType::RESERVED_WORD },
+        { "super", TokenType::SUPER },
+        { "throw", TokenType::RESERVED_WORD },
+        { "while", TokenType::WHILE },
+
+        { "extern", TokenType::EXTERN },
+        { "nameof", TokenType::RESERVED_WORD },
+        { "printf", TokenType::RESERVED_WORD },
+        { "public", TokenType::PUBLIC },
+        { "return", TokenType::RETURN },
+        { "sizeof", TokenType::RESERVED_WORD },
+        { "static", TokenType::STATIC },
+        { "struct", TokenType::RESERVED_WORD },
+        { "switch", TokenType::SWITCH },
+        { "typeof", TokenType::RESERVED_WORD },
+        { "ushort", TokenType::RESERVED_WORD },
+
+        { "decimal", TokenType::RESERVED_WORD },
+        { "default", TokenType::DEFAULT },
+        { "finally", TokenType::RESERVED_WORD },
+        { "foreach", TokenType::RESERVED_WORD },
+        { "mutable", TokenType::MUTABLE },
+        { "private", TokenType::PRIVATE },
+
+        { "continue", TokenType::RESERVED_WORD },
+        { "internal", TokenType::RESERVED_WORD },
+        { "volatile", TokenType::RESERVED_WORD },
+
+        { "protected", TokenType::RESERVED_WORD },
+
+        { "destructor", TokenType::DESTRUCTOR },
+
+        { "constructor", TokenType::CONSTRUCTOR },
+
+        { "synchronized", TokenType::RESERVED_WORD },
+    };
+
+    constexpr size_t keyword_count = sizeof(keywords) / sizeof(keywords[0]);
+    constexpr size_t max_keyword_length = keywords[keyword_count - 1].length;
+
+    constexpr bool is_sorted_by_length()
+    {
+        for (size_t i = 1; i < keyword_count; i++) {
+            if (keywords[i - 1].length > keywords[i].length) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(is_sorted_by_length(), "The keyword table must be sorted by length");
+
+    // offsets[n] is the index of the first keyword with a length of at least `n`. The keywords of length `n` are thus
+    // found in the [offsets[n], offsets[n + 1]) range of the table.
+    constexpr std::array<size_t, max_keyword_length + 2> make_offsets()
+    {
+        std::array<size_t, max_keyword_length + 2> result {};
+        size_t index = 0;
+
+        for (size_t length = 0; length < result.size(); length++) {
+            while (index < keyword_count && keywords[index].length < length) {
+                index++;
+            }
+
+            result[length] = index;
+        }
+
+        return result;
+    }
+
+    constexpr std::array<size_t, max_keyword_length + 2> offsets = make_offsets();
+}
+
+bool ReservedKeywords::classify(const char* text, size_t length, TokenType::TokenType& type)
+{
+    if (length > max_keyword_length) {
+        return false;
+    }
+
+    for (size_t i = offsets[length]; i < offsets[length + 1]; i++) {
+        // Comparing the first character separately rules out most of the candidates without a call to memcmp().
+        if (keywords[i].text[0] == text[0] && memcmp(keywords[i].text, text, length) == 0) {
+            type = keywords[i].type;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t ReservedKeywords::count()
+{
+    return keyword_count;
+}
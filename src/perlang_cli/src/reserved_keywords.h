@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+#include "perlang_cli.h"
+
+// The reserved keywords of the Perlang language, along with their token types. This is the same set of keywords as
+// in Scanner.ReservedKeywordsDictionary in Perlang.Parser; the two must be kept in sync.
+//
+// The keywords are stored in a table sorted by length, which is indexed by keyword length at compile time. Classifying
+// an identifier therefore only requires comparing it to the handful of keywords with the same length, without any
+// hashing or heap allocations.
+class ReservedKeywords {
+public:
+    // Returns true and sets `type` to the token type of the keyword if `text` (of `length` bytes, not necessarily
+    // NUL-terminated) is a reserved keyword. Returns false otherwise, leaving `type` unmodified.
+    static bool classify(const char* text, size_t length, TokenType::TokenType& type);
+
+    // The number of reserved keywords.
+    static size_t count();
+};
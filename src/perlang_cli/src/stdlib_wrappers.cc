@@ -5,6 +5,7 @@
 // - Make C++ methods accessible from C# (by wrapping them in extern "C" functions)
 // - Handle conversion from Perlang/C++ shared_ptr types to types that can be consumed from the C# side
 
+#include <cstring>
 #include <stdexcept>
 
 #include "perlang_stdlib.h"
@@ -44,17 +45,18 @@ extern "C"
             return;
         }
 
-        sb->append(*UTF8String::from_copied_string(s));
+        sb->append(s);
     }
 
     void StringBuilder_append_line(perlang::text::StringBuilder* sb, const char* s)
     {
         if (s == nullptr) {
-            sb->append_line(ASCIIString::empty);
+            sb->append_line();
             return;
         }
 
-        sb->append_line(UTF8String::from_copied_string(s));
+        sb->append(s);
+        sb->append_line();
     }
 
     uint StringBuilder_length(perlang::text::StringBuilder* sb)
@@ -64,8 +66,16 @@ extern "C"
 
     const char* StringBuilder_to_string(perlang::text::StringBuilder* sb)
     {
-        std::unique_ptr<String> result = sb->to_string();
-        return result->release_bytes().release();
+        // The content is copied straight from the builder, since going through a String would copy it twice: once
+        // to the string, and once more by release_bytes() (strings don't own a separately allocated buffer that could
+        // be handed over as-is).
+        size_t length = sb->length();
+        char* result = new char[length + 1];
+
+        memcpy(result, sb->data(), length);
+        result[length] = '\0';
+
+        return result;
     }
 
     void StringBuilder_delete_to_string_result(const char* s)
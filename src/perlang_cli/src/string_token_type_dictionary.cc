@@ -1,20 +1,61 @@
+#include <cstring>
+
 #include "perlang_cli.h"
+#include "reserved_keywords.h"
 #include "string_token_type_dictionary.h"
 
 StringTokenTypeDictionary::StringTokenTypeDictionary(MutableStringTokenTypeDictionary& source)
 {
+    size_t reserved_keyword_count = 0;
+
     for (const auto& item: source.keys()) {
-        data_[item] = source.get(item);
+        TokenType::TokenType type = source.get(item);
+        TokenType::TokenType keyword_type;
+
+        if (ReservedKeywords::classify(item->bytes(), item->length(), keyword_type) && keyword_type == type) {
+            reserved_keyword_count++;
+        }
+
+        data_[item] = type;
     }
+
+    // The keyword table can only be used if it's a subset of this dictionary. Otherwise, it would find keywords which
+    // aren't supposed to be found here.
+    has_reserved_keywords_ = reserved_keyword_count == ReservedKeywords::count();
 }
 
 bool StringTokenTypeDictionary::contains_key(const char* key)
 {
+    size_t length = strlen(key);
+    TokenType::TokenType type;
+
+    if (has_reserved_keywords_) {
+        if (ReservedKeywords::classify(key, length, type)) {
+            return true;
+        }
+
+        // No need to look in the dictionary, unless there are other keys than the reserved keywords in it.
+        if (data_.size() == ReservedKeywords::count()) {
+            return false;
+        }
+    }
+
     // TODO: Replace with contains() once we are on C++20
-    return data_.count(perlang::ASCIIString::from_copied_string(key)) == 1;
+    return data_.count(string_key(key, length)) == 1;
 }
 
 TokenType::TokenType StringTokenTypeDictionary::get(const char* key)
 {
-    return data_[perlang::ASCIIString::from_copied_string(key)];
+    size_t length = strlen(key);
+    TokenType::TokenType type;
+
+    if (has_reserved_keywords_ && ReservedKeywords::classify(key, length, type)) {
+        return type;
+    }
+
+    // Unlike operator[], find() supports looking up the key without creating a String for it. Missing keys give the
+    // same result as operator[] would have, but without adding the key to the dictionary.
+    auto it = data_.find(string_key(key, length));
+
+    return it != data_.end() ? it->second : TokenType::TokenType {};
 }
@@ -9,6 +9,10 @@ class StringTokenTypeDictionary {
 private:
     tsl::ordered_map<std::shared_ptr<perlang::String>, TokenType::TokenType, string_hasher, string_comparer> data_;
 
+    // True if this dictionary contains all the ReservedKeywords (with the same token types), in which case lookups
+    // are done using ReservedKeywords::classify() before falling back to `data_`.
+    bool has_reserved_keywords_ = false;
+
 public:
     StringTokenTypeDictionary(MutableStringTokenTypeDictionary&);
     bool contains_key(const char *);
@@ -21,3 +21,17 @@ TEST_CASE( "MutableStringTokenTypeDictionary, contains_key returns true when an
     // Assert
     REQUIRE(dictionary.get("some-key") == TokenType::TokenType::STAR_STAR);
 }
+
+TEST_CASE( "MutableStringTokenTypeDictionary, get does not add missing keys to the dictionary" )
+{
+    MutableStringTokenTypeDictionary dictionary;
+
+    dictionary.add("some-key", TokenType::TokenType::STAR_STAR);
+
+    // Act
+    dictionary.get("missing-key");
+    dictionary.get(perlang::UTF8String::from_copied_string("other-missing-key"));
+
+    // Assert
+    REQUIRE(dictionary.keys().size() == 1);
+}
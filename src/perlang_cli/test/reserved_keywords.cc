@@ -0,0 +1,52 @@
+// reserved_keywords.cc - tests for the ReservedKeywords class
+
+#include <cstring>
+#include <catch2/catch_test_macros.hpp>
+
+#include "reserved_keywords.h"
+
+static bool classify(const char* text, TokenType::TokenType& type)
+{
+    return ReservedKeywords::classify(text, strlen(text), type);
+}
+
+TEST_CASE( "ReservedKeywords, classify returns the token type of keywords" )
+{
+    TokenType::TokenType type;
+
+    REQUIRE(classify("if", type));
+    REQUIRE(type == TokenType::IF);
+
+    REQUIRE(classify("null", type));
+    REQUIRE(type == TokenType::PERLANG_NULL);
+
+    REQUIRE(classify("constructor", type));
+    REQUIRE(type == TokenType::CONSTRUCTOR);
+
+    REQUIRE(classify("synchronized", type));
+    REQUIRE(type == TokenType::RESERVED_WORD);
+}
+
+TEST_CASE( "ReservedKeywords, classify returns false for identifiers" )
+{
+    TokenType::TokenType type = TokenType::IDENTIFIER;
+
+    REQUIRE_FALSE(classify("", type));
+    REQUIRE_FALSE(classify("i", type));
+    REQUIRE_FALSE(classify("iff", type));
+    REQUIRE_FALSE(classify("Class", type));
+    REQUIRE_FALSE(classify("int", type));
+    REQUIRE_FALSE(classify("synchronizedx", type));
+    REQUIRE_FALSE(classify("some_very_long_identifier_name", type));
+
+    REQUIRE(type == TokenType::IDENTIFIER);
+}
+
+TEST_CASE( "ReservedKeywords, classify only looks at the given number of bytes" )
+{
+    TokenType::TokenType type;
+
+    // This is how the scanner uses it; the identifier is not NUL-terminated but part of a larger source buffer.
+    REQUIRE(ReservedKeywords::classify("while(true)", 5, type));
+    REQUIRE(type == TokenType::WHILE);
+}
@@ -0,0 +1,71 @@
+// stdlib_wrappers.cc - tests for the extern "C" wrappers used from C#
+
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+// The wrappers have no header of their own, since they are only meant to be called via P/Invoke.
+extern "C"
+{
+    perlang::text::StringBuilder* StringBuilder_new();
+    void StringBuilder_delete(perlang::text::StringBuilder* sb);
+    void StringBuilder_append(perlang::text::StringBuilder* sb, const char* s);
+    void StringBuilder_append_line(perlang::text::StringBuilder* sb, const char* s);
+    uint StringBuilder_length(perlang::text::StringBuilder* sb);
+    const char* StringBuilder_to_string(perlang::text::StringBuilder* sb);
+    void StringBuilder_delete_to_string_result(const char* s);
+}
+
+TEST_CASE( "StringBuilder_to_string, returns a NUL-terminated copy of the content" )
+{
+    perlang::text::StringBuilder* sb = StringBuilder_new();
+    StringBuilder_append(sb, "räksmörgås");
+    StringBuilder_append(sb, nullptr);
+    StringBuilder_append_line(sb, " and more");
+    StringBuilder_append_line(sb, nullptr);
+
+    const char* result = StringBuilder_to_string(sb);
+
+    // Assert
+    REQUIRE(std::string(result) == "räksmörgås and more\n\n");
+    REQUIRE(StringBuilder_length(sb) == 24);
+
+    // The builder can still be used, and the returned copy is not affected by it.
+    StringBuilder_append(sb, "!");
+    REQUIRE(std::string(result) == "räksmörgås and more\n\n");
+
+    StringBuilder_delete_to_string_result(result);
+    StringBuilder_delete(sb);
+}
+
+TEST_CASE( "StringBuilder_to_string, copies content larger than the inline buffer" )
+{
+    perlang::text::StringBuilder* sb = StringBuilder_new();
+    std::string expected;
+
+    for (int i = 0; i < 1000; i++) {
+        StringBuilder_append(sb, "abc");
+        expected += "abc";
+    }
+
+    const char* result = StringBuilder_to_string(sb);
+
+    // Assert
+    REQUIRE(std::string(result) == expected);
+
+    StringBuilder_delete_to_string_result(result);
+    StringBuilder_delete(sb);
+}
+
+TEST_CASE( "StringBuilder_to_string, returns an empty string for an empty builder" )
+{
+    perlang::text::StringBuilder* sb = StringBuilder_new();
+    const char* result = StringBuilder_to_string(sb);
+
+    // Assert
+    REQUIRE(result[0] == '\0');
+
+    StringBuilder_delete_to_string_result(result);
+    StringBuilder_delete(sb);
+}
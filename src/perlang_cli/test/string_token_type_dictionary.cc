@@ -0,0 +1,71 @@
+// string_token_type_dictionary.cc - tests for the StringTokenTypeDictionary class
+
+#include <cstring>
+#include <catch2/catch_test_macros.hpp>
+
+#include "reserved_keywords.h"
+#include "string_token_type_dictionary.h"
+
+// Adds all the reserved keywords to the given dictionary, like the Perlang scanner does.
+static void add_reserved_keywords(MutableStringTokenTypeDictionary& dictionary)
+{
+    for (const char* keyword : { "if", "in", "asm", "for", "fun", "let", "new", "try", "var", "byte", "case", "else",
+                                 "enum", "lock", "null", "this", "true", "async", "await", "break", "catch", "class",
+                                 "false", "print", "sbyte", "short", "super", "throw", "while", "extern", "nameof",
+                                 "printf", "public", "return", "sizeof", "static", "struct", "switch", "typeof",
+                                 "ushort", "decimal", "default", "finally", "foreach", "mutable", "private",
+                                 "continue", "internal", "volatile", "protected", "destructor", "constructor",
+                                 "synchronized" }) {
+        TokenType::TokenType type;
+        REQUIRE(ReservedKeywords::classify(keyword, strlen(keyword), type));
+
+        dictionary.add(keyword, type);
+    }
+}
+
+TEST_CASE( "StringTokenTypeDictionary, finds reserved keywords" )
+{
+    MutableStringTokenTypeDictionary source;
+    add_reserved_keywords(source);
+
+    StringTokenTypeDictionary dictionary(source);
+
+    REQUIRE(dictionary.contains_key("while"));
+    REQUIRE(dictionary.get("while") == TokenType::WHILE);
+    REQUIRE_FALSE(dictionary.contains_key("whilst"));
+}
+
+TEST_CASE( "StringTokenTypeDictionary, finds keys added in addition to the reserved keywords" )
+{
+    MutableStringTokenTypeDictionary source;
+    add_reserved_keywords(source);
+    source.add("some-key", TokenType::STAR_STAR);
+
+    StringTokenTypeDictionary dictionary(source);
+
+    REQUIRE(dictionary.contains_key("some-key"));
+    REQUIRE(dictionary.get("some-key") == TokenType::STAR_STAR);
+    REQUIRE(dictionary.get("class") == TokenType::CLASS);
+}
+
+TEST_CASE( "StringTokenTypeDictionary, does not find reserved keywords which have not been added" )
+{
+    MutableStringTokenTypeDictionary source;
+    source.add("class", TokenType::CLASS);
+
+    StringTokenTypeDictionary dictionary(source);
+
+    REQUIRE(dictionary.contains_key("class"));
+    REQUIRE_FALSE(dictionary.contains_key("while"));
+}
+
+TEST_CASE( "StringTokenTypeDictionary, uses the token type from the source for redefined keywords" )
+{
+    MutableStringTokenTypeDictionary source;
+    add_reserved_keywords(source);
+    source.add("while", TokenType::RESERVED_WORD);
+
+    StringTokenTypeDictionary dictionary(source);
+
+    REQUIRE(dictionary.get("while") == TokenType::RESERVED_WORD);
+}
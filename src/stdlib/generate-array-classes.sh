@@ -48,6 +48,10 @@ namespace perlang
         // instead.
         void set(size_t index, ${_cpp_type} value);
 
+        // The length of the array.
+        [[nodiscard]]
+        size_t length() const;
+
         [[nodiscard]]
         bool contains(${_cpp_type} value) const;
 
@@ -126,6 +130,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t ${_class_name}::length() const
+    {
+        return length_;
+    }
+
     bool ${_class_name}::contains(${_cpp_type} value) const
     {
         if (this == nullptr) {
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+
+#
+# Rationale: The Unicode simple case mappings used by perlang::Char and perlang::String are stored in precomputed
+# tables, so that case conversion is independent of the C library and the current locale. This script generates the
+# tables from the Unicode Character Database bundled with Python, and writes them to src/internal/case_mapping_tables.h.
+#
+# Python only exposes the full case mappings (which may map one character to several), so the few characters whose
+# simple mapping differs from the full one are fixed up manually below, based on SpecialCasing.txt.
+#
+
+import os
+import sys
+import unicodedata
+
+PAGE_SIZE = 256
+
+# Characters whose full mapping is more than one character long, but which still have a simple mapping.
+SIMPLE_UPPER_EXCEPTIONS = {
+    **{c: c + 8 for base in (0x1F80, 0x1F90, 0x1FA0) for c in range(base, base + 8)},
+    0x1FB3: 0x1FBC,
+    0x1FC3: 0x1FCC,
+    0x1FF3: 0x1FFC,
+}
+
+SIMPLE_LOWER_EXCEPTIONS = {
+    0x0130: 0x0069,
+}
+
+
+def simple_mapping(code_point, full_mapping, exceptions):
+    if code_point in exceptions:
+        return exceptions[code_point]
+
+    # Surrogates cannot be represented as Python strings in a meaningful way, and have no case anyway.
+    if 0xD800 <= code_point <= 0xDFFF:
+        return code_point
+
+    mapped = full_mapping(chr(code_point))
+    return ord(mapped) if len(mapped) == 1 else code_point
+
+
+def bmp_tables(name, full_mapping, exceptions):
+    pages = []
+    blocks = []
+
+    for page in range(0x10000 // PAGE_SIZE):
+        block = []
+
+        for code_point in range(page * PAGE_SIZE, (page + 1) * PAGE_SIZE):
+            mapped = simple_mapping(code_point, full_mapping, exceptions)
+
+            if mapped > 0xFFFF:
+                sys.exit(f'U+{code_point:04X} maps to U+{mapped:04X}, outside of the BMP')
+
+            block.append((mapped - code_point) & 0xFFFF)
+
+        if block not in blocks:
+            blocks.append(block)
+
+        pages.append(blocks.index(block))
+
+    lines = [
+        f'    // The index in {name}_blocks of the block of deltas for each {PAGE_SIZE}-character page of the BMP.',
+        f'    inline constexpr uint8_t {name}_pages[{len(pages)}] = {{',
+    ]
+
+    for i in range(0, len(pages), 16):
+        lines.append('        ' + ', '.join(str(p) for p in pages[i:i + 16]) + ',')
+
+    lines += [
+        '    };',
+        '',
+        '    // The difference between the mapped character and the character itself (modulo 65536), for each character in',
+        '    // each distinct page.',
+        f'    inline constexpr uint16_t {name}_blocks[{len(blocks)}][{PAGE_SIZE}] = {{',
+    ]
+
+    for block in blocks:
+        lines.append('        {')
+
+        for i in range(0, PAGE_SIZE, 16):
+            lines.append('            ' + ', '.join(f'0x{d:04X}' for d in block[i:i + 16]) + ',')
+
+        lines.append('        },')
+
+    lines.append('    };')
+    return lines
+
+
+def supplementary_ranges(name, full_mapping):
+    ranges = []
+
+    for code_point in range(0x10000, 0x110000):
+        mapped = simple_mapping(code_point, full_mapping, {})
+
+        if mapped == code_point:
+            continue
+
+        delta = mapped - code_point
+
+        if ranges and ranges[-1][1] == code_point - 1 and ranges[-1][2] == delta:
+            ranges[-1][1] = code_point
+        else:
+            ranges.append([code_point, code_point, delta])
+
+    lines = [
+        '    // Ranges of characters outside of the BMP which have a mapping, and the difference between the mapped',
+        '    // characters and the characters themselves. Sorted by code point.',
+        f'    inline constexpr CaseMappingRange {name}_supplementary_ranges[{len(ranges)}] = {{',
+    ]
+
+    for first, last, delta in ranges:
+        lines.append(f'        {{ 0x{first:05X}, 0x{last:05X}, {delta} }},')
+
+    lines.append('    };')
+    return lines
+
+
+def main():
+    output_file = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'src', 'internal', 'case_mapping_tables.h')
+
+    lines = [
+        '// case_mapping_tables.h - Unicode simple case mappings',
+        '//',
+        f'// Generated by generate-case-mapping-tables.py from version {unicodedata.unidata_version} of the Unicode Character',
+        '// Database. Do not edit this file manually.',
+        '',
+        '#pragma once',
+        '',
+        '#include <cstdint>',
+        '',
+        'namespace perlang::internal::case_mapping_tables',
+        '{',
+        '    struct CaseMappingRange',
+        '    {',
+        '        uint32_t first;',
+        '        uint32_t last;',
+        '        int32_t delta;',
+        '    };',
+        '',
+    ]
+
+    lines += bmp_tables('upper', str.upper, SIMPLE_UPPER_EXCEPTIONS)
+    lines.append('')
+    lines += bmp_tables('lower', str.lower, SIMPLE_LOWER_EXCEPTIONS)
+    lines.append('')
+    lines += supplementary_ranges('upper', str.upper)
+    lines.append('')
+    lines += supplementary_ranges('lower', str.lower)
+    lines.append('}')
+
+    with open(output_file, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    main()
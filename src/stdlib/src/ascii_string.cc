@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 #include <string> // needed for std::to_string() on macOS
@@ -6,31 +7,90 @@
 
 #include "ascii_string.h"
 #include "bigint.h"
+#include "rope_string.h"
+#include "string_slice.h"
+#include "utf8_string.h"
+#include "utf16_string.h"
+#include "internal/ascii.h"
 #include "internal/string_utils.h"
+#include "internal/trailing_allocator.h"
 
 namespace perlang
 {
+    namespace
+    {
+        void ensure_ascii(const char* string, size_t length)
+        {
+            size_t non_ascii_index = internal::find_non_ascii(string, length);
+
+            if (non_ascii_index != length) {
+                // TODO: Try to include some content from the string in the exception here. It feels non-trivial since a
+                // TODO: single 'char' is not a full UTF-8 character.
+                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(non_ascii_index) + ". ASCIIStrings can only contain ASCII characters.");
+            }
+        }
+
+        // Concatenates two buffers with content already known to be ASCII-only, like formatted numbers.
+        std::unique_ptr<ASCIIString> concat_unchecked(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length)
+        {
+            char* bytes;
+            auto result = ASCIIString::allocate(lhs_length + rhs_length, bytes);
+
+            memcpy(bytes, lhs, lhs_length);
+            memcpy(bytes + lhs_length, rhs, rhs_length);
+
+            return result;
+        }
+
+        // Like concat_unchecked(), but returns a string owned by a `std::shared_ptr`; see allocate_shared().
+        std::shared_ptr<ASCIIString> concat_shared_unchecked(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length)
+        {
+            char* bytes;
+            auto result = ASCIIString::allocate_shared(lhs_length + rhs_length, bytes);
+
+            memcpy(bytes, lhs, lhs_length);
+            memcpy(bytes + lhs_length, rhs, rhs_length);
+
+            return result;
+        }
+    }
+
     std::unique_ptr<ASCIIString> ASCIIString::from_static_string(const char* str)
     {
         if (str == nullptr) {
             throw std::invalid_argument("string argument cannot be null");
         }
 
+        size_t length = strlen(str);
+        ensure_ascii(str, length);
+
         // Cannot use std::make_unique() since it forces the ASCIIString constructor to be made public.
-        auto result = new ASCIIString(str, strlen(str), false);
+        auto result = new ASCIIString(str, length, false);
 
         return std::unique_ptr<ASCIIString>(result);
     }
 
-    // TODO: Add a boolean is_checked flag here, since some input will already be checked to be ASCII-only. In its
-    // current form, the ASCIIString constructor will perform a possibly redundant check unconditionally, which is
-    // wasteful, particularly on larger strings.
     std::unique_ptr<ASCIIString> ASCIIString::from_owned_string(const char* str, size_t length)
     {
         if (str == nullptr) {
             throw std::invalid_argument("str argument cannot be null");
         }
 
+        // Validate the string before taking ownership of it, since the caller is still responsible for deallocating it
+        // if an exception is thrown.
+        ensure_ascii(str, length);
+
+        auto result = new ASCIIString(str, length, true);
+
+        return std::unique_ptr<ASCIIString>(result);
+    }
+
+    std::unique_ptr<ASCIIString> ASCIIString::from_owned_ascii_content(const char* str, size_t length)
+    {
+        if (str == nullptr) {
+            throw std::invalid_argument("str argument cannot be null");
+        }
+
         auto result = new ASCIIString(str, length, true);
 
         return std::unique_ptr<ASCIIString>(result);
@@ -42,33 +102,123 @@ namespace perlang
             throw std::invalid_argument("str argument cannot be null");
         }
 
-        // Create a new buffer and copy the string into it. Since we need to know the length anyway, we can use
-        // memcpy() instead of strcpy() to avoid an extra iteration over the string.
+        // Validate the source before copying it, so that the copy itself can use the non-validating allocate(). Since
+        // we need to know the length anyway, we can use memcpy() instead of strcpy() to avoid an extra iteration over
+        // the string.
         size_t length = strlen(str);
-        char* new_str = new char[length + 1];
-        memcpy(new_str, str, length);
-        new_str[length] = '\0';
+        ensure_ascii(str, length);
 
-        auto result = new ASCIIString(new_str, length, true);
+        char* buffer;
+        auto result = allocate(length, buffer);
+        memcpy(buffer, str, length);
 
-        return std::unique_ptr<ASCIIString>(result);
+        return result;
     }
 
-    ASCIIString::ASCIIString(const char* string, size_t length, bool owned)
+    std::unique_ptr<ASCIIString> ASCIIString::allocate(size_t length, char*& buffer)
     {
-        for (size_t i = 0; i < length; i++) {
-            // The uint8_t cast here is not pretty, but doing the "right" thing and accepting a const uint8_t* parameter
-            // instead makes things more awkward (since C string literals are const char* by definition).
-            if ((uint8_t)string[i] > 127) {
-                // TODO: Try to include some content from the string in the exception here. It feels non-trivial since a
-                // TODO: single 'char' is not a full UTF-8 character.
-                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(i) + ". ASCIIStrings can only contain ASCII characters.");
-            }
+        // Longer strings have their content stored directly after the object, so that the string can be created with
+        // a single heap allocation. The constructor doesn't throw when given trailing storage, so there is no need to
+        // guard against leaking the memory here.
+        size_t trailing_bytes = length <= INLINE_CAPACITY ? 0 : length + 1;
+        void* memory = ::operator new(sizeof(ASCIIString) + trailing_bytes);
+
+        auto result = std::unique_ptr<ASCIIString>(::new (memory) ASCIIString(length, trailing_bytes > 0));
+        buffer = const_cast<char*>(result->bytes_.get());
+
+        return result;
+    }
+
+    std::unique_ptr<ASCIIString> ASCIIString::from_shared_content(std::shared_ptr<const String> owner, const char* data, size_t length)
+    {
+        auto result = std::unique_ptr<ASCIIString>(new ASCIIString(data, length, false));
+        result->static_content_ = owner == nullptr;
+        result->owner_ = std::move(owner);
+
+        return result;
+    }
+
+    std::shared_ptr<ASCIIString> ASCIIString::make_shared_copy(const char* str, size_t length)
+    {
+        if (str == nullptr) {
+            throw std::invalid_argument("str argument cannot be null");
         }
 
+        ensure_ascii(str, length);
+
+        char* buffer;
+        auto result = allocate_shared(length, buffer);
+        memcpy(buffer, str, length);
+
+        return result;
+    }
+
+    std::shared_ptr<ASCIIString> ASCIIString::allocate_shared(size_t length, char*& buffer)
+    {
+        // Short strings are stored inline, so they don't need any extra storage.
+        size_t trailing_bytes = length <= INLINE_CAPACITY ? 0 : length + 1;
+        internal::TrailingAllocator<ASCIIString> allocator(trailing_bytes, buffer);
+
+        // Note that `buffer` is passed by reference, since the allocator only sets it once the memory is allocated.
+        return std::allocate_shared<ASCIIString>(allocator, shared_key(), length, buffer);
+    }
+
+    ASCIIString::ASCIIString(const char* string, size_t length, bool owned)
+        : String(StringEncoding::ascii)
+    {
         bytes_ = std::unique_ptr<const char[]>((const char*)string);
+        data_ = string;
         length_ = length;
         owned_ = owned;
+
+        // Borrowed content is always static content (like a string literal), except for the strings created by
+        // from_shared_content() which override this.
+        static_content_ = !owned;
+    }
+
+    ASCIIString::ASCIIString(size_t length, bool trailing_storage)
+        : String(StringEncoding::ascii)
+    {
+        initialize_buffer(length, trailing_storage ? reinterpret_cast<char*>(this + 1) : nullptr);
+    }
+
+    ASCIIString::ASCIIString(shared_key, const char* string, size_t length)
+        : ASCIIString(string, length, false)
+    {
+    }
+
+    ASCIIString::ASCIIString(shared_key, size_t length, char*& buffer)
+        : String(StringEncoding::ascii)
+    {
+        buffer = initialize_buffer(length, buffer);
+    }
+
+    char* ASCIIString::initialize_buffer(size_t length, char* storage)
+    {
+        char* buffer;
+
+        if (length <= INLINE_CAPACITY) {
+            // The inline buffer is part of this object, so it must never be deallocated by the unique_ptr.
+            buffer = inline_bytes_;
+            owned_ = false;
+        }
+        else if (storage != nullptr) {
+            // Likewise for storage placed in the same allocation as this object by allocate() or allocate_shared().
+            buffer = storage;
+            owned_ = false;
+        }
+        else {
+            buffer = new char[length + 1];
+            owned_ = true;
+        }
+
+        buffer[length] = '\0';
+
+        bytes_ = std::unique_ptr<const char[]>(buffer);
+        data_ = buffer;
+        length_ = length;
+
+        return buffer;
     }
 
     ASCIIString::~ASCIIString()
@@ -80,42 +230,81 @@ namespace perlang
         }
     }
 
-    const char* ASCIIString::bytes() const
-    {
-        return bytes_.get();
-    }
-
     std::unique_ptr<const char[]> ASCIIString::release_bytes()
     {
+        if (!owned_ && bytes_ != nullptr) {
+            // Memory we don't own cannot be handed over to the caller. This includes the inline buffer and the storage
+            // allocated by allocate() and allocate_shared(), since they are part of the same allocation as this object.
+            char* result = new char[length_ + 1];
+            memcpy(result, bytes_.get(), length_ + 1);
+
+            return std::unique_ptr<const char[]>(result);
+        }
+
+        // The string no longer has any content after this.
+        data_ = nullptr;
+
         return std::move(bytes_);
     }
 
-    size_t ASCIIString::length() const
+    bool ASCIIString::can_share_content(std::shared_ptr<const String>& owner) const
     {
-        return length_;
+        if (static_content_) {
+            owner = nullptr;
+            return true;
+        }
+
+        if (owner_ != nullptr) {
+            owner = owner_;
+            return true;
+        }
+
+        // Strings are immutable, so the content of a string owned by a shared_ptr can be shared for as long as we hold
+        // a reference to it.
+        if (length_ > INLINE_CAPACITY) {
+            owner = weak_from_this().lock();
+            return owner != nullptr;
+        }
+
+        return false;
     }
 
     std::unique_ptr<ASCIIString> ASCIIString::as_ascii() const
     {
-        // Making a copy here is incredibly inefficient, but there's really no way to return a _unique_ pointer here
-        // without making a new copy. Future improvements in this area could be to elaborate on if std::shared_ptr()
-        // could be an option; it might not be trivial.
-        return from_copied_string(bytes_.get());
+        std::shared_ptr<const String> owner;
+
+        if (can_share_content(owner)) {
+            return from_shared_content(std::move(owner), data_, length_);
+        }
+
+        char* buffer;
+        auto result = allocate(length_, buffer);
+        memcpy(buffer, data_, length_);
+
+        return result;
     }
 
     std::unique_ptr<UTF16String> ASCIIString::as_utf16() const
     {
-        // Widening an ASCII string to UTF16 is trivial, since we just have to loop over the data and write it to a
-        // newly allocated uint16_t array. Could probably be rewritten in asm at some point if we really want to.
-        // The +1 part is because our print() implementation expects the string to be NUL-terminated for now.
-        // We'll try to get rid of this limitation eventually.
-        auto s = std::vector<uint16_t>(length_ + 1);
+        // ASCII is a subset of Latin-1, which UTF16String stores compactly. No widening is needed.
+        return UTF16String::from_latin1_string(data_, length_);
+    }
+
+    std::unique_ptr<UTF8String> ASCIIString::as_utf8() const
+    {
+        // ASCII is a strict subset of UTF-8, so the bytes can be used as-is.
+        std::shared_ptr<const String> owner;
 
-        for (size_t i = 0; i < length_; i++) {
-            s[i] = bytes_[i];
+        if (can_share_content(owner)) {
+            return UTF8String::from_shared_content(std::move(owner), data_, length_, true);
         }
 
-        return UTF16String::from_owned_string(s);
+        return UTF8String::from_copied_string(data_, length_);
+    }
+
+    std::unique_ptr<String> ASCIIString::substring(size_t start, size_t length) const
+    {
+        return StringSlice::of(*this, start, length, true);
     }
 
     bool ASCIIString::operator==(const ASCIIString& rhs) const
@@ -151,26 +340,29 @@ namespace perlang
     std::unique_ptr<String> ASCIIString::operator+(String& rhs) const
     {
         size_t length = this->length_ + rhs.length();
-        char* bytes = new char[length + 1];
 
-        // TODO: This won't work once we bring in UTF16String into the picture.
-        memcpy(bytes, this->bytes_.get(), this->length_);
-        memcpy((bytes + this->length_), rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
+        // Long strings are concatenated lazily, to make chained concatenations run in linear time. UTF-16 content
+        // cannot be copied byte-wise, so it is left for the rope to convert.
+        if (length >= RopeString::THRESHOLD || rhs.encoding() == StringEncoding::utf16) {
+            return RopeString::concat(*this, rhs);
+        }
 
-        auto* utf8_rhs = dynamic_cast<UTF8String*>(&rhs);
+        char* bytes;
+        std::unique_ptr<String> result;
 
         // Depending on whether the right-hand string is ASCII-only or not, we need to construct different target types
-        // here.
+        // here. Apart from UTF16String (handled above), all string types have UTF-8 content.
         if (rhs.is_ascii()) {
-            return from_owned_string(bytes, length);
-        }
-        else if (utf8_rhs != nullptr) {
-            return UTF8String::from_owned_string(bytes, length);
+            result = allocate(length, bytes);
         }
         else {
-            throw std::runtime_error("Unsupported string type encountered");
+            result = UTF8String::allocate(length, bytes);
         }
+
+        memcpy(bytes, this->bytes_.get(), this->length_);
+        memcpy((bytes + this->length_), rhs.bytes(), rhs.length());
+
+        return result;
     }
 
     std::unique_ptr<ASCIIString> ASCIIString::operator+(const ASCIIString& rhs) const
@@ -179,37 +371,37 @@ namespace perlang
         // and doing some semi-ugly casting of the result.
 
         size_t length = this->length_ + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = allocate(length, bytes);
 
         memcpy(bytes, this->bytes_.get(), this->length_);
         memcpy(bytes + this->length_, rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
 
-        return from_owned_string(bytes, length);
+        return result;
     }
 
     std::unique_ptr<String> ASCIIString::operator+(int64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_unchecked(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> ASCIIString::operator+(uint64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_unchecked(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> ASCIIString::operator+(float rhs) const
     {
-        std::string str = internal::float_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_unchecked(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> ASCIIString::operator+(double rhs) const
     {
-        std::string str = internal::double_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_unchecked(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> ASCIIString::operator+(const BigInt& rhs) const
@@ -220,49 +412,89 @@ namespace perlang
 
     std::unique_ptr<String> ASCIIString::operator+(const std::string& rhs) const
     {
+        // The std::string can contain arbitrary data, so it must be validated before it's copied to the new string.
+        ensure_ascii(rhs.c_str(), rhs.length());
+
         size_t length = this->length_ + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = allocate(length, bytes);
 
         memcpy(bytes, this->bytes_.get(), this->length_);
         memcpy((bytes + this->length_), rhs.c_str(), rhs.length());
-        bytes[length] = '\0';
 
-        return from_owned_string(bytes, length);
+        return result;
     }
 
     std::unique_ptr<const ASCIIString> operator+(const int64_t lhs, const ASCIIString& rhs)
     {
-        std::string str = std::to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<const ASCIIString> operator+(const uint64_t lhs, const ASCIIString& rhs)
     {
-        std::string str = std::to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<const ASCIIString> operator+(const float lhs, const ASCIIString& rhs)
     {
-        std::string str = internal::float_to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<const ASCIIString> operator+(const double lhs, const ASCIIString& rhs)
     {
-        std::string str = internal::double_to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<const ASCIIString> operator+(const std::string& lhs, const ASCIIString& rhs)
     {
+        ensure_ascii(lhs.c_str(), lhs.length());
+
         size_t length = lhs.length() + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = ASCIIString::allocate(length, bytes);
 
         memcpy(bytes, lhs.c_str(), lhs.length());
         memcpy((bytes + lhs.length()), rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
 
-        return ASCIIString::from_owned_string(bytes, length);
+        return result;
+    }
+
+    std::shared_ptr<ASCIIString> concat_shared(const ASCIIString& lhs, const ASCIIString& rhs)
+    {
+        return concat_shared_unchecked(lhs.bytes(), lhs.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const ASCIIString> concat_shared(const int64_t lhs, const ASCIIString& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const ASCIIString> concat_shared(const uint64_t lhs, const ASCIIString& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const ASCIIString> concat_shared(const float lhs, const ASCIIString& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const ASCIIString> concat_shared(const double lhs, const ASCIIString& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared_unchecked(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const String> concat_shared(const BigInt& lhs, const ASCIIString& rhs)
+    {
+        std::string str = lhs.to_string();
+        return concat_shared_unchecked(str.c_str(), str.length(), rhs.bytes(), rhs.length());
     }
 }
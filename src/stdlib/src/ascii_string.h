@@ -12,6 +12,15 @@ namespace perlang
     // A class for representing immutable ASCII strings.
     class ASCIIString : public String
     {
+     private:
+        // A "pass key" for the constructors used by the make_shared_*() and allocate_shared() methods. These
+        // constructors must be public for std::make_shared() and std::allocate_shared() to be able to call them, but
+        // since only ASCIIString itself can create a shared_key, they cannot be called from other code.
+        struct shared_key
+        {
+            explicit shared_key() = default;
+        };
+
      public:
         // Creates a new ASCIIString from a "static string", like a string constant. The static string is guaranteed to
         // have "static lifetime" (in Rust terms); in other words, that it exists during the remaining lifetime of the
@@ -24,43 +33,136 @@ namespace perlang
         [[nodiscard]]
         static std::unique_ptr<ASCIIString> from_static_string(const char* str);
 
+        // Creates a new ASCIIString from a string literal. Like from_static_string(), the string "borrows" the literal
+        // instead of copying it. Unlike it, the length is determined at compile time and the content is *not*
+        // validated, which makes this the cheapest way to create an ASCIIString.
+        //
+        // This is used by the code generated by the Perlang compiler, which only uses it for literals it has already
+        // determined to be ASCII-only. Passing non-ASCII content to this method leads to undefined behavior.
+        template <size_t N>
+        [[nodiscard]]
+        static std::unique_ptr<ASCIIString> from_literal(const char (&str)[N])
+        {
+            // Cannot use std::make_unique() since it forces the ASCIIString constructor to be made public.
+            return std::unique_ptr<ASCIIString>(new ASCIIString(str, N - 1, false));
+        }
+
         // Creates a new ASCIIString from an "owned string", which is presumed to have been allocated on the heap using
         // the C++ "new" operator. The ownership of the memory is transferred to the ASCIIString, which is then
         // responsible for deallocating the memory when it is no longer needed (i.e. when no references to it remains).
         [[nodiscard]]
         static std::unique_ptr<ASCIIString> from_owned_string(const char* str, size_t length);
 
+        // Like from_owned_string(), but without validating the content. The buffer must be NUL-terminated.
+        //
+        // This is meant to be used by the standard library itself, for content which is already known to be ASCII-only
+        // (like the content of a StringBuilder, which keeps track of it while appending). Passing non-ASCII content to
+        // this method leads to undefined behavior.
+        [[nodiscard]]
+        static std::unique_ptr<ASCIIString> from_owned_ascii_content(const char* str, size_t length);
+
         // Creates a new ASCIIString from an existing string, by copying its content to a new buffer allocated on the
         // heap. The ASCIIString class takes ownership of the newly allocated buffer, which will be deallocated when the
         // ASCIIString runs out of scope.
         [[nodiscard]]
         static std::unique_ptr<ASCIIString> from_copied_string(const char* str);
 
+        // Creates a new ASCIIString with room for `length` bytes of content, returning a pointer to the (uninitialized)
+        // content in `buffer`. The content is stored inline in the ASCIIString object itself (for short strings) or
+        // directly after it, which means that strings of any length are created using a single heap allocation. The
+        // terminating `NUL` character is written by this method.
+        //
+        // This is meant to be used by the standard library itself when it constructs new strings (concatenation etc).
+        // The caller **MUST** only write ASCII content to the buffer, since it will not be validated, and **MUST NOT**
+        // modify the buffer after the string has been handed out to other code.
+        [[nodiscard]]
+        static std::unique_ptr<ASCIIString> allocate(size_t length, char*& buffer);
+
+        // Creates a new ASCIIString which shares `length` bytes of content at `data` with `owner`, instead of copying
+        // it. The content is kept alive by holding a reference to `owner`; a null `owner` means that the content has
+        // static lifetime. The content must be NUL-terminated and only contain ASCII characters. This is not
+        // validated, since this is meant for conversions between string types where it is already known.
+        [[nodiscard]]
+        static std::unique_ptr<ASCIIString> from_shared_content(std::shared_ptr<const String> owner, const char* data, size_t length);
+
+        // Creates a new ASCIIString owned by a `std::shared_ptr`, by copying `length` bytes from `str`. The control block,
+        // the ASCIIString object and its content are placed in a single heap allocation, which makes this the
+        // preferred way to create strings that will be stored in a `std::shared_ptr` anyway (like all strings in the
+        // code generated by the Perlang compiler). An exception is thrown if the content is not ASCII-only.
+        [[nodiscard]]
+        static std::shared_ptr<ASCIIString> make_shared_copy(const char* str, size_t length);
+
+        // Like from_literal(), but returns a string owned by a `std::shared_ptr`. The control block and the
+        // ASCIIString object are placed in a single heap allocation, while the literal itself is borrowed.
+        template <size_t N>
+        [[nodiscard]]
+        static std::shared_ptr<ASCIIString> make_shared_literal(const char (&str)[N])
+        {
+            return std::make_shared<ASCIIString>(shared_key(), str, N - 1);
+        }
+
+        // Like allocate(), but returns a string owned by a `std::shared_ptr`. The content is placed in the same heap
+        // allocation as the control block and the ASCIIString object; see make_shared_copy().
+        [[nodiscard]]
+        static std::shared_ptr<ASCIIString> allocate_shared(size_t length, char*& buffer);
+
         // An empty ASCIIString
         inline static const std::unique_ptr<ASCIIString> empty = ASCIIString::from_copied_string("");
 
      private:
         // Private constructor for creating a new ASCIIString from a C-style (NUL-terminated) string. The `owned`
         // parameter indicates whether the ASCIIString should take ownership of the memory it points to, and thus be
-        // responsible for deallocating it when it is no longer needed.
+        // responsible for deallocating it when it is no longer needed. The content is presumed to have been validated
+        // by the caller.
         ASCIIString(const char* string, size_t length, bool owned);
 
+        // Private constructor for creating a new, uninitialized ASCIIString with room for `length` bytes of content. If
+        // `trailing_storage` is true, the content is stored directly after the object itself, in the same allocation.
+        // See allocate() for more details.
+        ASCIIString(size_t length, bool trailing_storage);
+
+        // Sets up the content buffer for a string with room for `length` bytes of content, and returns a pointer to it.
+        // Short strings use the inline buffer; longer ones use `storage` if it is non-null, or a new heap allocation
+        // otherwise.
+        char* initialize_buffer(size_t length, char* storage);
+
+        // Determines whether the content of this string can be shared with another string instead of being copied. If
+        // so, `owner` is set to the object keeping the content alive (or null, for static content). Short strings are
+        // never shared, since copying them into the inline buffer of the new string is cheaper.
+        bool can_share_content(std::shared_ptr<const String>& owner) const;
+
      public:
+        // Constructor used by make_shared_literal(). See `shared_key` for why this is public.
+        ASCIIString(shared_key, const char* string, size_t length);
+
+        // Constructor used by allocate_shared(). On entry, `buffer` points to the storage allocated for the content
+        // (or is null for short strings); on return, it points to the buffer the caller should write the content to.
+        ASCIIString(shared_key, size_t length, char*& buffer);
+
+        // The maximum length of strings which are stored inline in the ASCIIString object, without a separate heap
+        // allocation for the content. The size is chosen so that most identifiers, dictionary keys and short messages
+        // fit in it.
+        static constexpr size_t INLINE_CAPACITY = 23;
+
         ~ASCIIString() override;
 
-        // Returns the backing byte array for this ASCIIString. This method is generally to be avoided; it is safer to
-        // use the ASCIIString throughout the code and only call this when you really must.
-        [[nodiscard]]
-        const char* bytes() const override;
+        // Objects created by allocate() may have their content stored after the object, in the same allocation. The
+        // memory must therefore be freed without passing the size of the object to the global operator delete, which
+        // in turn means that the matching operator new must be defined as well.
+        static void* operator new(size_t size)
+        {
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* p)
+        {
+            ::operator delete(p);
+        }
 
         // Returns the backing byte array, and releases ownership of it. The caller is now responsible for freeing the
-        // memory.
+        // memory. For strings stored inline, a heap-allocated copy of the content is returned.
         std::unique_ptr<const char[]> release_bytes() override;
 
-        // The length of the string in bytes, excluding the terminating `NUL` character.
-        [[nodiscard]]
-        size_t length() const override;
-
         // Determines if the string is ASCII-safe or not. Multiple subsequent calls to this method may return a cached
         // result from a previous run. The first call may use a pre-calculated value, but this is not guaranteed by
         // this method.
@@ -82,6 +184,12 @@ namespace perlang
         [[nodiscard]]
         std::unique_ptr<UTF16String> as_utf16() const override;
 
+        [[nodiscard]]
+        std::unique_ptr<UTF8String> as_utf8() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<String> substring(size_t start, size_t length) const override;
+
         // Compares the equality of two `ASCIIString`s, returning `true` if they point to the same backing byte array
         // and have the same length. Note that this method does *not* compare referential equality; two different
         // `ASCIIString` instances pointing at the same backing byte array are considered equal in Perlang. For all
@@ -149,13 +257,22 @@ namespace perlang
         // would unintentionally spread the modifications to these other objects too.
         std::unique_ptr<const char[]> bytes_;
 
-        // The length of the string in bytes, excluding the terminating `NUL` character.
-        size_t length_;
-
         // A flag indicating whether this string owns the memory it points to. If this is true, the string is
         // responsible for deallocating the memory when it is no longer needed. If false, the string is borrowing the
         // memory from somewhere else, and should not deallocate it.
         bool owned_;
+
+        // True if the content has static lifetime (like a string literal), meaning that it can be borrowed by other
+        // strings without any further bookkeeping.
+        bool static_content_ = false;
+
+        // The string whose content this string shares, for strings created by from_shared_content(). Keeps the content
+        // alive for as long as this string exists.
+        std::shared_ptr<const String> owner_;
+
+        // Inline storage for short strings (including the terminating `NUL` character). When used, `bytes_` points to
+        // this buffer and `owned_` is false.
+        char inline_bytes_[INLINE_CAPACITY + 1];
     };
 
     // Concatenate an int64+ASCIIString. The memory for the new string is allocated from the heap. This is a free
@@ -201,4 +318,45 @@ namespace perlang
     {
         return static_cast<uint64_t>(lhs) + rhs;
     }
+
+    // The following concat_shared() overloads return the same string types as the corresponding operator+
+    // overloads. See the concat_shared() overloads in perlang_string.h for details.
+
+    // Concatenates two ASCIIStrings, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<ASCIIString> concat_shared(const ASCIIString& lhs, const ASCIIString& rhs);
+
+    // Concatenates an int64+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const ASCIIString> concat_shared(int64_t lhs, const ASCIIString& rhs);
+
+    // Concatenates a uint64+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const ASCIIString> concat_shared(uint64_t lhs, const ASCIIString& rhs);
+
+    // Concatenates a float+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const ASCIIString> concat_shared(float lhs, const ASCIIString& rhs);
+
+    // Concatenates a double+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const ASCIIString> concat_shared(double lhs, const ASCIIString& rhs);
+
+    // Concatenates a BigInt+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const String> concat_shared(const BigInt& lhs, const ASCIIString& rhs);
+
+    // Concatenates an int32+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    inline std::shared_ptr<const ASCIIString> concat_shared(int32_t lhs, const ASCIIString& rhs)
+    {
+        return concat_shared(static_cast<int64_t>(lhs), rhs);
+    }
+
+    // Concatenates a uint32+ASCIIString, using a single heap allocation.
+    [[nodiscard]]
+    inline std::shared_ptr<const ASCIIString> concat_shared(uint32_t lhs, const ASCIIString& rhs)
+    {
+        return concat_shared(static_cast<uint64_t>(lhs), rhs);
+    }
 }
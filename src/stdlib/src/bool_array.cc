@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t BoolArray::length() const
+    {
+        return length_;
+    }
+
     bool BoolArray::contains(bool value) const
     {
         if (this == nullptr) {
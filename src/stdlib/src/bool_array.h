@@ -28,6 +28,10 @@ namespace perlang
         // instead.
         void set(size_t index, bool value);
 
+        // The length of the array.
+        [[nodiscard]]
+        size_t length() const;
+
         [[nodiscard]]
         bool contains(bool value) const;
 
@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t CharArray::length() const
+    {
+        return length_;
+    }
+
     bool CharArray::contains(char16_t value) const
     {
         if (this == nullptr) {
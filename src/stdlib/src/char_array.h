@@ -28,6 +28,10 @@ namespace perlang
         // instead.
         void set(size_t index, char16_t value);
 
+        // The length of the array.
+        [[nodiscard]]
+        size_t length() const;
+
         [[nodiscard]]
         bool contains(char16_t value) const;
 
@@ -20,6 +20,7 @@ namespace perlang::collections
         void add(const char*);
         void add(const std::shared_ptr<perlang::String>&);
         bool contains(const char*);
+        bool contains(const std::shared_ptr<perlang::String>&);
         std::vector<std::shared_ptr<perlang::String>> values();
     };
 }
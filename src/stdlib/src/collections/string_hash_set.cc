@@ -16,7 +16,13 @@ namespace perlang::collections
     bool StringHashSet::contains(const char* value)
     {
         // TODO: Replace with contains() once we are on C++20
-        return data_.count(perlang::ASCIIString::from_copied_string(value)) == 1;
+        return data_.count(string_key(value)) == 1;
+    }
+
+    bool StringHashSet::contains(const std::shared_ptr<perlang::String>& value)
+    {
+        // Keys of any encoding can be looked up; e.g. a UTF16String matches an equal ASCIIString in the set.
+        return data_.count(value) == 1;
     }
 
     StringHashSet StringHashSet::concat(const StringHashSet& other)
@@ -24,6 +24,7 @@ namespace perlang::collections
 
         explicit StringHashSet(MutableStringHashSet&);
         bool contains(const char*);
+        bool contains(const std::shared_ptr<perlang::String>&);
         StringHashSet concat(const StringHashSet&);
         std::vector<std::shared_ptr<perlang::String>> values();
 
@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t DoubleArray::length() const
+    {
+        return length_;
+    }
+
     bool DoubleArray::contains(double value) const
     {
         if (this == nullptr) {
@@ -11,7 +11,7 @@ namespace perlang
     {
      public:
         IllegalStateException(std::shared_ptr<String> message) :
-            std::runtime_error(std::string(message.get()->bytes()))
+            std::runtime_error(std::string(message->bytes(), message->length()))
         {
         }
     };
@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t FloatArray::length() const
+    {
+        return length_;
+    }
+
     bool FloatArray::contains(float value) const
     {
         if (this == nullptr) {
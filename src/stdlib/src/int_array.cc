@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t IntArray::length() const
+    {
+        return length_;
+    }
+
     bool IntArray::contains(int32_t value) const
     {
         if (this == nullptr) {
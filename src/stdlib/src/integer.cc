@@ -10,5 +10,7 @@ perlang::Integer::Integer(const int value)
 
 std::shared_ptr<const perlang::String> perlang::Integer::to_string() const
 {
-    return ASCIIString::from_copied_string(std::to_string(value_).c_str());
+    std::string result = std::to_string(value_);
+
+    return ASCIIString::make_shared_copy(result.c_str(), result.length());
 }
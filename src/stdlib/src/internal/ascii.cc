@@ -0,0 +1,297 @@
+#include <cstring>
+
+#include "internal/ascii.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        using find_non_ascii_bytes_fn = size_t (*)(const char*, size_t);
+        using find_non_ascii_utf16_fn = size_t (*)(const uint16_t*, size_t);
+
+        // Portable fallback, processing 8 bytes at a time using plain 64-bit integer operations ("SIMD within a
+        // register"). Once a word containing a non-ASCII byte has been found, we fall back to checking byte by byte
+        // to locate it; this avoids having to care about the endianness of the platform.
+        size_t find_non_ascii_bytes_scalar(const char* data, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 8 <= length; i += 8) {
+                uint64_t word;
+                memcpy(&word, data + i, sizeof(word));
+
+                if ((word & 0x8080808080808080ULL) != 0) {
+                    break;
+                }
+            }
+
+            for (; i < length; i++) {
+                if ((uint8_t)data[i] > 127) {
+                    return i;
+                }
+            }
+
+            return length;
+        }
+
+        size_t find_non_ascii_utf16_scalar(const uint16_t* data, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 4 <= length; i += 4) {
+                uint64_t word;
+                memcpy(&word, data + i, sizeof(word));
+
+                if ((word & 0xFF80FF80FF80FF80ULL) != 0) {
+                    break;
+                }
+            }
+
+            for (; i < length; i++) {
+                if (data[i] > 127) {
+                    return i;
+                }
+            }
+
+            return length;
+        }
+
+#ifdef PERLANG_X86_64
+        // The vectorized kernels below all follow the same pattern: an unrolled main loop which ORs a number of
+        // vectors together and only checks the combined result, followed by a loop which handles one vector at a time.
+        // The latter is also used for pinpointing the exact location of the non-ASCII character when the main loop
+        // finds one, so the main loop can be kept as tight as possible.
+
+        size_t find_non_ascii_bytes_sse2(const char* data, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 64 <= length; i += 64) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 16));
+                __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 32));
+                __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 48));
+
+                if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) {
+                    break;
+                }
+            }
+
+            for (; i + 16 <= length; i += 16) {
+                int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(data + i)));
+
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+
+            return i + find_non_ascii_bytes_scalar(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t find_non_ascii_bytes_avx2(const char* data, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 128 <= length; i += 128) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+                __m256i c = _mm256_loadu_si256((const __m256i*)(data + i + 64));
+                __m256i d = _mm256_loadu_si256((const __m256i*)(data + i + 96));
+
+                if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))) != 0) {
+                    break;
+                }
+            }
+
+            for (; i + 32 <= length; i += 32) {
+                auto mask = (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(data + i)));
+
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+
+            return i + find_non_ascii_bytes_sse2(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX512
+        size_t find_non_ascii_bytes_avx512(const char* data, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 256 <= length; i += 256) {
+                __m512i a = _mm512_loadu_si512(data + i);
+                __m512i b = _mm512_loadu_si512(data + i + 64);
+                __m512i c = _mm512_loadu_si512(data + i + 128);
+                __m512i d = _mm512_loadu_si512(data + i + 192);
+
+                if (_mm512_movepi8_mask(_mm512_or_si512(_mm512_or_si512(a, b), _mm512_or_si512(c, d))) != 0) {
+                    break;
+                }
+            }
+
+            for (; i < length; i += 64) {
+                // The tail is handled using a masked load, which never touches memory outside the buffer.
+                __mmask64 load_mask = length - i >= 64 ? ~(__mmask64)0 : ((__mmask64)1 << (length - i)) - 1;
+                uint64_t mask = _mm512_movepi8_mask(_mm512_maskz_loadu_epi8(load_mask, data + i));
+
+                if (mask != 0) {
+                    return i + __builtin_ctzll(mask);
+                }
+            }
+
+            return length;
+        }
+
+        size_t find_non_ascii_utf16_sse2(const uint16_t* data, size_t length)
+        {
+            const __m128i non_ascii_bits = _mm_set1_epi16((short)0xFF80);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+
+            for (; i + 32 <= length; i += 32) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 8));
+                __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 16));
+                __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 24));
+                __m128i combined = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), non_ascii_bits);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(combined, zero)) != 0xFFFF) {
+                    break;
+                }
+            }
+
+            for (; i + 8 <= length; i += 8) {
+                __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(data + i)), non_ascii_bits);
+                int mask = ~_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) & 0xFFFF;
+
+                if (mask != 0) {
+                    // Each code unit corresponds to two bits in the mask.
+                    return i + __builtin_ctz(mask) / 2;
+                }
+            }
+
+            return i + find_non_ascii_utf16_scalar(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t find_non_ascii_utf16_avx2(const uint16_t* data, size_t length)
+        {
+            const __m256i non_ascii_bits = _mm256_set1_epi16((short)0xFF80);
+            const __m256i zero = _mm256_setzero_si256();
+            size_t i = 0;
+
+            for (; i + 64 <= length; i += 64) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 16));
+                __m256i c = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+                __m256i d = _mm256_loadu_si256((const __m256i*)(data + i + 48));
+                __m256i combined = _mm256_and_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), non_ascii_bits);
+
+                if (!_mm256_testz_si256(combined, combined)) {
+                    break;
+                }
+            }
+
+            for (; i + 16 <= length; i += 16) {
+                __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(data + i)), non_ascii_bits);
+                auto mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, zero));
+
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask) / 2;
+                }
+            }
+
+            return i + find_non_ascii_utf16_sse2(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX512
+        size_t find_non_ascii_utf16_avx512(const uint16_t* data, size_t length)
+        {
+            const __m512i non_ascii_bits = _mm512_set1_epi16((short)0xFF80);
+            size_t i = 0;
+
+            for (; i + 128 <= length; i += 128) {
+                __m512i a = _mm512_loadu_si512(data + i);
+                __m512i b = _mm512_loadu_si512(data + i + 32);
+                __m512i c = _mm512_loadu_si512(data + i + 64);
+                __m512i d = _mm512_loadu_si512(data + i + 96);
+
+                if (_mm512_test_epi16_mask(_mm512_or_si512(_mm512_or_si512(a, b), _mm512_or_si512(c, d)), non_ascii_bits) != 0) {
+                    break;
+                }
+            }
+
+            for (; i < length; i += 32) {
+                __mmask32 load_mask = length - i >= 32 ? ~(__mmask32)0 : ((__mmask32)1 << (length - i)) - 1;
+                uint32_t mask = _mm512_test_epi16_mask(_mm512_maskz_loadu_epi16(load_mask, data + i), non_ascii_bits);
+
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+
+            return length;
+        }
+#endif // PERLANG_X86_64
+
+        find_non_ascii_bytes_fn bytes_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                    return find_non_ascii_bytes_avx512;
+                case SimdLevel::avx2:
+                    return find_non_ascii_bytes_avx2;
+                case SimdLevel::sse2:
+                    return find_non_ascii_bytes_sse2;
+#endif
+                default:
+                    return find_non_ascii_bytes_scalar;
+            }
+        }
+
+        find_non_ascii_utf16_fn utf16_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                    return find_non_ascii_utf16_avx512;
+                case SimdLevel::avx2:
+                    return find_non_ascii_utf16_avx2;
+                case SimdLevel::sse2:
+                    return find_non_ascii_utf16_sse2;
+#endif
+                default:
+                    return find_non_ascii_utf16_scalar;
+            }
+        }
+    }
+
+    size_t find_non_ascii(const char* data, size_t length)
+    {
+        static const find_non_ascii_bytes_fn kernel = bytes_kernel_for(detected_simd_level());
+        return kernel(data, length);
+    }
+
+    size_t find_non_ascii(const uint16_t* data, size_t length)
+    {
+        static const find_non_ascii_utf16_fn kernel = utf16_kernel_for(detected_simd_level());
+        return kernel(data, length);
+    }
+
+    size_t find_non_ascii(const char* data, size_t length, SimdLevel level)
+    {
+        return bytes_kernel_for(level)(data, length);
+    }
+
+    size_t find_non_ascii(const uint16_t* data, size_t length, SimdLevel level)
+    {
+        return utf16_kernel_for(level)(data, length);
+    }
+}
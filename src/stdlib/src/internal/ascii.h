@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Returns the index of the first non-ASCII byte (i.e. a byte with a value > 127) in the given buffer, or `length`
+    // if the whole buffer consists of ASCII characters. The fastest implementation supported by the CPU is selected on
+    // the first call.
+    [[nodiscard]]
+    size_t find_non_ascii(const char* data, size_t length);
+
+    // Same as above, but for UTF-16 code units. A code unit is considered non-ASCII if its value is > 127.
+    [[nodiscard]]
+    size_t find_non_ascii(const uint16_t* data, size_t length);
+
+    // Variants of the above which use the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. These are intended for tests and benchmarks. Calling them with a level which is not supported by
+    // the current CPU is undefined behavior; use detected_simd_level() to determine what is safe to use.
+    [[nodiscard]]
+    size_t find_non_ascii(const char* data, size_t length, SimdLevel level);
+
+    [[nodiscard]]
+    size_t find_non_ascii(const uint16_t* data, size_t length, SimdLevel level);
+
+    // Returns true if the given buffer consists solely of ASCII characters.
+    [[nodiscard]]
+    inline bool is_ascii(const char* data, size_t length)
+    {
+        return find_non_ascii(data, length) == length;
+    }
+
+    // Returns true if the given buffer of UTF-16 code units consists solely of ASCII characters.
+    [[nodiscard]]
+    inline bool is_ascii(const uint16_t* data, size_t length)
+    {
+        return find_non_ascii(data, length) == length;
+    }
+}
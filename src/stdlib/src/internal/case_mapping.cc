@@ -0,0 +1,100 @@
+#include "internal/case_mapping.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        // The kernels convert the letters in the range `first`..`first + 25` (i.e. 'a'..'z' or 'A'..'Z') by flipping
+        // bit 5, which is the only difference between the uppercase and lowercase ASCII letters.
+        using ascii_case_fn = void (*)(const char*, size_t, char*, char);
+
+        void ascii_case_scalar(const char* data, size_t length, char* output, char first)
+        {
+            for (size_t i = 0; i < length; i++) {
+                char c = data[i];
+                output[i] = (uint8_t)(c - first) < 26 ? (char)(c ^ 0x20) : c;
+            }
+        }
+
+#ifdef PERLANG_X86_64
+        // There are no unsigned byte comparisons in SSE2/AVX2. Adding `0x80 - first` moves the letters to the bottom
+        // of the signed range (-128..-103), where all other byte values end up above them; a single signed comparison
+        // then gives us a mask of the letters to convert.
+
+        void ascii_case_sse2(const char* data, size_t length, char* output, char first)
+        {
+            const __m128i shift = _mm_set1_epi8((char)(0x80 - first));
+            const __m128i limit = _mm_set1_epi8((char)(-128 + 26));
+            const __m128i case_bit = _mm_set1_epi8(0x20);
+            size_t i = 0;
+
+            for (; i + 16 <= length; i += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(v, shift), limit);
+                _mm_storeu_si128((__m128i*)(output + i), _mm_xor_si128(v, _mm_and_si128(letters, case_bit)));
+            }
+
+            ascii_case_scalar(data + i, length - i, output + i, first);
+        }
+
+        PERLANG_TARGET_AVX2
+        void ascii_case_avx2(const char* data, size_t length, char* output, char first)
+        {
+            const __m256i shift = _mm256_set1_epi8((char)(0x80 - first));
+            const __m256i limit = _mm256_set1_epi8((char)(-128 + 26));
+            const __m256i case_bit = _mm256_set1_epi8(0x20);
+            size_t i = 0;
+
+            for (; i + 32 <= length; i += 32) {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, shift));
+                _mm256_storeu_si256((__m256i*)(output + i), _mm256_xor_si256(v, _mm256_and_si256(letters, case_bit)));
+            }
+
+            ascii_case_sse2(data + i, length - i, output + i, first);
+        }
+#endif // PERLANG_X86_64
+
+        ascii_case_fn kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                // This is memory-bound with AVX2 already; AVX-512 would not make any measurable difference.
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return ascii_case_avx2;
+                case SimdLevel::sse2:
+                    return ascii_case_sse2;
+#endif
+                default:
+                    return ascii_case_scalar;
+            }
+        }
+    }
+
+    void ascii_to_upper(const char* data, size_t length, char* output)
+    {
+        static const ascii_case_fn kernel = kernel_for(detected_simd_level());
+        kernel(data, length, output, 'a');
+    }
+
+    void ascii_to_lower(const char* data, size_t length, char* output)
+    {
+        static const ascii_case_fn kernel = kernel_for(detected_simd_level());
+        kernel(data, length, output, 'A');
+    }
+
+    void ascii_to_upper(const char* data, size_t length, char* output, SimdLevel level)
+    {
+        kernel_for(level)(data, length, output, 'a');
+    }
+
+    void ascii_to_lower(const char* data, size_t length, char* output, SimdLevel level)
+    {
+        kernel_for(level)(data, length, output, 'A');
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/case_mapping_tables.h"
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Returns the Unicode simple uppercase mapping of the given code point, or the code point itself if it has none.
+    // "Simple" means that each character maps to exactly one character; e.g. 'ß' is left as-is rather than being
+    // converted to "SS". The mappings come from precomputed tables (see generate-case-mapping-tables.py), so they are
+    // independent of the current locale.
+    [[nodiscard]]
+    inline char32_t to_upper(char32_t code_point);
+
+    // Returns the Unicode simple lowercase mapping of the given code point, or the code point itself if it has none.
+    [[nodiscard]]
+    inline char32_t to_lower(char32_t code_point);
+
+    // Copies `length` bytes from `data` to `output`, converting ASCII lowercase letters to uppercase. All other bytes
+    // (including non-ASCII ones) are copied as-is, so this can be used for the ASCII parts of UTF-8 content as well.
+    // The fastest implementation supported by the CPU is selected on the first call.
+    void ascii_to_upper(const char* data, size_t length, char* output);
+
+    // Same as above, but converting ASCII uppercase letters to lowercase.
+    void ascii_to_lower(const char* data, size_t length, char* output);
+
+    // Variants of the above which use the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. Intended for tests and benchmarks; see find_non_ascii() for the caveats.
+    void ascii_to_upper(const char* data, size_t length, char* output, SimdLevel level);
+    void ascii_to_lower(const char* data, size_t length, char* output, SimdLevel level);
+
+    namespace detail
+    {
+        template <size_t N>
+        char32_t map_supplementary(char32_t code_point, const case_mapping_tables::CaseMappingRange (&ranges)[N])
+        {
+            for (const auto& range : ranges) {
+                if (code_point < range.first) {
+                    break;
+                }
+
+                if (code_point <= range.last) {
+                    return code_point + range.delta;
+                }
+            }
+
+            return code_point;
+        }
+    }
+
+    inline char32_t to_upper(char32_t code_point)
+    {
+        using namespace case_mapping_tables;
+
+        if (code_point < 0x80) {
+            return code_point >= 'a' && code_point <= 'z' ? code_point - 0x20 : code_point;
+        }
+
+        if (code_point <= 0xFFFF) {
+            return (char16_t)(code_point + upper_blocks[upper_pages[code_point >> 8]][code_point & 0xFF]);
+        }
+
+        return detail::map_supplementary(code_point, upper_supplementary_ranges);
+    }
+
+    inline char32_t to_lower(char32_t code_point)
+    {
+        using namespace case_mapping_tables;
+
+        if (code_point < 0x80) {
+            return code_point >= 'A' && code_point <= 'Z' ? code_point + 0x20 : code_point;
+        }
+
+        if (code_point <= 0xFFFF) {
+            return (char16_t)(code_point + lower_blocks[lower_pages[code_point >> 8]][code_point & 0xFF]);
+        }
+
+        return detail::map_supplementary(code_point, lower_supplementary_ranges);
+    }
+}
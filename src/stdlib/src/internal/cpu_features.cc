@@ -0,0 +1,66 @@
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    namespace
+    {
+        SimdLevel detect_simd_level()
+        {
+#ifdef PERLANG_X86_64
+            // This is normally called by the runtime before any constructors run, but we might be called from a static
+            // initializer so calling it explicitly is the safe choice. The check for OS support (i.e. that the kernel
+            // saves the extended register state on context switches) is handled by __builtin_cpu_supports() itself.
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+                return SimdLevel::avx512;
+            }
+
+            if (__builtin_cpu_supports("avx2")) {
+                return SimdLevel::avx2;
+            }
+
+            if (__builtin_cpu_supports("sse2")) {
+                return SimdLevel::sse2;
+            }
+#endif
+
+            return SimdLevel::scalar;
+        }
+    }
+
+    SimdLevel detected_simd_level()
+    {
+        static const SimdLevel level = detect_simd_level();
+        return level;
+    }
+
+    std::vector<SimdLevel> supported_simd_levels()
+    {
+        std::vector<SimdLevel> result;
+
+        for (auto level : { SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 }) {
+            if (level <= detected_simd_level()) {
+                result.push_back(level);
+            }
+        }
+
+        return result;
+    }
+
+    const char* simd_level_name(SimdLevel level)
+    {
+        switch (level) {
+            case SimdLevel::scalar:
+                return "scalar";
+            case SimdLevel::sse2:
+                return "SSE2";
+            case SimdLevel::avx2:
+                return "AVX2";
+            case SimdLevel::avx512:
+                return "AVX-512";
+        }
+
+        return "unknown";
+    }
+}
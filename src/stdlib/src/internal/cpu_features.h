@@ -0,0 +1,42 @@
+#pragma once
+
+// Helper macros for defining functions which use instruction set extensions beyond the baseline of the target
+// architecture. Such functions must only be called after verifying that the CPU supports them, using
+// detected_simd_level() below. SSE2 is part of the x86-64 baseline, so it needs no special treatment.
+#if defined(__x86_64__)
+#define PERLANG_X86_64 1
+#define PERLANG_TARGET_AVX2 __attribute__((target("avx2")))
+#define PERLANG_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+#include <vector>
+
+namespace perlang::internal
+{
+    // The SIMD instruction set extensions we provide specialized kernels for, in increasing order of capability. On
+    // non-x86 platforms, only the `scalar` level is used for now.
+    enum class SimdLevel
+    {
+        scalar,
+        sse2,
+        avx2,
+
+        // AVX-512 Foundation + Byte and Word instructions. The latter is needed for most of our byte-oriented kernels,
+        // so we only consider AVX-512 to be available when both are supported by the CPU.
+        avx512
+    };
+
+    // Returns the highest SIMD level supported by both the CPU and the operating system we are running on. The
+    // detection is only performed once; subsequent calls return a cached result.
+    [[nodiscard]]
+    SimdLevel detected_simd_level();
+
+    // Returns all SIMD levels supported by the CPU, from `scalar` up to detected_simd_level(). Used by tests and
+    // benchmarks to exercise every kernel which can run on the current machine.
+    [[nodiscard]]
+    std::vector<SimdLevel> supported_simd_levels();
+
+    // Returns a human-readable name of the given SIMD level, e.g. for use in benchmark output.
+    [[nodiscard]]
+    const char* simd_level_name(SimdLevel level);
+}
@@ -0,0 +1,121 @@
+#include <cstring>
+
+#include "internal/hashing.h"
+
+namespace perlang::internal
+{
+    namespace
+    {
+        constexpr uint64_t secret0 = 0x2d358dccaa6c78a5ULL;
+        constexpr uint64_t secret1 = 0x8bb84b93962eacc9ULL;
+        constexpr uint64_t secret2 = 0x4b33a62ed433d4a3ULL;
+        constexpr uint64_t secret3 = 0x4d5a2da51de1aa47ULL;
+
+        // Multiplies `a` and `b` into a 128-bit result, storing the low half in `a` and the high half in `b`.
+        inline void multiply(uint64_t& a, uint64_t& b)
+        {
+#ifdef __SIZEOF_INT128__
+            __uint128_t result = static_cast<__uint128_t>(a) * b;
+            a = static_cast<uint64_t>(result);
+            b = static_cast<uint64_t>(result >> 64);
+#else
+            uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+            uint64_t carry = t < rl;
+            uint64_t lo = t + (rm1 << 32);
+            carry += lo < t;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+        }
+
+        inline uint64_t mix(uint64_t a, uint64_t b)
+        {
+            multiply(a, b);
+            return a ^ b;
+        }
+
+        // The reads below use memcpy() since the data is not necessarily aligned. The compiler turns them into plain
+        // loads. The resulting hash codes differ between little- and big-endian platforms, which is fine since they
+        // are never persisted.
+        inline uint64_t read64(const uint8_t* p)
+        {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t read32(const uint8_t* p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        // Reads 1-3 bytes, without reading beyond the end of the buffer.
+        inline uint64_t read_small(const uint8_t* p, size_t length)
+        {
+            return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+        }
+    }
+
+    uint64_t hash_bytes(const char* data, size_t length)
+    {
+        const auto* p = reinterpret_cast<const uint8_t*>(data);
+        uint64_t seed = mix(secret0, secret1);
+        uint64_t a;
+        uint64_t b;
+
+        if (length <= 16) {
+            if (length >= 4) {
+                // Two overlapping pairs of 32-bit reads cover all bytes of strings with 4-16 bytes.
+                size_t offset = (length >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + offset);
+                b = (read32(p + length - 4) << 32) | read32(p + length - 4 - offset);
+            }
+            else if (length > 0) {
+                a = read_small(p, length);
+                b = 0;
+            }
+            else {
+                a = 0;
+                b = 0;
+            }
+        }
+        else {
+            size_t remaining = length;
+
+            if (remaining >= 48) {
+                // Three independent lanes, to make use of the instruction-level parallelism of modern CPUs.
+                uint64_t seed1 = seed;
+                uint64_t seed2 = seed;
+
+                do {
+                    seed = mix(read64(p) ^ secret1, read64(p + 8) ^ seed);
+                    seed1 = mix(read64(p + 16) ^ secret2, read64(p + 24) ^ seed1);
+                    seed2 = mix(read64(p + 32) ^ secret3, read64(p + 40) ^ seed2);
+                    p += 48;
+                    remaining -= 48;
+                } while (remaining >= 48);
+
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (remaining > 16) {
+                seed = mix(read64(p) ^ secret1, read64(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+
+            // The last 16 bytes of the buffer, possibly overlapping with the ones already processed above.
+            a = read64(p + remaining - 16);
+            b = read64(p + remaining - 8);
+        }
+
+        a ^= secret1;
+        b ^= seed;
+        multiply(a, b);
+
+        return mix(a ^ secret0 ^ length, b ^ secret1);
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace perlang::internal
+{
+    // Computes a 64-bit hash code for the given buffer. The algorithm is a variant of wyhash: 16-byte blocks are mixed
+    // using 64x64 -> 128-bit multiplications, which gives a good distribution of the output bits while being faster
+    // than vectorized hashes for the short strings typically used as hash set and dictionary keys. The result depends
+    // only on the content of the buffer, and is stable across runs (no per-process seed is used).
+    [[nodiscard]]
+    uint64_t hash_bytes(const char* data, size_t length);
+}
@@ -0,0 +1,213 @@
+#include <cstring>
+
+#include "internal/ascii.h"
+#include "internal/latin1.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        using narrow_to_latin1_fn = size_t (*)(const uint16_t*, size_t, char*);
+        using find_non_latin1_fn = size_t (*)(const uint16_t*, size_t);
+
+        size_t narrow_to_latin1_scalar(const uint16_t* data, size_t length, char* output)
+        {
+            for (size_t i = 0; i < length; i++) {
+                if (data[i] > 0xFF) {
+                    return i;
+                }
+
+                output[i] = (char)data[i];
+            }
+
+            return length;
+        }
+
+        size_t find_non_latin1_scalar(const uint16_t* data, size_t length)
+        {
+            for (size_t i = 0; i < length; i++) {
+                if (data[i] > 0xFF) {
+                    return i;
+                }
+            }
+
+            return length;
+        }
+
+#ifdef PERLANG_X86_64
+        // The vectorized kernels check a block of code units for bits 8-15 being set, and pack the whole block to
+        // bytes with unsigned saturation if they are all clear. Blocks containing a code unit outside the Latin-1 range
+        // are handled by the scalar kernel, which locates the exact position.
+
+        size_t narrow_to_latin1_sse2(const uint16_t* data, size_t length, char* output)
+        {
+            const __m128i high_bits = _mm_set1_epi16((short)0xFF00);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+
+            for (; i + 16 <= length; i += 16) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 8));
+                __m128i high = _mm_and_si128(_mm_or_si128(a, b), high_bits);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                    break;
+                }
+
+                _mm_storeu_si128((__m128i*)(output + i), _mm_packus_epi16(a, b));
+            }
+
+            return i + narrow_to_latin1_scalar(data + i, length - i, output + i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t narrow_to_latin1_avx2(const uint16_t* data, size_t length, char* output)
+        {
+            const __m256i high_bits = _mm256_set1_epi16((short)0xFF00);
+            size_t i = 0;
+
+            for (; i + 32 <= length; i += 32) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 16));
+
+                if (!_mm256_testz_si256(_mm256_or_si256(a, b), high_bits)) {
+                    break;
+                }
+
+                // packus operates on each 128-bit lane separately, so the 64-bit quarters must be reordered afterwards.
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+                _mm256_storeu_si256((__m256i*)(output + i), packed);
+            }
+
+            return i + narrow_to_latin1_sse2(data + i, length - i, output + i);
+        }
+
+        size_t find_non_latin1_sse2(const uint16_t* data, size_t length)
+        {
+            const __m128i high_bits = _mm_set1_epi16((short)0xFF00);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+
+            for (; i + 16 <= length; i += 16) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 8));
+                __m128i high = _mm_and_si128(_mm_or_si128(a, b), high_bits);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                    break;
+                }
+            }
+
+            return i + find_non_latin1_scalar(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t find_non_latin1_avx2(const uint16_t* data, size_t length)
+        {
+            const __m256i high_bits = _mm256_set1_epi16((short)0xFF00);
+            size_t i = 0;
+
+            for (; i + 32 <= length; i += 32) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 16));
+
+                if (!_mm256_testz_si256(_mm256_or_si256(a, b), high_bits)) {
+                    break;
+                }
+            }
+
+            return i + find_non_latin1_sse2(data + i, length - i);
+        }
+#endif // PERLANG_X86_64
+
+        narrow_to_latin1_fn narrow_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return narrow_to_latin1_avx2;
+                case SimdLevel::sse2:
+                    return narrow_to_latin1_sse2;
+#endif
+                default:
+                    return narrow_to_latin1_scalar;
+            }
+        }
+
+        find_non_latin1_fn find_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return find_non_latin1_avx2;
+                case SimdLevel::sse2:
+                    return find_non_latin1_sse2;
+#endif
+                default:
+                    return find_non_latin1_scalar;
+            }
+        }
+    }
+
+    size_t narrow_to_latin1(const uint16_t* data, size_t length, char* output)
+    {
+        static const narrow_to_latin1_fn kernel = narrow_kernel_for(detected_simd_level());
+        return kernel(data, length, output);
+    }
+
+    size_t narrow_to_latin1(const uint16_t* data, size_t length, char* output, SimdLevel level)
+    {
+        return narrow_kernel_for(level)(data, length, output);
+    }
+
+    size_t find_non_latin1(const uint16_t* data, size_t length)
+    {
+        static const find_non_latin1_fn kernel = find_kernel_for(detected_simd_level());
+        return kernel(data, length);
+    }
+
+    size_t find_non_latin1(const uint16_t* data, size_t length, SimdLevel level)
+    {
+        return find_kernel_for(level)(data, length);
+    }
+
+    size_t utf8_length_from_latin1(const char* data, size_t length)
+    {
+        size_t result = length;
+
+        // Each byte above 127 becomes a two-byte sequence. The ASCII prefix is skipped using the vectorized scan.
+        for (size_t i = find_non_ascii(data, length); i < length; i++) {
+            result += (uint8_t)data[i] >> 7;
+        }
+
+        return result;
+    }
+
+    size_t latin1_to_utf8(const char* data, size_t length, char* output)
+    {
+        size_t ascii_prefix = find_non_ascii(data, length);
+        size_t j = ascii_prefix;
+
+        memcpy(output, data, ascii_prefix);
+
+        for (size_t i = ascii_prefix; i < length; i++) {
+            auto byte = (uint8_t)data[i];
+
+            if (byte < 0x80) {
+                output[j++] = (char)byte;
+            }
+            else {
+                output[j++] = (char)(0xC0 | (byte >> 6));
+                output[j++] = (char)(0x80 | (byte & 0x3F));
+            }
+        }
+
+        return j;
+    }
+}
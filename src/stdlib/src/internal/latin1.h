@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Narrows UTF-16 code units to Latin-1 (ISO-8859-1) bytes, i.e. the first 256 code points, one byte per code unit.
+    // Conversion stops at the first code unit which does not fit in a byte; the return value is the number of code
+    // units converted, so the whole input was converted if and only if the result is `length`. The fastest
+    // implementation supported by the CPU is selected on the first call.
+    size_t narrow_to_latin1(const uint16_t* data, size_t length, char* output);
+
+    // Variant of the above which uses the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. Intended for tests and benchmarks; see find_non_ascii() for the caveats.
+    size_t narrow_to_latin1(const uint16_t* data, size_t length, char* output, SimdLevel level);
+
+    // Returns the index of the first code unit which does not fit in Latin-1 (i.e. which is above U+00FF), or `length` if
+    // all of them fit. Useful for checking if content can be narrowed before allocating a buffer for it. The fastest
+    // implementation supported by the CPU is selected on the first call.
+    [[nodiscard]]
+    size_t find_non_latin1(const uint16_t* data, size_t length);
+
+    // Variant of the above which uses the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. Intended for tests and benchmarks; see find_non_ascii() for the caveats.
+    [[nodiscard]]
+    size_t find_non_latin1(const uint16_t* data, size_t length, SimdLevel level);
+
+    // Returns the number of bytes needed to encode the given Latin-1 content as UTF-8.
+    [[nodiscard]]
+    size_t utf8_length_from_latin1(const char* data, size_t length);
+
+    // Transcodes Latin-1 content to UTF-8. The output buffer must be at least utf8_length_from_latin1() bytes long.
+    // Returns the number of bytes written. Latin-1 content is always valid, so this never fails.
+    size_t latin1_to_utf8(const char* data, size_t length, char* output);
+}
@@ -0,0 +1,183 @@
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <locale.h>
+#include <stdexcept>
+#include <string>
+
+#include "internal/number_parsing.h"
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h> // strtod_l()
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        // std::from_chars() accepts a leading `-`, but not a leading `+`. We allow both, like most other languages.
+        // Returns false if the sign is followed by another sign, which from_chars() would otherwise accept.
+        bool skip_plus_sign(const char*& first, const char* last)
+        {
+            if (first < last && *first == '+') {
+                first++;
+
+                if (first < last && (*first == '-' || *first == '+')) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        template <typename T>
+        std::errc parse_integer_impl(const char* first, const char* last, T& result)
+        {
+            if (!skip_plus_sign(first, last)) {
+                return std::errc::invalid_argument;
+            }
+
+            T value;
+            auto [end, error] = std::from_chars(first, last, value);
+
+            if (error != std::errc()) {
+                return error;
+            }
+
+            // Trailing garbage ("123abc") makes the whole string invalid.
+            if (end != last) {
+                return std::errc::invalid_argument;
+            }
+
+            result = value;
+            return std::errc();
+        }
+    }
+
+    std::errc parse_integer(const char* first, const char* last, int32_t& result)
+    {
+        return parse_integer_impl(first, last, result);
+    }
+
+    std::errc parse_integer(const char* first, const char* last, int64_t& result)
+    {
+        return parse_integer_impl(first, last, result);
+    }
+
+    std::errc parse_double(const char* first, const char* last, double& result)
+    {
+        if (!skip_plus_sign(first, last)) {
+            return std::errc::invalid_argument;
+        }
+
+#if defined(__cpp_lib_to_chars)
+        double value;
+        auto [end, error] = std::from_chars(first, last, value);
+
+        if (error != std::errc()) {
+            return error;
+        }
+
+        if (end != last) {
+            return std::errc::invalid_argument;
+        }
+
+        result = value;
+        return std::errc();
+#else
+        // Floating-point std::from_chars() is not available in all C++ libraries we support (e.g. libc++ in LLVM 14),
+        // so we fall back to strtod() there. It differs from from_chars() in a few ways, which are compensated for here
+        // so that the results are the same on all platforms:
+        //
+        // - It requires a NUL-terminated string, and skips leading whitespace (which we don't want to allow).
+        // - It uses the decimal separator of the current locale. We use the "C" locale instead.
+        // - It accepts hexadecimal floating-point numbers like "0x1p3".
+        // - It reports underflow using ERANGE, while still returning a value.
+        if (first == last || std::isspace(static_cast<unsigned char>(*first))) {
+            return std::errc::invalid_argument;
+        }
+
+        const char* digits = first < last && *first == '-' ? first + 1 : first;
+
+        if (last - digits >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+            return std::errc::invalid_argument;
+        }
+
+        static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", nullptr);
+
+        std::string copy(first, last);
+        char* end;
+
+        errno = 0;
+        double value = strtod_l(copy.c_str(), &end, c_locale);
+
+        if (end != copy.c_str() + copy.length()) {
+            return std::errc::invalid_argument;
+        }
+
+        // Like from_chars(), values which are too small to be represented are considered out of range, while subnormal
+        // values (which strtod() may also report using ERANGE) are returned as-is.
+        if (errno == ERANGE && (std::isinf(value) || value == 0)) {
+            return std::errc::result_out_of_range;
+        }
+
+        result = value;
+        return std::errc();
+#endif
+    }
+
+    void throw_parse_error(std::errc error, const char* first, const char* last, const char* type_name)
+    {
+        std::string content(first, last);
+
+        if (error == std::errc::result_out_of_range) {
+            throw std::out_of_range("Value '" + content + "' is outside the range of " + type_name);
+        }
+        else {
+            throw std::invalid_argument("Value '" + content + "' is not a valid " + type_name);
+        }
+    }
+
+    void throw_parse_error(std::errc error, const char* first, const char* last, const char* type_name, size_t index)
+    {
+        std::string content(first, last);
+
+        if (error == std::errc::result_out_of_range) {
+            throw std::out_of_range("Value '" + content + "' at index " + std::to_string(index) + " is outside the range of " + type_name);
+        }
+        else {
+            throw std::invalid_argument("Value '" + content + "' at index " + std::to_string(index) + " is not a valid " + type_name);
+        }
+    }
+
+    size_t count_delimited(const char* data, size_t length, char delimiter)
+    {
+        const char* end = data + length;
+        size_t delimiters = 0;
+        bool has_content = false;
+        bool has_content_after_last_delimiter = false;
+
+        for (const char* position = data; position < end; position++) {
+            char c = *position;
+
+            if (c == delimiter) {
+                delimiters++;
+                has_content_after_last_delimiter = false;
+            }
+            else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                has_content = true;
+                has_content_after_last_delimiter = true;
+            }
+        }
+
+        if (!has_content && delimiters == 0) {
+            return 0;
+        }
+
+        // A trailing delimiter is ignored, so that e.g. newline-separated input ending with a line break doesn't get an
+        // empty element at the end.
+        return has_content_after_last_delimiter || delimiters == 0 ? delimiters + 1 : delimiters;
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+
+#include "ascii_string.h"
+#include "perlang_string.h"
+#include "utf8_string.h"
+
+namespace perlang::internal
+{
+    // Parses the whole of [first, last) as a decimal integer, with an optional leading `+` or `-` sign. Returns
+    // `std::errc()` on success, `std::errc::invalid_argument` if the content is not a valid integer (including when it
+    // is empty or has leading/trailing whitespace) or `std::errc::result_out_of_range` if the value does not fit in the
+    // result type. `result` is only modified on success.
+    [[nodiscard]]
+    std::errc parse_integer(const char* first, const char* last, int32_t& result);
+
+    [[nodiscard]]
+    std::errc parse_integer(const char* first, const char* last, int64_t& result);
+
+    // Same as above, but for floating-point numbers in either fixed or scientific notation (`1.5`, `-2e10`). `inf`,
+    // `infinity` and `nan` are also accepted, case-insensitively.
+    [[nodiscard]]
+    std::errc parse_double(const char* first, const char* last, double& result);
+
+    // Overloads of the above with the same name, so that they can be called from the templates below regardless of the
+    // value type.
+    [[nodiscard]]
+    inline std::errc parse_value(const char* first, const char* last, int32_t& result)
+    {
+        return parse_integer(first, last, result);
+    }
+
+    [[nodiscard]]
+    inline std::errc parse_value(const char* first, const char* last, int64_t& result)
+    {
+        return parse_integer(first, last, result);
+    }
+
+    [[nodiscard]]
+    inline std::errc parse_value(const char* first, const char* last, double& result)
+    {
+        return parse_double(first, last, result);
+    }
+
+    // Throws an exception describing a failed parse_integer() or parse_double() call for the content in [first, last).
+    // `type_name` is the Perlang name of the type being parsed (e.g. "Int32"). std::out_of_range is thrown for
+    // `std::errc::result_out_of_range`, and std::invalid_argument for anything else.
+    [[noreturn]]
+    void throw_parse_error(std::errc error, const char* first, const char* last, const char* type_name);
+
+    // Same as above, but for an element of a delimited list. The index of the element is included in the message.
+    [[noreturn]]
+    void throw_parse_error(std::errc error, const char* first, const char* last, const char* type_name, size_t index);
+
+    // Returns the number of elements in a `delimiter`-separated list, as iterated by for_each_delimited(). Input which is
+    // empty or only consists of whitespace has no elements. Otherwise, there is one more element than there are
+    // delimiters, except when the last delimiter is only followed by whitespace; such a trailing delimiter is ignored.
+    [[nodiscard]]
+    size_t count_delimited(const char* data, size_t length, char delimiter);
+
+    // Calls `func(first, last, index)` for the first `count` elements in a `delimiter`-separated list, where `count` is
+    // the result of count_delimited() for the same input. Spaces, tabs, and line breaks surrounding each element are
+    // skipped, so empty elements (including whitespace-only ones) are passed to `func` as empty ranges.
+    template <typename Func>
+    void for_each_delimited(const char* data, size_t length, char delimiter, size_t count, Func&& func)
+    {
+        auto is_whitespace = [](char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        };
+
+        const char* end = data + length;
+        const char* position = data;
+
+        for (size_t index = 0; index < count; index++) {
+            const char* element_end = std::find(position, end, delimiter);
+
+            const char* first = position;
+            const char* last = element_end;
+
+            while (first < last && is_whitespace(*first)) {
+                first++;
+            }
+
+            while (last > first && is_whitespace(last[-1])) {
+                last--;
+            }
+
+            func(first, last, index);
+
+            position = element_end < end ? element_end + 1 : end;
+        }
+    }
+
+    // The implementations of the parse(), try_parse() and parse_array() methods of Int32, Int64 and Double, which only
+    // differ in the value type (T), the array type returned by parse_array() and the type name used in error messages.
+
+    template <typename T>
+    T parse_number(const String& s, const char* type_name)
+    {
+        // UTF-16 content cannot be parsed directly. Valid numbers are always ASCII-only, so the conversion is cheap.
+        if (s.encoding() == StringEncoding::utf16) {
+            return parse_number<T>(*s.as_utf8(), type_name);
+        }
+
+        const char* first = s.bytes();
+        const char* last = first + s.length();
+        T result;
+
+        std::errc error = parse_value(first, last, result);
+
+        if (error != std::errc()) {
+            throw_parse_error(error, first, last, type_name);
+        }
+
+        return result;
+    }
+
+    template <typename T>
+    bool try_parse_number(const String& s, T& result)
+    {
+        if (s.encoding() == StringEncoding::utf16) {
+            // is_ascii() is non-const since it can cache its result, but it doesn't modify the content of the string.
+            if (!const_cast<String&>(s).is_ascii()) {
+                return false;
+            }
+
+            return try_parse_number(*s.as_ascii(), result);
+        }
+
+        return parse_value(s.bytes(), s.bytes() + s.length(), result) == std::errc();
+    }
+
+    template <typename T, typename Array>
+    std::unique_ptr<Array> parse_number_array(const String& s, char delimiter, const char* type_name)
+    {
+        if (s.encoding() == StringEncoding::utf16) {
+            return parse_number_array<T, Array>(*s.as_utf8(), delimiter, type_name);
+        }
+
+        const char* data = s.bytes();
+        size_t length = s.length();
+
+        // Counting the values first lets us allocate the array up front, instead of growing it as we go.
+        size_t count = count_delimited(data, length, delimiter);
+        auto result = std::make_unique<Array>(count);
+
+        for_each_delimited(data, length, delimiter, count, [&](const char* first, const char* last, size_t index) {
+            T value;
+            std::errc error = parse_value(first, last, value);
+
+            if (error != std::errc()) {
+                throw_parse_error(error, first, last, type_name, index);
+            }
+
+            result->set(index, value);
+        });
+
+        return result;
+    }
+}
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "internal/string_comparison.h"
+#include "internal/transcoding.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        using mismatch_ascii_utf16_fn = size_t (*)(const char*, const uint16_t*, size_t);
+
+        size_t mismatch_ascii_utf16_scalar(const char* ascii, const uint16_t* utf16, size_t length)
+        {
+            for (size_t i = 0; i < length; i++) {
+                if ((uint8_t)ascii[i] != utf16[i]) {
+                    return i;
+                }
+            }
+
+            return length;
+        }
+
+#ifdef PERLANG_X86_64
+        // The vectorized kernels widen 16 ASCII bytes at a time to 16-bit lanes, and compare them with the
+        // corresponding UTF-16 code units. The comparison yields two mask bits per code unit, so the index of the first
+        // mismatch is half the number of trailing one bits.
+
+        size_t mismatch_ascii_utf16_sse2(const char* ascii, const uint16_t* utf16, size_t length)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+
+            for (; i + 16 <= length; i += 16) {
+                __m128i bytes = _mm_loadu_si128((const __m128i*)(ascii + i));
+                __m128i low = _mm_cmpeq_epi16(_mm_unpacklo_epi8(bytes, zero), _mm_loadu_si128((const __m128i*)(utf16 + i)));
+                __m128i high = _mm_cmpeq_epi16(_mm_unpackhi_epi8(bytes, zero), _mm_loadu_si128((const __m128i*)(utf16 + i + 8)));
+                auto mask = (uint32_t)_mm_movemask_epi8(low) | ((uint32_t)_mm_movemask_epi8(high) << 16);
+
+                if (mask != 0xFFFFFFFF) {
+                    return i + __builtin_ctz(~mask) / 2;
+                }
+            }
+
+            return i + mismatch_ascii_utf16_scalar(ascii + i, utf16 + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t mismatch_ascii_utf16_avx2(const char* ascii, const uint16_t* utf16, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 32 <= length; i += 32) {
+                __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(ascii + i)));
+                __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(ascii + i + 16)));
+                __m256i a_equal = _mm256_cmpeq_epi16(a, _mm256_loadu_si256((const __m256i*)(utf16 + i)));
+                __m256i b_equal = _mm256_cmpeq_epi16(b, _mm256_loadu_si256((const __m256i*)(utf16 + i + 16)));
+
+                auto a_mask = (uint32_t)_mm256_movemask_epi8(a_equal);
+                auto b_mask = (uint32_t)_mm256_movemask_epi8(b_equal);
+
+                if ((a_mask & b_mask) != 0xFFFFFFFF) {
+                    return a_mask != 0xFFFFFFFF ? i + __builtin_ctz(~a_mask) / 2 : i + 16 + __builtin_ctz(~b_mask) / 2;
+                }
+            }
+
+            return i + mismatch_ascii_utf16_sse2(ascii + i, utf16 + i, length - i);
+        }
+#endif // PERLANG_X86_64
+
+        mismatch_ascii_utf16_fn kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                // Widening is not any cheaper with AVX-512, and the strings compared are typically short.
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return mismatch_ascii_utf16_avx2;
+                case SimdLevel::sse2:
+                    return mismatch_ascii_utf16_sse2;
+#endif
+                default:
+                    return mismatch_ascii_utf16_scalar;
+            }
+        }
+
+        // Returned by decode_utf8() and decode_utf16() for content which is not a valid code point. The offending byte
+        // or code unit is added to it, so that invalid content is still ordered consistently. Since the value is
+        // outside the Unicode range, it never matches a valid code point from the other side.
+        constexpr uint32_t INVALID = 0x110000;
+
+        // Decodes the code point starting at `data[i]`, and advances `i` past it. Invalid sequences (including
+        // overlong encodings and encoded surrogates) are consumed one byte at a time.
+        uint32_t decode_utf8(const char* data, size_t length, size_t& i)
+        {
+            auto lead = (uint8_t)data[i];
+            size_t sequence_length;
+            uint32_t code_point;
+            uint32_t minimum;
+
+            if (lead < 0x80) {
+                i++;
+                return lead;
+            }
+            else if ((lead & 0xE0) == 0xC0) {
+                sequence_length = 2;
+                code_point = lead & 0x1F;
+                minimum = 0x80;
+            }
+            else if ((lead & 0xF0) == 0xE0) {
+                sequence_length = 3;
+                code_point = lead & 0x0F;
+                minimum = 0x800;
+            }
+            else if ((lead & 0xF8) == 0xF0) {
+                sequence_length = 4;
+                code_point = lead & 0x07;
+                minimum = 0x10000;
+            }
+            else {
+                i++;
+                return INVALID + lead;
+            }
+
+            if (sequence_length > length - i) {
+                i++;
+                return INVALID + lead;
+            }
+
+            for (size_t k = 1; k < sequence_length; k++) {
+                auto continuation = (uint8_t)data[i + k];
+
+                if ((continuation & 0xC0) != 0x80) {
+                    i++;
+                    return INVALID + lead;
+                }
+
+                code_point = (code_point << 6) | (continuation & 0x3F);
+            }
+
+            if (code_point < minimum || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+                i++;
+                return INVALID + lead;
+            }
+
+            i += sequence_length;
+            return code_point;
+        }
+
+        // Decodes the code point starting at `data[i]`, and advances `i` past it.
+        uint32_t decode_utf16(const uint16_t* data, size_t length, size_t& i)
+        {
+            uint16_t unit = data[i++];
+
+            if (unit < 0xD800 || unit > 0xDFFF) {
+                return unit;
+            }
+
+            if (unit <= 0xDBFF && i < length && data[i] >= 0xDC00 && data[i] <= 0xDFFF) {
+                return 0x10000 + ((uint32_t)(unit - 0xD800) << 10) + (data[i++] - 0xDC00);
+            }
+
+            return INVALID + unit;
+        }
+
+        int compare_lengths(size_t lhs_length, size_t rhs_length)
+        {
+            return lhs_length < rhs_length ? -1 : lhs_length > rhs_length ? 1 : 0;
+        }
+
+        // Decodes both sides one code point at a time. Used for content which cannot be transcoded, i.e. UTF-16 with
+        // unpaired surrogates.
+        int compare_utf8_utf16_scalar(const char* utf8, size_t utf8_length, const uint16_t* utf16, size_t utf16_length)
+        {
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < utf8_length && j < utf16_length) {
+                auto byte = (uint8_t)utf8[i];
+                uint16_t unit = utf16[j];
+
+                if (byte < 0x80 && unit < 0x80) {
+                    if (byte != unit) {
+                        return byte < unit ? -1 : 1;
+                    }
+
+                    i++;
+                    j++;
+                    continue;
+                }
+
+                uint32_t lhs = decode_utf8(utf8, utf8_length, i);
+                uint32_t rhs = decode_utf16(utf16, utf16_length, j);
+
+                if (lhs != rhs) {
+                    return lhs < rhs ? -1 : 1;
+                }
+            }
+
+            return compare_lengths(utf8_length - i, utf16_length - j);
+        }
+    }
+
+    size_t mismatch_ascii_utf16(const char* ascii, const uint16_t* utf16, size_t length)
+    {
+        static const mismatch_ascii_utf16_fn kernel = kernel_for(detected_simd_level());
+        return kernel(ascii, utf16, length);
+    }
+
+    size_t mismatch_ascii_utf16(const char* ascii, const uint16_t* utf16, size_t length, SimdLevel level)
+    {
+        return kernel_for(level)(ascii, utf16, length);
+    }
+
+    int compare_utf8(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length)
+    {
+        size_t common_length = std::min(lhs_length, rhs_length);
+        int result = common_length > 0 ? memcmp(lhs, rhs, common_length) : 0;
+
+        return result != 0 ? result : compare_lengths(lhs_length, rhs_length);
+    }
+
+    int compare_utf16(const uint16_t* lhs, size_t lhs_length, const uint16_t* rhs, size_t rhs_length)
+    {
+        size_t common_length = std::min(lhs_length, rhs_length);
+        auto [lhs_position, rhs_position] = std::mismatch(lhs, lhs + common_length, rhs);
+
+        if (lhs_position == lhs + common_length) {
+            return compare_lengths(lhs_length, rhs_length);
+        }
+
+        uint32_t a = *lhs_position;
+        uint32_t b = *rhs_position;
+
+        // Surrogates encode code points above U+FFFF, but are numerically lower than U+E000-U+FFFF. Moving them above
+        // that range makes the code unit order match the code point order.
+        if (a >= 0xD800 && b >= 0xD800) {
+            a = a >= 0xE000 ? a - 0x800 : a + 0x2000;
+            b = b >= 0xE000 ? b - 0x800 : b + 0x2000;
+        }
+
+        return a < b ? -1 : 1;
+    }
+
+    int compare_ascii_utf16(const char* ascii, size_t ascii_length, const uint16_t* utf16, size_t utf16_length)
+    {
+        size_t common_length = std::min(ascii_length, utf16_length);
+        size_t index = mismatch_ascii_utf16(ascii, utf16, common_length);
+
+        if (index == common_length) {
+            return compare_lengths(ascii_length, utf16_length);
+        }
+
+        return (uint8_t)ascii[index] < utf16[index] ? -1 : 1;
+    }
+
+    int compare_utf8_utf16(const char* utf8, size_t utf8_length, const uint16_t* utf16, size_t utf16_length)
+    {
+        // Decoding both sides one code point at a time is branchy and slow for mixed ASCII/non-ASCII content. Instead,
+        // the UTF-16 content is transcoded in chunks to a buffer on the stack using the vectorized transcoder, and
+        // compared to the UTF-8 content using memcmp(). This gives the correct order, since the byte order of UTF-8 is
+        // the same as the code point order.
+        constexpr size_t CHUNK_LENGTH = 128;
+        char buffer[CHUNK_LENGTH * 3];
+
+        size_t i = 0;
+        size_t j = 0;
+
+        while (j < utf16_length) {
+            size_t chunk_length = std::min(CHUNK_LENGTH, utf16_length - j);
+
+            // Surrogate pairs must not be split between two chunks.
+            if (j + chunk_length < utf16_length && utf16[j + chunk_length - 1] >= 0xD800 && utf16[j + chunk_length - 1] <= 0xDBFF) {
+                chunk_length--;
+            }
+
+            size_t produced;
+
+            try {
+                produced = utf16_to_utf8(utf16 + j, chunk_length, buffer);
+            }
+            catch (const std::invalid_argument&) {
+                return compare_utf8_utf16_scalar(utf8 + i, utf8_length - i, utf16 + j, utf16_length - j);
+            }
+
+            size_t remaining = utf8_length - i;
+            int result = memcmp(utf8 + i, buffer, std::min(produced, remaining));
+
+            if (result != 0) {
+                return result < 0 ? -1 : 1;
+            }
+
+            if (produced > remaining) {
+                return -1;
+            }
+
+            i += produced;
+            j += chunk_length;
+        }
+
+        return i < utf8_length ? 1 : 0;
+    }
+
+    bool equals_utf8_utf16(const char* utf8, size_t utf8_length, const uint16_t* utf16, size_t utf16_length)
+    {
+        // Each UTF-16 code unit corresponds to between one and three bytes of UTF-8; four-byte sequences correspond to
+        // surrogate pairs.
+        if (utf8_length < utf16_length || utf8_length > utf16_length * 3) {
+            return false;
+        }
+
+        return compare_utf8_utf16(utf8, utf8_length, utf16, utf16_length) == 0;
+    }
+
+    int compare_utf8_latin1(const char* utf8, size_t utf8_length, const char* latin1, size_t latin1_length)
+    {
+        size_t i = 0;
+        size_t j = 0;
+
+        while (i < utf8_length && j < latin1_length) {
+            auto byte = (uint8_t)utf8[i];
+            uint32_t rhs = (uint8_t)latin1[j++];
+
+            if (byte < 0x80) {
+                if (byte != rhs) {
+                    return byte < rhs ? -1 : 1;
+                }
+
+                i++;
+                continue;
+            }
+
+            uint32_t lhs = decode_utf8(utf8, utf8_length, i);
+
+            if (lhs != rhs) {
+                return lhs < rhs ? -1 : 1;
+            }
+        }
+
+        return compare_lengths(utf8_length - i, latin1_length - j);
+    }
+
+    bool equals_utf8_latin1(const char* utf8, size_t utf8_length, const char* latin1, size_t latin1_length)
+    {
+        // Each Latin-1 character is either one or two bytes long in UTF-8.
+        if (utf8_length < latin1_length || utf8_length > latin1_length * 2) {
+            return false;
+        }
+
+        return compare_utf8_latin1(utf8, utf8_length, latin1, latin1_length) == 0;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Returns the index of the first position where the ASCII characters in `ascii` and the UTF-16 code units in
+    // `utf16` differ, or `length` if they are all equal. The ASCII bytes are widened to 16 bits on the fly, so that no
+    // converted copy of either side is needed. The bytes are zero-extended, which means that Latin-1 content works as
+    // well. The fastest implementation supported by the CPU is selected on the first call.
+    [[nodiscard]]
+    size_t mismatch_ascii_utf16(const char* ascii, const uint16_t* utf16, size_t length);
+
+    // Variant of the above which uses the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. Intended for tests and benchmarks; see find_non_ascii() for the caveats.
+    [[nodiscard]]
+    size_t mismatch_ascii_utf16(const char* ascii, const uint16_t* utf16, size_t length, SimdLevel level);
+
+    // The functions below compare strings by Unicode code point, returning a negative value if the first string sorts
+    // before the second one, zero if they are equal and a positive value otherwise. Since all of them use the same
+    // order, strings can be sorted consistently regardless of how their content is encoded.
+    //
+    // Invalid UTF-8 sequences and unpaired UTF-16 surrogates are never considered equal to any content in the other
+    // encoding. They are still ordered consistently, but the exact position is unspecified.
+
+    // UTF-8 (or ASCII) vs UTF-8. The byte order of UTF-8 is the same as the code point order, so this is a memcmp().
+    [[nodiscard]]
+    int compare_utf8(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length);
+
+    // UTF-16 vs UTF-16. Code units in the surrogate range are adjusted when comparing, since their numeric order
+    // differs from the order of the code points they encode.
+    [[nodiscard]]
+    int compare_utf16(const uint16_t* lhs, size_t lhs_length, const uint16_t* rhs, size_t rhs_length);
+
+    // ASCII vs UTF-16, using mismatch_ascii_utf16(). Like that function, this works for Latin-1 content as well.
+    [[nodiscard]]
+    int compare_ascii_utf16(const char* ascii, size_t ascii_length, const uint16_t* utf16, size_t utf16_length);
+
+    // UTF-8 vs UTF-16. The UTF-16 content is transcoded in small chunks on the stack and compared using memcmp(), so
+    // no heap allocations are made.
+    [[nodiscard]]
+    int compare_utf8_utf16(const char* utf8, size_t utf8_length, const uint16_t* utf16, size_t utf16_length);
+
+    // Returns true if the UTF-8 content equals the UTF-16 content. Faster than compare_utf8_utf16() for strings whose
+    // lengths make them impossible to be equal.
+    [[nodiscard]]
+    bool equals_utf8_utf16(const char* utf8, size_t utf8_length, const uint16_t* utf16, size_t utf16_length);
+
+    // UTF-8 vs Latin-1, decoding the UTF-8 content one code point at a time. UTF-8 characters outside of the Latin-1
+    // range sort after all Latin-1 characters.
+    [[nodiscard]]
+    int compare_utf8_latin1(const char* utf8, size_t utf8_length, const char* latin1, size_t latin1_length);
+
+    // Returns true if the UTF-8 content equals the Latin-1 content. Faster than compare_utf8_latin1() for strings whose
+    // lengths make them impossible to be equal.
+    [[nodiscard]]
+    bool equals_utf8_latin1(const char* utf8, size_t utf8_length, const char* latin1, size_t latin1_length);
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstring>
+
+#include "internal/string_search.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+namespace perlang::internal
+{
+    namespace
+    {
+        // Signature of the kernels for needles of at least two bytes. The haystack is always at least as long as the
+        // needle when these are called.
+        using find_fn = size_t (*)(const char*, size_t, const char*, size_t);
+
+        // Portable fallback: memchr() for the first byte of the needle (which glibc and most other C libraries
+        // vectorize), followed by a comparison of the rest of the needle.
+        size_t find_scalar(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+        {
+            const char* position = haystack;
+            const char* last_candidate = haystack + haystack_length - needle_length;
+
+            while (position <= last_candidate) {
+                position = static_cast<const char*>(memchr(position, needle[0], last_candidate - position + 1));
+
+                if (position == nullptr) {
+                    return NOT_FOUND;
+                }
+
+                if (memcmp(position + 1, needle + 1, needle_length - 1) == 0) {
+                    return position - haystack;
+                }
+
+                position++;
+            }
+
+            return NOT_FOUND;
+        }
+
+#ifdef PERLANG_X86_64
+        // The vectorized kernels compare the first and last byte of the needle against 16 (or 32) candidate positions
+        // at once. Only the positions where both of them match need to be verified, which is rare in practice since
+        // the first and last byte of a needle are usually different. The main loop never reads beyond the end of the
+        // haystack; the remaining candidates are handled by the scalar kernel.
+
+        size_t find_sse2(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+        {
+            const __m128i first = _mm_set1_epi8(needle[0]);
+            const __m128i last = _mm_set1_epi8(needle[needle_length - 1]);
+            size_t i = 0;
+
+            for (; i + needle_length - 1 + 16 <= haystack_length; i += 16) {
+                __m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + i));
+                __m128i block_last = _mm_loadu_si128((const __m128i*)(haystack + i + needle_length - 1));
+                auto mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+
+                while (mask != 0) {
+                    size_t candidate = i + __builtin_ctz(mask);
+
+                    if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0) {
+                        return candidate;
+                    }
+
+                    mask &= mask - 1;
+                }
+            }
+
+            size_t result = find_scalar(haystack + i, haystack_length - i, needle, needle_length);
+            return result == NOT_FOUND ? NOT_FOUND : i + result;
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t find_avx2(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+        {
+            const __m256i first = _mm256_set1_epi8(needle[0]);
+            const __m256i last = _mm256_set1_epi8(needle[needle_length - 1]);
+            size_t i = 0;
+
+            for (; i + needle_length - 1 + 32 <= haystack_length; i += 32) {
+                __m256i block_first = _mm256_loadu_si256((const __m256i*)(haystack + i));
+                __m256i block_last = _mm256_loadu_si256((const __m256i*)(haystack + i + needle_length - 1));
+                auto mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+
+                while (mask != 0) {
+                    size_t candidate = i + __builtin_ctz(mask);
+
+                    if (memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0) {
+                        return candidate;
+                    }
+
+                    mask &= mask - 1;
+                }
+            }
+
+            size_t result = find_sse2(haystack + i, haystack_length - i, needle, needle_length);
+            return result == NOT_FOUND ? NOT_FOUND : i + result;
+        }
+#endif // PERLANG_X86_64
+
+        find_fn kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                // There is no AVX-512 kernel; the bottleneck for typical haystacks is the verification of candidates
+                // rather than the comparisons themselves.
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return find_avx2;
+                case SimdLevel::sse2:
+                    return find_sse2;
+#endif
+                default:
+                    return find_scalar;
+            }
+        }
+
+        size_t find_with(find_fn kernel, const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+        {
+            if (needle_length == 0) {
+                return 0;
+            }
+
+            if (needle_length > haystack_length) {
+                return NOT_FOUND;
+            }
+
+            if (needle_length == 1) {
+                auto position = static_cast<const char*>(memchr(haystack, needle[0], haystack_length));
+                return position == nullptr ? NOT_FOUND : position - haystack;
+            }
+
+            return kernel(haystack, haystack_length, needle, needle_length);
+        }
+    }
+
+    size_t find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+    {
+        static const find_fn kernel = kernel_for(detected_simd_level());
+        return find_with(kernel, haystack, haystack_length, needle, needle_length);
+    }
+
+    size_t find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length, SimdLevel level)
+    {
+        return find_with(kernel_for(level), haystack, haystack_length, needle, needle_length);
+    }
+
+    size_t rfind(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+    {
+        if (needle_length > haystack_length) {
+            return NOT_FOUND;
+        }
+
+        // Searching backwards is much less common than searching forwards, so we keep this simple: scan for the first
+        // byte of the needle from the end, and verify the rest of it on each hit.
+        for (size_t i = haystack_length - needle_length + 1; i-- > 0;) {
+            if (needle_length == 0 || (haystack[i] == needle[0] && memcmp(haystack + i + 1, needle + 1, needle_length - 1) == 0)) {
+                return i;
+            }
+        }
+
+        return NOT_FOUND;
+    }
+
+    size_t find(const uint16_t* haystack, size_t haystack_length, const uint16_t* needle, size_t needle_length)
+    {
+        const uint16_t* end = haystack + haystack_length;
+        const uint16_t* position = std::search(haystack, end, needle, needle + needle_length);
+
+        return position == end && needle_length > 0 ? NOT_FOUND : position - haystack;
+    }
+
+    size_t rfind(const uint16_t* haystack, size_t haystack_length, const uint16_t* needle, size_t needle_length)
+    {
+        const uint16_t* end = haystack + haystack_length;
+        const uint16_t* position = std::find_end(haystack, end, needle, needle + needle_length);
+
+        if (needle_length == 0) {
+            return haystack_length;
+        }
+
+        return position == end ? NOT_FOUND : position - haystack;
+    }
+}
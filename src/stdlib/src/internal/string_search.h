@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Returned by the search functions below when the needle is not found.
+    constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    // Returns the index of the first occurrence of `needle` in `haystack`, or NOT_FOUND if there is none. An empty
+    // needle is found at index 0. Single-byte needles are located using memchr(). For longer needles, a vectorized
+    // prefilter compares the first and last byte of the needle against a whole vector of candidate positions at once,
+    // and only verifies the full needle where both match. The fastest implementation supported by the CPU is selected
+    // on the first call.
+    [[nodiscard]]
+    size_t find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length);
+
+    // Variant of the above which uses the kernel for a particular SIMD level, regardless of the detected CPU
+    // capabilities. Intended for tests and benchmarks; see find_non_ascii() for the caveats.
+    [[nodiscard]]
+    size_t find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length, SimdLevel level);
+
+    // Returns the index of the last occurrence of `needle` in `haystack`, or NOT_FOUND if there is none. An empty
+    // needle is found at index `haystack_length`.
+    [[nodiscard]]
+    size_t rfind(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length);
+
+    // Same as find() and rfind(), but for UTF-16 code units. These are not vectorized (yet).
+    [[nodiscard]]
+    size_t find(const uint16_t* haystack, size_t haystack_length, const uint16_t* needle, size_t needle_length);
+
+    [[nodiscard]]
+    size_t rfind(const uint16_t* haystack, size_t haystack_length, const uint16_t* needle, size_t needle_length);
+}
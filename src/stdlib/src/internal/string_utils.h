@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 // fmt is an open-source formatting library providing a fast and safe alternative to C stdio and C++ iostreams.
@@ -20,4 +23,106 @@ namespace perlang::internal
         // Use the same precision as in C#
         return fmt::format("{:.15G}", lhs);
     }
+
+    // A number formatted as a string, stored in a fixed-size buffer instead of a heap-allocated std::string. The string
+    // concatenation operators use this to format the number before allocating the result, so that each concatenation
+    // only needs a single heap allocation. The content is always ASCII-only, and is not NUL-terminated.
+    class FormattedNumber
+    {
+     public:
+        explicit FormattedNumber(int64_t value)
+        {
+            if (value < 0) {
+                // Negating the value as unsigned avoids overflow for INT64_MIN.
+                buffer_[0] = '-';
+                length_ = 1 + write_decimal(buffer_ + 1, 0 - static_cast<uint64_t>(value));
+            }
+            else {
+                length_ = write_decimal(buffer_, static_cast<uint64_t>(value));
+            }
+        }
+
+        explicit FormattedNumber(uint64_t value)
+        {
+            length_ = write_decimal(buffer_, value);
+        }
+
+        explicit FormattedNumber(float value)
+        {
+            // Same format as float_to_string(), but without the intermediate std::string.
+            length_ = fmt::format_to_n(buffer_, sizeof(buffer_), "{:.7G}", value).size;
+        }
+
+        explicit FormattedNumber(double value)
+        {
+            // Same format as double_to_string(), but without the intermediate std::string.
+            length_ = fmt::format_to_n(buffer_, sizeof(buffer_), "{:.15G}", value).size;
+        }
+
+        [[nodiscard]]
+        const char* data() const
+        {
+            return buffer_;
+        }
+
+        [[nodiscard]]
+        size_t length() const
+        {
+            return length_;
+        }
+
+        // Returns the number of decimal digits in `value`.
+        [[nodiscard]]
+        static size_t decimal_length(uint64_t value)
+        {
+            size_t length = 1;
+
+            while (value >= 10000) {
+                value /= 10000;
+                length += 4;
+            }
+
+            return length + (value >= 10) + (value >= 100) + (value >= 1000);
+        }
+
+        // Writes the decimal representation of `value` to `buffer`, returning the number of characters written. The
+        // length is calculated up front, so that the digits can be written from right to left, two at a time.
+        static size_t write_decimal(char* buffer, uint64_t value)
+        {
+            static constexpr char digit_pairs[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+
+            size_t length = decimal_length(value);
+            char* position = buffer + length;
+
+            while (value >= 100) {
+                position -= 2;
+                memcpy(position, digit_pairs + (value % 100) * 2, 2);
+                value /= 100;
+            }
+
+            if (value >= 10) {
+                memcpy(position - 2, digit_pairs + value * 2, 2);
+            }
+            else {
+                position[-1] = static_cast<char>('0' + value);
+            }
+
+            return length;
+        }
+
+     private:
+        // Large enough for any int64, uint64, or float/double in the formats above (e.g. "-1.79769313486232E+308").
+        char buffer_[32];
+        size_t length_;
+    };
 }
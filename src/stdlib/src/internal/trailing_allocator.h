@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace perlang::internal
+{
+    // An allocator for use with std::allocate_shared(), which allocates `trailing_bytes` bytes of extra storage after
+    // the memory requested by the standard library. Since std::allocate_shared() places the control block and the
+    // object in a single allocation, this makes it possible to store the content of a string in the same allocation as
+    // the string object and its reference counts.
+    //
+    // The address of the extra storage is written to `trailing` when the memory is allocated, which happens before the
+    // object is constructed. The constructor can thus read it, provided that it receives `trailing` by reference.
+    //
+    // The allocator is only meant to be used for a single std::allocate_shared() call; `trailing` is not used after
+    // the allocation, and the memory is deallocated without needing to know the size of the extra storage.
+    template <typename T>
+    class TrailingAllocator
+    {
+     public:
+        using value_type = T;
+
+        TrailingAllocator(size_t trailing_bytes, char*& trailing)
+            : trailing_bytes_(trailing_bytes),
+              trailing_(&trailing)
+        {
+        }
+
+        template <typename U>
+        TrailingAllocator(const TrailingAllocator<U>& other)
+            : trailing_bytes_(other.trailing_bytes_),
+              trailing_(other.trailing_)
+        {
+        }
+
+        [[nodiscard]]
+        T* allocate(size_t n)
+        {
+            size_t size = n * sizeof(T);
+            char* memory = static_cast<char*>(::operator new(size + trailing_bytes_));
+
+            // The extra storage is only used for character data, so it doesn't need any particular alignment.
+            *trailing_ = trailing_bytes_ > 0 ? memory + size : nullptr;
+
+            return reinterpret_cast<T*>(memory);
+        }
+
+        void deallocate(T* p, size_t) noexcept
+        {
+            ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const TrailingAllocator<U>& other) const
+        {
+            return trailing_ == other.trailing_;
+        }
+
+        template <typename U>
+        bool operator!=(const TrailingAllocator<U>& other) const
+        {
+            return !(*this == other);
+        }
+
+     private:
+        template <typename U>
+        friend class TrailingAllocator;
+
+        size_t trailing_bytes_;
+        char** trailing_;
+    };
+}
@@ -0,0 +1,753 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "internal/transcoding.h"
+
+#ifdef PERLANG_X86_64
+#include <immintrin.h>
+#endif
+
+#define TWO_BYTE_UTF8(c)   (((c) & 0b11100000) == 0b11000000)
+#define THREE_BYTE_UTF8(c) (((c) & 0b11110000) == 0b11100000)
+#define FOUR_BYTE_UTF8(c)  (((c) & 0b11111000) == 0b11110000)
+
+#define TWO_BYTE_UTF8_WITHOUT_MASK(c)   ((c) & 0b00011111)
+#define THREE_BYTE_UTF8_WITHOUT_MASK(c) ((c) & 0b00001111)
+#define FOUR_BYTE_UTF8_WITHOUT_MASK(c)  ((c) & 0b00000111)
+
+// This is present in all bytes of a UTF-8 sequence except for the first one
+#define IS_UTF8_SEQUENCE_MASK(c) (((c) & 0b11000000) == 0b10000000)
+#define UTF8_WITHOUT_SEQUENCE_MASK(c) ((c) & 0b00111111)
+
+namespace perlang::internal
+{
+    namespace
+    {
+        using utf16_length_fn = size_t (*)(const char*, size_t);
+        using utf8_to_utf16_fn = size_t (*)(const char*, size_t, uint16_t*);
+
+        // Decodes a single UTF-8 sequence starting at data[i], writing one or two UTF-16 code units to output[j].
+        // Both `i` and `j` are advanced past the consumed input and produced output, respectively. This is the slow
+        // path of all the conversion kernels below; they only differ in how they handle runs of ASCII characters.
+        inline void decode_utf8_sequence(const char* data, size_t length, size_t& i, uint16_t* output, size_t& j)
+        {
+            uint8_t c = data[i];
+
+            if (c <= 127) {
+                // This is an ASCII character; no special measures are needed
+                output[j] = c;
+                i++;
+                j++;
+                return;
+            }
+
+            // There are three valid scenarios at this point, as described nicely here:
+            // https://dev.to/emnudge/decoding-utf-8-3947 (examples are in binary):
+            //
+            // - Starting with 110 - UTF-8 code point with 2 bytes
+            // - Starting with 1110 - code point with 3 bytes
+            // - Starting with 11110 - code point with 4 bytes
+            //
+            // Anything else (like 10) is to be considered invalid; it's only expected in the subsequent bytes.
+            // Because we can make those assumptions, this is now implemented as a simple list of if/else
+            // statements. We also need to do bounds checking, to ensure we don't cause a buffer overrun.
+            if (TWO_BYTE_UTF8(c)) {
+                if (i + 1 >= length) {
+                    throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit two bytes of expected UTF-8 data)");
+                }
+
+                uint8_t d = data[i + 1];
+
+                if (!IS_UTF8_SEQUENCE_MASK(d)) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (second byte lacks UTF-8 mask)");
+                }
+
+                uint16_t target_char = (TWO_BYTE_UTF8_WITHOUT_MASK(c) << 6) +
+                                       UTF8_WITHOUT_SEQUENCE_MASK(d);
+
+                // "Overlong" sequences must be treated as invalid per RFC 3629
+                if (target_char < 128) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
+                }
+
+                output[j] = target_char;
+
+                i += 2;
+                j++;
+            }
+            else if (THREE_BYTE_UTF8(c)) {
+                if (i + 2 >= length) {
+                    throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit three bytes of expected UTF-8 data)");
+                }
+
+                uint8_t d = data[i + 1];
+                uint8_t e = data[i + 2];
+
+                if (!IS_UTF8_SEQUENCE_MASK(d) || !IS_UTF8_SEQUENCE_MASK(e)) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (one or more byte(s) lacks UTF-8 mask)");
+                }
+
+                uint16_t target_char = (THREE_BYTE_UTF8_WITHOUT_MASK(c) << 12) +
+                                       (UTF8_WITHOUT_SEQUENCE_MASK(d) << 6) +
+                                       UTF8_WITHOUT_SEQUENCE_MASK(e);
+
+                // "Overlong" sequences must be treated as invalid per RFC 3629
+                if (target_char < 2048) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
+                }
+
+                output[j] = target_char;
+
+                i += 3;
+                j++;
+            }
+            else if (FOUR_BYTE_UTF8(c)) {
+                if (i + 3 >= length) {
+                    throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit four bytes of expected UTF-8 data)");
+                }
+
+                uint8_t d = data[i + 1];
+                uint8_t e = data[i + 2];
+                uint8_t f = data[i + 3];
+
+                if (!IS_UTF8_SEQUENCE_MASK(d) || !IS_UTF8_SEQUENCE_MASK(e) || !IS_UTF8_SEQUENCE_MASK(f)) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (one or more  byte(s) lacks UTF-8 mask)");
+                }
+
+                // Note that the target character is a surrogate pair in this case, so we need to store two
+                // characters in the resulting array.
+                uint32_t target_char = (FOUR_BYTE_UTF8_WITHOUT_MASK(c) << 18) +
+                                       (UTF8_WITHOUT_SEQUENCE_MASK(d) << 12) +
+                                       (UTF8_WITHOUT_SEQUENCE_MASK(e) << 6) +
+                                       UTF8_WITHOUT_SEQUENCE_MASK(f);
+
+                // "Overlong" sequences must be treated as invalid per RFC 3629
+                if (target_char < 65536) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
+                }
+
+                if (target_char > 0x10FFFF) {
+                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (code point exceeds maximum allowed value of 0x10FFFF)");
+                }
+
+                // Convert the code point to a surrogate pair
+                target_char -= 0x10000;
+                output[j] = (target_char >> 10) + 0xD800;        // High surrogate
+                output[j + 1] = (target_char & 0x3FF) + 0xDC00;  // Low surrogate
+
+                i += 4;
+                j += 2;
+            }
+            else {
+                throw std::invalid_argument("Invalid UTF-8 sequence encountered (first byte does not match any known UTF-8 encoding scheme)");
+            }
+        }
+
+        // Every byte which is not a continuation byte (10xxxxxx) starts a new code point, which needs one UTF-16 code
+        // unit. Code points encoded using four bytes (11110xxx) need a surrogate pair, i.e. one extra code unit.
+        inline size_t utf16_units_for_byte(uint8_t c)
+        {
+            return ((c & 0b11000000) != 0b10000000) + (c >= 0b11110000);
+        }
+
+        size_t utf16_length_from_utf8_scalar(const char* data, size_t length)
+        {
+            size_t result = 0;
+
+            for (size_t i = 0; i < length; i++) {
+                result += utf16_units_for_byte(data[i]);
+            }
+
+            return result;
+        }
+
+        size_t utf8_to_utf16_scalar(const char* data, size_t length, uint16_t* output)
+        {
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                // Fast path for runs of ASCII characters, checking 8 bytes at a time.
+                if (i + 8 <= length) {
+                    uint64_t word;
+                    memcpy(&word, data + i, sizeof(word));
+
+                    if ((word & 0x8080808080808080ULL) == 0) {
+                        for (size_t k = 0; k < 8; k++) {
+                            output[j + k] = (uint8_t)data[i + k];
+                        }
+
+                        i += 8;
+                        j += 8;
+                        continue;
+                    }
+                }
+
+                decode_utf8_sequence(data, length, i, output, j);
+            }
+
+            return j;
+        }
+
+        // Encodes a single UTF-16 code point (i.e. a single code unit or a surrogate pair) starting at data[i] as UTF-8,
+        // writing the result to output[j]. Both `i` and `j` are advanced past the consumed input and produced output,
+        // respectively.
+        inline void encode_utf16_sequence(const uint16_t* data, size_t length, size_t& i, char* output, size_t& j)
+        {
+            uint16_t c = data[i];
+
+            if (c < 0x80) {
+                output[j] = (char)c;
+                i++;
+                j++;
+            }
+            else if (c < 0x800) {
+                output[j] = (char)(0b11000000 | (c >> 6));
+                output[j + 1] = (char)(0b10000000 | (c & 0b00111111));
+                i++;
+                j += 2;
+            }
+            else if (c >= 0xD800 && c <= 0xDBFF) {
+                // High surrogate; must be followed by a low surrogate for this to be a valid surrogate pair.
+                if (i + 1 >= length || data[i + 1] < 0xDC00 || data[i + 1] > 0xDFFF) {
+                    throw std::invalid_argument("Invalid UTF-16 sequence encountered (high surrogate not followed by a low surrogate)");
+                }
+
+                uint32_t code_point = 0x10000 + ((c - 0xD800) << 10) + (data[i + 1] - 0xDC00);
+
+                output[j] = (char)(0b11110000 | (code_point >> 18));
+                output[j + 1] = (char)(0b10000000 | ((code_point >> 12) & 0b00111111));
+                output[j + 2] = (char)(0b10000000 | ((code_point >> 6) & 0b00111111));
+                output[j + 3] = (char)(0b10000000 | (code_point & 0b00111111));
+                i += 2;
+                j += 4;
+            }
+            else if (c >= 0xDC00 && c <= 0xDFFF) {
+                throw std::invalid_argument("Invalid UTF-16 sequence encountered (low surrogate not preceded by a high surrogate)");
+            }
+            else {
+                output[j] = (char)(0b11100000 | (c >> 12));
+                output[j + 1] = (char)(0b10000000 | ((c >> 6) & 0b00111111));
+                output[j + 2] = (char)(0b10000000 | (c & 0b00111111));
+                i++;
+                j += 3;
+            }
+        }
+
+        // Code points below 0x80 need one byte, below 0x800 two bytes and the rest of the BMP three bytes. Surrogate
+        // pairs need four bytes in total, i.e. two bytes per code unit.
+        inline size_t utf8_bytes_for_code_unit(uint16_t c)
+        {
+            return 1 + (c >= 0x80) + (c >= 0x800) - ((c & 0xF800) == 0xD800);
+        }
+
+        size_t utf8_length_from_utf16_scalar(const uint16_t* data, size_t length)
+        {
+            size_t result = 0;
+
+            for (size_t i = 0; i < length; i++) {
+                result += utf8_bytes_for_code_unit(data[i]);
+            }
+
+            return result;
+        }
+
+        size_t utf16_to_utf8_scalar(const uint16_t* data, size_t length, char* output)
+        {
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                // Fast path for runs of ASCII characters, checking 4 code units at a time.
+                if (i + 4 <= length) {
+                    uint64_t word;
+                    memcpy(&word, data + i, sizeof(word));
+
+                    if ((word & 0xFF80FF80FF80FF80ULL) == 0) {
+                        for (size_t k = 0; k < 4; k++) {
+                            output[j + k] = (char)data[i + k];
+                        }
+
+                        i += 4;
+                        j += 4;
+                        continue;
+                    }
+                }
+
+                encode_utf16_sequence(data, length, i, output, j);
+            }
+
+            return j;
+        }
+
+#ifdef PERLANG_X86_64
+        // The length counting kernels use the signed comparison trick: continuation bytes (0x80-0xBF) are exactly the
+        // bytes which are < -64 when interpreted as int8_t. The per-byte counts are accumulated in 8-bit lanes, which
+        // are periodically summed up using SAD (sum of absolute differences) before they have a chance to overflow.
+        // Each byte can contribute at most 2 per iteration, so 127 iterations is the maximum before overflow can occur.
+        constexpr size_t MAX_ITERATIONS_BEFORE_SAD = 127;
+
+        size_t utf16_length_from_utf8_sse2(const char* data, size_t length)
+        {
+            const __m128i continuation_limit = _mm_set1_epi8(-65);
+            const __m128i four_byte_leader = _mm_set1_epi8((char)0xF0);
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            size_t result = 0;
+
+            while (i + 16 <= length) {
+                __m128i counts = zero;
+
+                for (size_t n = 0; n < MAX_ITERATIONS_BEFORE_SAD && i + 16 <= length; n++, i += 16) {
+                    __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+                    __m128i non_continuation = _mm_cmpgt_epi8(v, continuation_limit);
+                    __m128i four_byte = _mm_cmpeq_epi8(_mm_max_epu8(v, four_byte_leader), v);
+
+                    // The comparisons produce -1 for matching bytes, hence the subtraction.
+                    counts = _mm_sub_epi8(counts, _mm_add_epi8(non_continuation, four_byte));
+                }
+
+                __m128i sums = _mm_sad_epu8(counts, zero);
+                result += _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+            }
+
+            return result + utf16_length_from_utf8_scalar(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t utf16_length_from_utf8_avx2(const char* data, size_t length)
+        {
+            const __m256i continuation_limit = _mm256_set1_epi8(-65);
+            const __m256i four_byte_leader = _mm256_set1_epi8((char)0xF0);
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t i = 0;
+            size_t result = 0;
+
+            while (i + 32 <= length) {
+                __m256i counts = zero;
+
+                for (size_t n = 0; n < MAX_ITERATIONS_BEFORE_SAD && i + 32 <= length; n++, i += 32) {
+                    __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+                    __m256i non_continuation = _mm256_cmpgt_epi8(v, continuation_limit);
+                    __m256i four_byte = _mm256_cmpeq_epi8(_mm256_max_epu8(v, four_byte_leader), v);
+
+                    counts = _mm256_sub_epi8(counts, _mm256_add_epi8(non_continuation, four_byte));
+                }
+
+                __m256i sums = _mm256_sad_epu8(counts, zero);
+                result += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                          _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+            }
+
+            return result + utf16_length_from_utf8_sse2(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX512
+        size_t utf16_length_from_utf8_avx512(const char* data, size_t length)
+        {
+            const __m512i continuation_limit = _mm512_set1_epi8(-65);
+            const __m512i four_byte_leader = _mm512_set1_epi8((char)0xF0);
+            const __m512i one = _mm512_set1_epi8(1);
+            const __m512i zero = _mm512_setzero_si512();
+
+            size_t i = 0;
+            size_t result = 0;
+
+            while (i + 64 <= length) {
+                __m512i counts = zero;
+
+                for (size_t n = 0; n < MAX_ITERATIONS_BEFORE_SAD && i + 64 <= length; n++, i += 64) {
+                    __m512i v = _mm512_loadu_si512(data + i);
+                    __mmask64 non_continuation = _mm512_cmpgt_epi8_mask(v, continuation_limit);
+                    __mmask64 four_byte = _mm512_cmpge_epu8_mask(v, four_byte_leader);
+
+                    counts = _mm512_mask_add_epi8(counts, non_continuation, counts, one);
+                    counts = _mm512_mask_add_epi8(counts, four_byte, counts, one);
+                }
+
+                // Extracting the 256-bit halves of the vector (like _mm512_reduce_add_epi64() does) triggers false
+                // -Wmaybe-uninitialized positives on some GCC versions, so we sum up the 64-bit lanes in memory instead.
+                uint64_t sums[8];
+                _mm512_storeu_si512(sums, _mm512_sad_epu8(counts, zero));
+
+                for (uint64_t sum : sums) {
+                    result += sum;
+                }
+            }
+
+            return result + utf16_length_from_utf8_avx2(data + i, length - i);
+        }
+
+        // The conversion kernels widen whole blocks of ASCII characters at once. When a block contains non-ASCII
+        // characters, the ASCII prefix of the block is copied and the first non-ASCII sequence is decoded using the
+        // scalar decoder, after which we try the fast path again.
+
+        size_t utf8_to_utf16_sse2(const char* data, size_t length, uint16_t* output)
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                if (i + 16 <= length) {
+                    __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+                    int mask = _mm_movemask_epi8(v);
+
+                    if (mask == 0) {
+                        _mm_storeu_si128((__m128i*)(output + j), _mm_unpacklo_epi8(v, zero));
+                        _mm_storeu_si128((__m128i*)(output + j + 8), _mm_unpackhi_epi8(v, zero));
+                        i += 16;
+                        j += 16;
+                        continue;
+                    }
+
+                    size_t ascii_prefix = __builtin_ctz(mask);
+
+                    for (size_t k = 0; k < ascii_prefix; k++) {
+                        output[j + k] = (uint8_t)data[i + k];
+                    }
+
+                    i += ascii_prefix;
+                    j += ascii_prefix;
+                }
+
+                decode_utf8_sequence(data, length, i, output, j);
+            }
+
+            return j;
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t utf8_to_utf16_avx2(const char* data, size_t length, uint16_t* output)
+        {
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                if (i + 32 <= length) {
+                    __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+                    auto mask = (uint32_t)_mm256_movemask_epi8(v);
+
+                    if (mask == 0) {
+                        _mm256_storeu_si256((__m256i*)(output + j), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+                        _mm256_storeu_si256((__m256i*)(output + j + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+                        i += 32;
+                        j += 32;
+                        continue;
+                    }
+
+                    size_t ascii_prefix = __builtin_ctz(mask);
+
+                    for (size_t k = 0; k < ascii_prefix; k++) {
+                        output[j + k] = (uint8_t)data[i + k];
+                    }
+
+                    i += ascii_prefix;
+                    j += ascii_prefix;
+                }
+
+                decode_utf8_sequence(data, length, i, output, j);
+            }
+
+            return j;
+        }
+
+        PERLANG_TARGET_AVX512
+        size_t utf8_to_utf16_avx512(const char* data, size_t length, uint16_t* output)
+        {
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                if (i + 64 <= length) {
+                    __m512i v = _mm512_loadu_si512(data + i);
+                    uint64_t mask = _mm512_movepi8_mask(v);
+
+                    if (mask == 0) {
+                        // Reloading the two halves is cheaper than it looks, since the data is already in the L1 cache.
+                        // It also avoids the 512-bit extract instructions, which trigger false -Wmaybe-uninitialized
+                        // positives on some GCC versions.
+                        _mm512_storeu_si512(output + j, _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(data + i))));
+                        _mm512_storeu_si512(output + j + 32, _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(data + i + 32))));
+                        i += 64;
+                        j += 64;
+                        continue;
+                    }
+
+                    size_t ascii_prefix = __builtin_ctzll(mask);
+
+                    for (size_t k = 0; k < ascii_prefix; k++) {
+                        output[j + k] = (uint8_t)data[i + k];
+                    }
+
+                    i += ascii_prefix;
+                    j += ascii_prefix;
+                }
+
+                decode_utf8_sequence(data, length, i, output, j);
+            }
+
+            return j;
+        }
+
+        // The UTF-16 length kernels compute utf8_bytes_for_code_unit() for a whole vector at a time, using bit masks
+        // since SSE2 lacks unsigned 16-bit comparisons. The counts are accumulated in 16-bit lanes, each of which can
+        // grow by at most 3 per iteration, and are summed up before they have a chance to overflow.
+        constexpr size_t MAX_UTF16_ITERATIONS_BEFORE_SUM = 8192;
+
+        size_t utf8_length_from_utf16_sse2(const uint16_t* data, size_t length)
+        {
+            const __m128i one_byte_limit = _mm_set1_epi16((short)0xFF80);
+            const __m128i two_byte_limit = _mm_set1_epi16((short)0xF800);
+            const __m128i surrogate = _mm_set1_epi16((short)0xD800);
+            const __m128i ones = _mm_set1_epi16(1);
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            size_t result = 0;
+
+            while (i + 8 <= length) {
+                __m128i counts = zero;
+
+                for (size_t n = 0; n < MAX_UTF16_ITERATIONS_BEFORE_SUM && i + 8 <= length; n++, i += 8) {
+                    __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+                    __m128i high_bits = _mm_and_si128(v, two_byte_limit);
+
+                    // The comparisons produce -1 for matching lanes. Lanes which are >= 0x80 and >= 0x800 need one extra
+                    // byte each (hence the subtraction), while surrogates need one byte less.
+                    __m128i one_byte = _mm_cmpeq_epi16(_mm_and_si128(v, one_byte_limit), zero);
+                    __m128i two_bytes = _mm_cmpeq_epi16(high_bits, zero);
+                    __m128i is_surrogate = _mm_cmpeq_epi16(high_bits, surrogate);
+
+                    counts = _mm_add_epi16(counts, _mm_set1_epi16(3));
+                    counts = _mm_add_epi16(counts, _mm_add_epi16(one_byte, _mm_add_epi16(two_bytes, is_surrogate)));
+                }
+
+                __m128i sums = _mm_madd_epi16(counts, ones);
+                sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+                sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+                result += (uint32_t)_mm_cvtsi128_si32(sums);
+            }
+
+            return result + utf8_length_from_utf16_scalar(data + i, length - i);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t utf8_length_from_utf16_avx2(const uint16_t* data, size_t length)
+        {
+            const __m256i one_byte_limit = _mm256_set1_epi16((short)0xFF80);
+            const __m256i two_byte_limit = _mm256_set1_epi16((short)0xF800);
+            const __m256i surrogate = _mm256_set1_epi16((short)0xD800);
+            const __m256i ones = _mm256_set1_epi16(1);
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t i = 0;
+            size_t result = 0;
+
+            while (i + 16 <= length) {
+                __m256i counts = zero;
+
+                for (size_t n = 0; n < MAX_UTF16_ITERATIONS_BEFORE_SUM && i + 16 <= length; n++, i += 16) {
+                    __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+                    __m256i high_bits = _mm256_and_si256(v, two_byte_limit);
+
+                    __m256i one_byte = _mm256_cmpeq_epi16(_mm256_and_si256(v, one_byte_limit), zero);
+                    __m256i two_bytes = _mm256_cmpeq_epi16(high_bits, zero);
+                    __m256i is_surrogate = _mm256_cmpeq_epi16(high_bits, surrogate);
+
+                    counts = _mm256_add_epi16(counts, _mm256_set1_epi16(3));
+                    counts = _mm256_add_epi16(counts, _mm256_add_epi16(one_byte, _mm256_add_epi16(two_bytes, is_surrogate)));
+                }
+
+                __m256i sums = _mm256_madd_epi16(counts, ones);
+                __m128i half_sums = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+                half_sums = _mm_add_epi32(half_sums, _mm_shuffle_epi32(half_sums, _MM_SHUFFLE(1, 0, 3, 2)));
+                half_sums = _mm_add_epi32(half_sums, _mm_shuffle_epi32(half_sums, _MM_SHUFFLE(2, 3, 0, 1)));
+                result += (uint32_t)_mm_cvtsi128_si32(half_sums);
+            }
+
+            return result + utf8_length_from_utf16_sse2(data + i, length - i);
+        }
+
+        // The UTF-16 to UTF-8 conversion kernels narrow whole blocks of ASCII code units at once. When a block contains
+        // non-ASCII code units, the whole block is encoded using the scalar encoder before we try the fast path again.
+
+        size_t utf16_to_utf8_sse2(const uint16_t* data, size_t length, char* output)
+        {
+            const __m128i non_ascii_bits = _mm_set1_epi16((short)0xFF80);
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i + 16 <= length) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 8));
+                __m128i non_ascii = _mm_and_si128(_mm_or_si128(a, b), non_ascii_bits);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) == 0xFFFF) {
+                    _mm_storeu_si128((__m128i*)(output + j), _mm_packus_epi16(a, b));
+                    i += 16;
+                    j += 16;
+                    continue;
+                }
+
+                // Note that a surrogate pair can make us go one step past the end of the block; this is fine.
+                size_t block_end = i + 16;
+
+                while (i < block_end) {
+                    encode_utf16_sequence(data, length, i, output, j);
+                }
+            }
+
+            return j + utf16_to_utf8_scalar(data + i, length - i, output + j);
+        }
+
+        PERLANG_TARGET_AVX2
+        size_t utf16_to_utf8_avx2(const uint16_t* data, size_t length, char* output)
+        {
+            const __m256i non_ascii_bits = _mm256_set1_epi16((short)0xFF80);
+
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i + 32 <= length) {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + 16));
+
+                if (_mm256_testz_si256(_mm256_or_si256(a, b), non_ascii_bits)) {
+                    // _mm256_packus_epi16() packs each 128-bit lane separately, so the 64-bit quarters must be
+                    // reordered afterwards to get the bytes in the right order.
+                    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+                    _mm256_storeu_si256((__m256i*)(output + j), packed);
+                    i += 32;
+                    j += 32;
+                    continue;
+                }
+
+                size_t block_end = i + 32;
+
+                while (i < block_end) {
+                    encode_utf16_sequence(data, length, i, output, j);
+                }
+            }
+
+            return j + utf16_to_utf8_sse2(data + i, length - i, output + j);
+        }
+#endif // PERLANG_X86_64
+
+        utf16_length_fn utf16_length_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                    return utf16_length_from_utf8_avx512;
+                case SimdLevel::avx2:
+                    return utf16_length_from_utf8_avx2;
+                case SimdLevel::sse2:
+                    return utf16_length_from_utf8_sse2;
+#endif
+                default:
+                    return utf16_length_from_utf8_scalar;
+            }
+        }
+
+        utf8_to_utf16_fn utf8_to_utf16_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                    return utf8_to_utf16_avx512;
+                case SimdLevel::avx2:
+                    return utf8_to_utf16_avx2;
+                case SimdLevel::sse2:
+                    return utf8_to_utf16_sse2;
+#endif
+                default:
+                    return utf8_to_utf16_scalar;
+            }
+        }
+
+        using utf8_length_fn = size_t (*)(const uint16_t*, size_t);
+        using utf16_to_utf8_fn = size_t (*)(const uint16_t*, size_t, char*);
+
+        // There are no AVX-512 specific kernels for this direction yet, since the AVX2 kernels are fast enough for the
+        // ASCII-heavy content we mostly deal with.
+        utf8_length_fn utf8_length_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return utf8_length_from_utf16_avx2;
+                case SimdLevel::sse2:
+                    return utf8_length_from_utf16_sse2;
+#endif
+                default:
+                    return utf8_length_from_utf16_scalar;
+            }
+        }
+
+        utf16_to_utf8_fn utf16_to_utf8_kernel_for(SimdLevel level)
+        {
+            switch (level) {
+#ifdef PERLANG_X86_64
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:
+                    return utf16_to_utf8_avx2;
+                case SimdLevel::sse2:
+                    return utf16_to_utf8_sse2;
+#endif
+                default:
+                    return utf16_to_utf8_scalar;
+            }
+        }
+    }
+
+    size_t utf16_length_from_utf8(const char* data, size_t length)
+    {
+        static const utf16_length_fn kernel = utf16_length_kernel_for(detected_simd_level());
+        return kernel(data, length);
+    }
+
+    size_t utf8_to_utf16(const char* data, size_t length, uint16_t* output)
+    {
+        static const utf8_to_utf16_fn kernel = utf8_to_utf16_kernel_for(detected_simd_level());
+        return kernel(data, length, output);
+    }
+
+    size_t utf16_length_from_utf8(const char* data, size_t length, SimdLevel level)
+    {
+        return utf16_length_kernel_for(level)(data, length);
+    }
+
+    size_t utf8_to_utf16(const char* data, size_t length, uint16_t* output, SimdLevel level)
+    {
+        return utf8_to_utf16_kernel_for(level)(data, length, output);
+    }
+
+    size_t utf8_length_from_utf16(const uint16_t* data, size_t length)
+    {
+        static const utf8_length_fn kernel = utf8_length_kernel_for(detected_simd_level());
+        return kernel(data, length);
+    }
+
+    size_t utf16_to_utf8(const uint16_t* data, size_t length, char* output)
+    {
+        static const utf16_to_utf8_fn kernel = utf16_to_utf8_kernel_for(detected_simd_level());
+        return kernel(data, length, output);
+    }
+
+    size_t utf8_length_from_utf16(const uint16_t* data, size_t length, SimdLevel level)
+    {
+        return utf8_length_kernel_for(level)(data, length);
+    }
+
+    size_t utf16_to_utf8(const uint16_t* data, size_t length, char* output, SimdLevel level)
+    {
+        return utf16_to_utf8_kernel_for(level)(data, length, output);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/cpu_features.h"
+
+namespace perlang::internal
+{
+    // Returns the number of UTF-16 code units needed to represent the given UTF-8 data. This does not validate the
+    // data; for valid UTF-8 the result is exact, and for invalid UTF-8 utf8_to_utf16() is guaranteed to throw before
+    // writing more code units than this.
+    [[nodiscard]]
+    size_t utf16_length_from_utf8(const char* data, size_t length);
+
+    // Converts the given UTF-8 data to UTF-16, writing the result to `output` (which must have room for at least
+    // utf16_length_from_utf8() code units). The data is validated during the conversion; invalid, truncated or
+    // overlong sequences cause a std::invalid_argument to be thrown. Returns the number of code units written.
+    size_t utf8_to_utf16(const char* data, size_t length, uint16_t* output);
+
+    // Returns the number of UTF-8 bytes needed to represent the given UTF-16 data. Like utf16_length_from_utf8(), this
+    // does not validate the data; utf16_to_utf8() throws before writing more bytes than this for invalid input.
+    [[nodiscard]]
+    size_t utf8_length_from_utf16(const uint16_t* data, size_t length);
+
+    // Converts the given UTF-16 data to UTF-8, writing the result to `output` (which must have room for at least
+    // utf8_length_from_utf16() bytes). Surrogate pairs are combined into four-byte sequences; unpaired surrogates
+    // cause a std::invalid_argument to be thrown. Returns the number of bytes written.
+    size_t utf16_to_utf8(const uint16_t* data, size_t length, char* output);
+
+    // Variants of the above which use the kernels for a particular SIMD level, regardless of the detected CPU
+    // capabilities. These are intended for tests and benchmarks. Calling them with a level which is not supported by
+    // the current CPU is undefined behavior; use detected_simd_level() to determine what is safe to use.
+    [[nodiscard]]
+    size_t utf16_length_from_utf8(const char* data, size_t length, SimdLevel level);
+
+    size_t utf8_to_utf16(const char* data, size_t length, uint16_t* output, SimdLevel level);
+
+    [[nodiscard]]
+    size_t utf8_length_from_utf16(const uint16_t* data, size_t length, SimdLevel level);
+
+    size_t utf16_to_utf8(const uint16_t* data, size_t length, char* output, SimdLevel level);
+}
@@ -10,7 +10,9 @@ namespace perlang::io
     [[nodiscard]]
     std::unique_ptr<String> File::read_all_text(const String& path)
     {
-        FILE *file = fopen(path.bytes(), "r");
+        // The path is not necessarily NUL-terminated, so we need to make a copy of it which is.
+        std::string path_string(path.bytes(), path.length());
+        FILE *file = fopen(path_string.c_str(), "r");
 
         if (file == nullptr) {
             // TODO: Should we throw an exception at this point?
@@ -33,7 +35,7 @@ namespace perlang::io
 
         if (buffer == nullptr) {
             fclose(file);
-            throw std::runtime_error("Failed to allocate memory when attempting to read file " + std::string(path.bytes()));
+            throw std::runtime_error("Failed to allocate memory when attempting to read file " + path_string);
         }
 
         size_t read = fread(buffer.get(), 1, length, file);
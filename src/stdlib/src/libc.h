@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstring>
 #include <memory> // std::shared_ptr
+#include <string>
 #include <unistd.h>
 
 #include "perlang_string.h"
@@ -79,7 +81,13 @@ namespace perlang
         {
             // from_static_string() could probably work, but I don't think the return value of getenv() is _guaranteed_
             // to be statically allocated, so making a copy is safer.
-            return perlang::UTF8String::from_static_string(::getenv(name->bytes()));
+            const char* value = ::getenv(std::string(name->bytes(), name->length()).c_str());
+
+            if (value == nullptr) {
+                return nullptr;
+            }
+
+            return perlang::UTF8String::make_shared_copy(value, strlen(value));
         }
 
         /// \brief Returns the process ID of the calling process.
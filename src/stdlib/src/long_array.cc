@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t LongArray::length() const
+    {
+        return length_;
+    }
+
     bool LongArray::contains(int64_t value) const
     {
         if (this == nullptr) {
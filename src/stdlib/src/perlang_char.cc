@@ -1,7 +1,7 @@
 #include <stdexcept>
-#include <cwctype>
 
 #include "perlang_char.h"
+#include "internal/case_mapping.h"
 
 std::unique_ptr<perlang::Char> perlang::Char::from(const char16_t literal)
 {
@@ -11,12 +11,14 @@ std::unique_ptr<perlang::Char> perlang::Char::from(const char16_t literal)
 
 char16_t perlang::Char::to_upper(char16_t literal)
 {
-    return std::towupper(literal);
+    // The mapping is table-driven rather than using std::towupper(), which goes through the locale machinery of the C
+    // library for each call. Characters in the BMP always map to other characters in the BMP.
+    return (char16_t)internal::to_upper(literal);
 }
 
 char16_t perlang::Char::to_lower(char16_t literal)
 {
-    return std::towlower(literal);
+    return (char16_t)internal::to_lower(literal);
 }
 
 std::shared_ptr<const perlang::String> perlang::Char::to_string() const
@@ -0,0 +1,20 @@
+#include "perlang_double.h"
+#include "internal/number_parsing.h"
+
+namespace perlang
+{
+    double Double::parse(const String& s)
+    {
+        return internal::parse_number<double>(s, "Double");
+    }
+
+    bool Double::try_parse(const String& s, double& result)
+    {
+        return internal::try_parse_number(s, result);
+    }
+
+    std::unique_ptr<DoubleArray> Double::parse_array(const String& s, char delimiter)
+    {
+        return internal::parse_number_array<double, DoubleArray>(s, delimiter, "Double");
+    }
+}
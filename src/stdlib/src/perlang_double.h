@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "double_array.h"
+#include "perlang_string.h"
+
+namespace perlang
+{
+    // Static methods for working with double-precision floating-point numbers (`double` in Perlang).
+    class Double
+    {
+     public:
+        // Parses `s` as a floating-point number in fixed or scientific notation (e.g. `1.5` or `-2e10`), with an
+        // optional leading `+` or `-` sign. `inf`, `infinity` and `nan` are also accepted, case-insensitively. Leading
+        // and trailing whitespace is not allowed. An std::invalid_argument exception is thrown if `s` is not a valid
+        // Double, and std::out_of_range if the value is too large to be represented as a double.
+        [[nodiscard]]
+        static double parse(const String& s);
+
+        // Like parse(), but returns false instead of throwing an exception if `s` cannot be parsed. `result` is only
+        // modified if the parsing succeeds.
+        [[nodiscard]]
+        static bool try_parse(const String& s, double& result);
+
+        // Parses `s` as a list of values separated by `delimiter`, like "1, 2, 3" or one value per line. Whitespace
+        // around the values is ignored, as is a trailing delimiter. Empty input gives an empty array. If any of the
+        // values cannot be parsed, an exception is thrown like in parse(), including the index of the failing value.
+        [[nodiscard]]
+        static std::unique_ptr<DoubleArray> parse_array(const String& s, char delimiter = ',');
+    };
+}
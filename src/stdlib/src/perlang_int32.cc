@@ -0,0 +1,20 @@
+#include "perlang_int32.h"
+#include "internal/number_parsing.h"
+
+namespace perlang
+{
+    int32_t Int32::parse(const String& s)
+    {
+        return internal::parse_number<int32_t>(s, "Int32");
+    }
+
+    bool Int32::try_parse(const String& s, int32_t& result)
+    {
+        return internal::try_parse_number(s, result);
+    }
+
+    std::unique_ptr<IntArray> Int32::parse_array(const String& s, char delimiter)
+    {
+        return internal::parse_number_array<int32_t, IntArray>(s, delimiter, "Int32");
+    }
+}
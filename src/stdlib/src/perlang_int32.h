@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "int_array.h"
+#include "perlang_string.h"
+
+namespace perlang
+{
+    // Static methods for working with 32-bit signed integers (`int` in Perlang).
+    class Int32
+    {
+     public:
+        // Parses `s` as a decimal integer, with an optional leading `+` or `-` sign. Leading and trailing whitespace is
+        // not allowed. An std::invalid_argument exception is thrown if `s` is not a valid Int32, and std::out_of_range
+        // if the value is outside the range of the type.
+        [[nodiscard]]
+        static int32_t parse(const String& s);
+
+        // Like parse(), but returns false instead of throwing an exception if `s` cannot be parsed. `result` is only
+        // modified if the parsing succeeds.
+        [[nodiscard]]
+        static bool try_parse(const String& s, int32_t& result);
+
+        // Parses `s` as a list of values separated by `delimiter`, like "1, 2, 3" or one value per line. Whitespace
+        // around the values is ignored, as is a trailing delimiter. Empty input gives an empty array. If any of the
+        // values cannot be parsed, an exception is thrown like in parse(), including the index of the failing value.
+        [[nodiscard]]
+        static std::unique_ptr<IntArray> parse_array(const String& s, char delimiter = ',');
+    };
+}
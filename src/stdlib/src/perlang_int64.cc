@@ -0,0 +1,20 @@
+#include "perlang_int64.h"
+#include "internal/number_parsing.h"
+
+namespace perlang
+{
+    int64_t Int64::parse(const String& s)
+    {
+        return internal::parse_number<int64_t>(s, "Int64");
+    }
+
+    bool Int64::try_parse(const String& s, int64_t& result)
+    {
+        return internal::try_parse_number(s, result);
+    }
+
+    std::unique_ptr<LongArray> Int64::parse_array(const String& s, char delimiter)
+    {
+        return internal::parse_number_array<int64_t, LongArray>(s, delimiter, "Int64");
+    }
+}
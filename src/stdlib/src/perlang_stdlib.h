@@ -24,10 +24,15 @@
 #include "long_range.h"
 #include "object_array.h"
 #include "perlang_char.h"
+#include "perlang_double.h"
+#include "perlang_int32.h"
+#include "perlang_int64.h"
 #include "perlang_string.h"
 #include "perlang_type.h"
 #include "perlang_value_types.h"
+#include "rope_string.h"
 #include "string_array.h"
+#include "string_slice.h"
 #include "uint_array.h"
 #include "uint_range.h"
 #include "ulong_array.h"
@@ -47,7 +52,9 @@
 
 #include "posix.h"
 
+#include "text/stream_writer.h"
 #include "text/string_builder.h"
+#include "text/text_writer.h"
 
 // TODO: Extract to separate header files instead of keeping it in a single file
 
@@ -62,6 +69,10 @@ namespace perlang
         };
     }
 
+    // The print() overloads write to a buffer owned by the standard library (one per thread) instead of writing to the
+    // C stdio `stdout` stream directly, which avoids taking the stdio lock for each call. The buffer is flushed when it
+    // is full, at the end of each line when stdout is a terminal, when the thread or program exits and when flush() is
+    // called.
     void print();
 
     // C++ doesn't seem to have the kind of covariance we intend for Perlang. This means that we have to define these
@@ -114,6 +125,9 @@ namespace perlang
     // https://gitlab.perlang.org/perlang/perlang/-/issues/251
     void print(std::shared_ptr<PerlangType> type);
 
+    // Writes all content buffered by the print() overloads on the current thread to stdout, and flushes stdout itself.
+    void flush();
+
     // TODO: We would like to enable this, but it breaks with EnumTests since they expect to be able to implicitly
     // TODO: convert enum values to int32_t.
     // Ensure that print() is never called with any other argument than the ones explicitly defined above.
@@ -1,15 +1,587 @@
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
 #include "perlang_stdlib.h"
 #include "perlang_string.h"
+#include "internal/ascii.h"
+#include "internal/case_mapping.h"
+#include "internal/hashing.h"
+#include "internal/string_comparison.h"
+#include "internal/string_search.h"
+#include "internal/string_utils.h"
 
 namespace perlang
 {
+    namespace
+    {
+        // Calls `func` with `value`, converted to the same family of encodings as `haystack` if necessary. ASCII and
+        // UTF-8 content can be searched without conversion, since ASCII is a subset of UTF-8; only UTF-16 differs.
+        template <typename Func>
+        auto with_compatible_encoding(const String& haystack, const String& value, Func&& func)
+        {
+            bool haystack_is_utf16 = haystack.encoding() == StringEncoding::utf16;
+
+            if (haystack_is_utf16 == (value.encoding() == StringEncoding::utf16)) {
+                return func(value);
+            }
+            else if (haystack_is_utf16) {
+                return func(*value.as_utf16());
+            }
+            else {
+                return func(*value.as_utf8());
+            }
+        }
+
+        // Returns the content of compact UTF16String instances (see UTF16String::is_compact()), or null for all other
+        // strings. Non-compact strings always contain at least one character outside of the Latin-1 range, so they are
+        // never equal to (or contained in) a compact string.
+        const char* latin1_of(const String& s)
+        {
+            return s.encoding() == StringEncoding::utf16 ? static_cast<const UTF16String&>(s).latin1_bytes() : nullptr;
+        }
+
+        // Returns the UTF-16 code units of a string with UTF-16 encoding. Compact strings are widened into `buffer`,
+        // instead of calling bytes() which would keep the widened copy around for the rest of the lifetime of the
+        // string.
+        const uint16_t* code_units_of(const String& s, std::vector<uint16_t>& buffer)
+        {
+            if (const char* latin1 = latin1_of(s)) {
+                // +1 for the NUL terminator, so that the pointer is valid even for empty strings.
+                buffer.resize(s.length() + 1);
+                std::copy_n(reinterpret_cast<const uint8_t*>(latin1), s.length(), buffer.begin());
+
+                return buffer.data();
+            }
+
+            return reinterpret_cast<const uint16_t*>(s.bytes());
+        }
+
+        size_t code_unit_size(const String& s)
+        {
+            return s.encoding() == StringEncoding::utf16 ? sizeof(uint16_t) : 1;
+        }
+
+        // Searches for `needle` in `haystack`, starting at `start`. The strings must have compatible encodings (see
+        // with_compatible_encoding()). Returns the index relative to the start of `haystack`, or NOT_FOUND.
+        size_t find_from(const String& haystack, const String& needle, size_t start)
+        {
+            const char* haystack_latin1 = latin1_of(haystack);
+            const char* needle_latin1 = latin1_of(needle);
+            size_t result;
+
+            if (haystack_latin1 != nullptr && needle_latin1 != nullptr) {
+                result = internal::find(haystack_latin1 + start, haystack.length() - start, needle_latin1, needle.length());
+            }
+            else if (haystack_latin1 != nullptr) {
+                result = internal::NOT_FOUND;
+            }
+            else if (haystack.encoding() == StringEncoding::utf16) {
+                std::vector<uint16_t> needle_buffer;
+                const uint16_t* haystack_units = reinterpret_cast<const uint16_t*>(haystack.bytes());
+
+                result = internal::find(haystack_units + start, haystack.length() - start, code_units_of(needle, needle_buffer), needle.length());
+            }
+            else {
+                result = internal::find(haystack.bytes() + start, haystack.length() - start, needle.bytes(), needle.length());
+            }
+
+            return result == internal::NOT_FOUND ? internal::NOT_FOUND : start + result;
+        }
+
+        // Returns true if `other` occurs in `s` at `position`, which the caller must make sure is within bounds. The
+        // strings must have compatible encodings (see with_compatible_encoding()).
+        bool matches_at(const String& s, size_t position, const String& other)
+        {
+            const char* latin1 = latin1_of(s);
+            const char* other_latin1 = latin1_of(other);
+            size_t length = other.length();
+
+            if (s.encoding() != StringEncoding::utf16) {
+                return memcmp(s.bytes() + position, other.bytes(), length) == 0;
+            }
+            else if (latin1 != nullptr) {
+                return other_latin1 != nullptr && memcmp(latin1 + position, other_latin1, length) == 0;
+            }
+
+            const uint16_t* code_units = reinterpret_cast<const uint16_t*>(s.bytes()) + position;
+
+            if (other_latin1 != nullptr) {
+                return internal::mismatch_ascii_utf16(other_latin1, code_units, length) == length;
+            }
+
+            return memcmp(code_units, other.bytes(), length * sizeof(uint16_t)) == 0;
+        }
+
+        bool is_ascii_whitespace(uint16_t c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        // Encodes a code point as UTF-8, returning the number of bytes written.
+        size_t encode_utf8(char32_t code_point, char* output)
+        {
+            if (code_point < 0x80) {
+                output[0] = (char)code_point;
+                return 1;
+            }
+            else if (code_point < 0x800) {
+                output[0] = (char)(0xC0 | (code_point >> 6));
+                output[1] = (char)(0x80 | (code_point & 0x3F));
+                return 2;
+            }
+            else if (code_point < 0x10000) {
+                output[0] = (char)(0xE0 | (code_point >> 12));
+                output[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+                output[2] = (char)(0x80 | (code_point & 0x3F));
+                return 3;
+            }
+            else {
+                output[0] = (char)(0xF0 | (code_point >> 18));
+                output[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+                output[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+                output[3] = (char)(0x80 | (code_point & 0x3F));
+                return 4;
+            }
+        }
+
+        // The implementation of String::to_upper() and String::to_lower(). A template, so that the case mapping
+        // functions can be inlined into the loops.
+        template <bool Upper>
+        std::unique_ptr<String> change_case(const String& s)
+        {
+            auto convert_ascii = [](const char* data, size_t length, char* output) {
+                if constexpr (Upper) {
+                    internal::ascii_to_upper(data, length, output);
+                }
+                else {
+                    internal::ascii_to_lower(data, length, output);
+                }
+            };
+
+            auto map = [](char32_t code_point) {
+                return Upper ? internal::to_upper(code_point) : internal::to_lower(code_point);
+            };
+
+            size_t length = s.length();
+
+            if (s.encoding() == StringEncoding::utf16) {
+                std::vector<uint16_t> buffer;
+                const uint16_t* code_units = code_units_of(s, buffer);
+
+                // +1 for the NUL terminator, like in UTF16String::from_copied_string().
+                std::vector<uint16_t> result(length + 1);
+
+                for (size_t i = 0; i < length; i++) {
+                    uint16_t unit = code_units[i];
+
+                    // Characters outside of the BMP only map to other characters outside of the BMP, so a surrogate pair
+                    // is always replaced by another one. Unpaired surrogates have no case, and are kept as-is.
+                    if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < length && code_units[i + 1] >= 0xDC00 && code_units[i + 1] <= 0xDFFF) {
+                        char32_t mapped = map(0x10000 + ((char32_t)(unit - 0xD800) << 10) + (code_units[i + 1] - 0xDC00)) - 0x10000;
+
+                        result[i] = (uint16_t)(0xD800 + (mapped >> 10));
+                        result[i + 1] = (uint16_t)(0xDC00 + (mapped & 0x3FF));
+                        i++;
+                    }
+                    else {
+                        result[i] = (uint16_t)map(unit);
+                    }
+                }
+
+                return UTF16String::from_owned_string(std::move(result));
+            }
+
+            const char* data = s.bytes();
+
+            if (s.encoding() == StringEncoding::ascii || const_cast<String&>(s).is_ascii()) {
+                char* buffer;
+                std::unique_ptr<String> result;
+
+                if (s.encoding() == StringEncoding::ascii) {
+                    result = ASCIIString::allocate(length, buffer);
+                }
+                else {
+                    result = UTF8String::allocate(length, buffer);
+                }
+
+                convert_ascii(data, length, buffer);
+                return result;
+            }
+
+            // The UTF-8 length of a character can change when it is mapped, by at most one byte for a two-byte sequence
+            // (e.g. U+0250 LATIN SMALL LETTER TURNED A, which maps to U+2C6F). The result is therefore at most 50%
+            // longer than the original.
+            auto buffer = std::unique_ptr<char[]>(new char[length + length / 2 + 1]);
+            size_t i = 0;
+            size_t j = 0;
+
+            while (i < length) {
+                auto byte = (uint8_t)data[i];
+
+                if (byte < 0x80) {
+                    uint64_t word = 0;
+
+                    // Text in most languages using the Latin script has short runs of ASCII characters between the
+                    // non-ASCII ones, so the vectorized conversion is only used when at least 8 ASCII characters follow.
+                    if (length - i >= sizeof(word)) {
+                        memcpy(&word, data + i, sizeof(word));
+                    }
+
+                    if (length - i >= sizeof(word) && (word & 0x8080808080808080ULL) == 0) {
+                        size_t ascii_length = internal::find_non_ascii(data + i, length - i);
+
+                        convert_ascii(data + i, ascii_length, buffer.get() + j);
+                        i += ascii_length;
+                        j += ascii_length;
+                    }
+                    else {
+                        do {
+                            buffer[j++] = (char)map(byte);
+                            i++;
+                        }
+                        while (i < length && (byte = (uint8_t)data[i]) < 0x80);
+                    }
+
+                    continue;
+                }
+
+                // Two-byte sequences (covering e.g. the Latin, Greek and Cyrillic scripts) are decoded inline.
+                if (byte >= 0xC2 && byte <= 0xDF && i + 1 < length && ((uint8_t)data[i + 1] & 0xC0) == 0x80) {
+                    j += encode_utf8(map(((char32_t)(byte & 0x1F) << 6) | ((uint8_t)data[i + 1] & 0x3F)), buffer.get() + j);
+                    i += 2;
+                    continue;
+                }
+
+                size_t sequence_length;
+                char32_t code_point = UTF8String::CodePointIterator::decode(data + i, data + length, sequence_length);
+
+                // Invalid sequences decode to U+FFFD with a length of 1 (a valid U+FFFD is three bytes long). They are
+                // kept as-is, just like the rest of the string is when converting it.
+                if (sequence_length == 1) {
+                    buffer[j++] = data[i++];
+                    continue;
+                }
+
+                j += encode_utf8(map(code_point), buffer.get() + j);
+                i += sequence_length;
+            }
+
+            buffer[j] = '\0';
+
+            return UTF8String::from_owned_string(buffer.release(), j);
+        }
+
+        // Returns true if concat_shared() can copy the content of `lhs` into a flat result, i.e. if `lhs` is neither a
+        // rope nor a UTF-16 string (which operator+ concatenates into ropes).
+        bool is_flat_utf8(const String& lhs)
+        {
+            const std::type_info& type = typeid(lhs);
+
+            if (lhs.encoding() == StringEncoding::utf16) {
+                return false;
+            }
+
+            return type == typeid(ASCIIString) || type == typeid(UTF8String) || type == typeid(StringSlice);
+        }
+
+        // Concatenates `lhs` with UTF-8 content, choosing the same result type as operator+ does: UTF8String left-hand
+        // sides always produce UTF8String results, while the other string types stay ASCII if both sides are.
+        std::shared_ptr<String> concat_shared_flat(const String& lhs, const char* rhs, size_t rhs_length, bool rhs_is_ascii)
+        {
+            size_t length = lhs.length() + rhs_length;
+            bool ascii = rhs_is_ascii && typeid(lhs) != typeid(UTF8String) && const_cast<String&>(lhs).is_ascii();
+            char* bytes;
+            std::shared_ptr<String> result;
+
+            if (ascii) {
+                result = ASCIIString::allocate_shared(length, bytes);
+            }
+            else {
+                result = UTF8String::allocate_shared(length, bytes);
+            }
+
+            memcpy(bytes, lhs.bytes(), lhs.length());
+            memcpy(bytes + lhs.length(), rhs, rhs_length);
+
+            return result;
+        }
+
+        template <typename T>
+        std::shared_ptr<String> concat_shared_number(const String& lhs, T rhs)
+        {
+            if (!is_flat_utf8(lhs)) {
+                return lhs + rhs;
+            }
+
+            internal::FormattedNumber number(rhs);
+            return concat_shared_flat(lhs, number.data(), number.length(), true);
+        }
+    }
+
+    int64_t String::index_of(const String& value, size_t start) const
+    {
+        if (start > length_) {
+            throw std::out_of_range("Start index " + std::to_string(start) + " is out-of-bounds for a string with length " + std::to_string(length_));
+        }
+
+        size_t result = with_compatible_encoding(*this, value, [&](const String& needle) {
+            return find_from(*this, needle, start);
+        });
+
+        return result == internal::NOT_FOUND ? -1 : static_cast<int64_t>(result);
+    }
+
+    int64_t String::last_index_of(const String& value) const
+    {
+        size_t result = with_compatible_encoding(*this, value, [&](const String& needle) {
+            const char* latin1 = latin1_of(*this);
+            const char* needle_latin1 = latin1_of(needle);
+
+            if (latin1 != nullptr && needle_latin1 != nullptr) {
+                return internal::rfind(latin1, length_, needle_latin1, needle.length());
+            }
+            else if (latin1 != nullptr) {
+                return internal::NOT_FOUND;
+            }
+            else if (encoding_ == StringEncoding::utf16) {
+                std::vector<uint16_t> needle_buffer;
+                const uint16_t* code_units = reinterpret_cast<const uint16_t*>(bytes());
+
+                return internal::rfind(code_units, length_, code_units_of(needle, needle_buffer), needle.length());
+            }
+            else {
+                return internal::rfind(bytes(), length_, needle.bytes(), needle.length());
+            }
+        });
+
+        return result == internal::NOT_FOUND ? -1 : static_cast<int64_t>(result);
+    }
+
+    bool String::contains(const String& value) const
+    {
+        return index_of(value) >= 0;
+    }
+
+    bool String::starts_with(const String& value) const
+    {
+        return with_compatible_encoding(*this, value, [&](const String& prefix) {
+            return prefix.length() <= length_ && matches_at(*this, 0, prefix);
+        });
+    }
+
+    bool String::ends_with(const String& value) const
+    {
+        return with_compatible_encoding(*this, value, [&](const String& suffix) {
+            return suffix.length() <= length_ && matches_at(*this, length_ - suffix.length(), suffix);
+        });
+    }
+
+    std::unique_ptr<StringArray> String::split(const String& separator) const
+    {
+        if (separator.length() == 0) {
+            throw std::invalid_argument("The separator cannot be empty");
+        }
+
+        std::vector<std::shared_ptr<const String>> parts;
+
+        with_compatible_encoding(*this, separator, [&](const String& needle) {
+            size_t position = 0;
+
+            while (true) {
+                size_t index = find_from(*this, needle, position);
+                size_t end = index == internal::NOT_FOUND ? length_ : index;
+
+                parts.emplace_back(substring(position, end - position));
+
+                if (index == internal::NOT_FOUND) {
+                    break;
+                }
+
+                position = end + needle.length();
+            }
+        });
+
+        return std::make_unique<StringArray>(std::move(parts));
+    }
+
+    std::unique_ptr<String> String::replace(const String& old_value, const String& new_value) const
+    {
+        if (old_value.length() == 0) {
+            throw std::invalid_argument("The value to replace cannot be empty");
+        }
+
+        return with_compatible_encoding(*this, old_value, [&](const String& needle) {
+            return with_compatible_encoding(*this, new_value, [&](const String& replacement) -> std::unique_ptr<String> {
+                // The occurrences are located up front, so that the result can be allocated with the right size.
+                std::vector<size_t> occurrences;
+
+                for (size_t index = find_from(*this, needle, 0); index != internal::NOT_FOUND; index = find_from(*this, needle, index + needle.length())) {
+                    occurrences.push_back(index);
+                }
+
+                if (occurrences.empty()) {
+                    return substring(0, length_);
+                }
+
+                // Compact strings stay compact, as long as the replacement is compact too. Otherwise, the result is
+                // built from the UTF-16 code units of both strings.
+                const char* latin1 = latin1_of(*this);
+                const char* replacement_latin1 = latin1_of(replacement);
+                bool compact = latin1 != nullptr && replacement_latin1 != nullptr;
+
+                size_t unit_size = compact ? 1 : code_unit_size(*this);
+                size_t result_length = length_ + occurrences.size() * replacement.length() - occurrences.size() * needle.length();
+
+                std::unique_ptr<String> result;
+                char* buffer;
+                const char* source;
+                const char* replacement_data;
+                std::vector<uint16_t> code_units;
+                std::vector<uint16_t> source_buffer;
+                std::vector<uint16_t> replacement_buffer;
+
+                if (compact) {
+                    result = UTF16String::allocate_latin1(result_length, buffer);
+                    source = latin1;
+                    replacement_data = replacement_latin1;
+                }
+                else if (encoding_ == StringEncoding::utf16) {
+                    // +1 for the NUL terminator, like in UTF16String::from_copied_string().
+                    code_units.resize(result_length + 1);
+                    buffer = reinterpret_cast<char*>(code_units.data());
+                    source = reinterpret_cast<const char*>(code_units_of(*this, source_buffer));
+                    replacement_data = reinterpret_cast<const char*>(code_units_of(replacement, replacement_buffer));
+                }
+                else {
+                    if (encoding_ == StringEncoding::ascii && const_cast<String&>(replacement).is_ascii()) {
+                        result = ASCIIString::allocate(result_length, buffer);
+                    }
+                    else {
+                        result = UTF8String::allocate(result_length, buffer);
+                    }
+
+                    source = bytes();
+                    replacement_data = replacement.bytes();
+                }
+
+                size_t source_position = 0;
+
+                for (size_t index : occurrences) {
+                    size_t preceding = (index - source_position) * unit_size;
+
+                    memcpy(buffer, source + source_position * unit_size, preceding);
+                    memcpy(buffer + preceding, replacement_data, replacement.length() * unit_size);
+
+                    buffer += preceding + replacement.length() * unit_size;
+                    source_position = index + needle.length();
+                }
+
+                memcpy(buffer, source + source_position * unit_size, (length_ - source_position) * unit_size);
+
+                if (encoding_ == StringEncoding::utf16 && !compact) {
+                    result = UTF16String::from_owned_string(std::move(code_units));
+                }
+
+                return result;
+            });
+        });
+    }
+
+    std::unique_ptr<String> String::trim() const
+    {
+        size_t first = 0;
+        size_t last = length_;
+
+        const char* latin1 = latin1_of(*this);
+
+        if (encoding_ == StringEncoding::utf16 && latin1 == nullptr) {
+            const uint16_t* code_units = reinterpret_cast<const uint16_t*>(bytes());
+
+            while (first < last && is_ascii_whitespace(code_units[first])) {
+                first++;
+            }
+
+            while (last > first && is_ascii_whitespace(code_units[last - 1])) {
+                last--;
+            }
+        }
+        else {
+            const char* data = latin1 != nullptr ? latin1 : bytes();
+
+            while (first < last && is_ascii_whitespace(static_cast<unsigned char>(data[first]))) {
+                first++;
+            }
+
+            while (last > first && is_ascii_whitespace(static_cast<unsigned char>(data[last - 1]))) {
+                last--;
+            }
+        }
+
+        return substring(first, last - first);
+    }
+
+    std::unique_ptr<String> String::to_upper() const
+    {
+        return change_case<true>(*this);
+    }
+
+    std::unique_ptr<String> String::to_lower() const
+    {
+        return change_case<false>(*this);
+    }
+
     std::shared_ptr<const String> String::to_string() const
     {
         return shared_from_this();
     }
 
+    uint64_t String::hash() const
+    {
+        uint64_t result = hash_.load(std::memory_order_relaxed);
+
+        if (result == 0) {
+            result = compute_hash();
+            hash_.store(result, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    uint64_t String::hash_of(const char* data, size_t length)
+    {
+        uint64_t result = internal::hash_bytes(data, length);
+
+        // 0 is reserved for "not calculated yet" in hash(), so a real hash code of 0 is replaced with 1 instead. This
+        // makes the distribution very slightly less uniform, but it is not a problem in practice.
+        return result != 0 ? result : 1;
+    }
+
+    bool String::content_equals(const char* data, size_t length) const
+    {
+        if (const char* latin1 = latin1_of(*this)) {
+            return internal::equals_utf8_latin1(data, length, latin1, length_);
+        }
+        else if (encoding_ == StringEncoding::utf16) {
+            return internal::equals_utf8_utf16(data, length, reinterpret_cast<const uint16_t*>(bytes()), length_);
+        }
+
+        return length_ == length && memcmp(bytes(), data, length) == 0;
+    }
+
+    const char* String::materialize_bytes() const
+    {
+        return nullptr;
+    }
+
+    uint64_t String::compute_hash() const
+    {
+        return hash_of(bytes(), length());
+    }
+
     // Would be nice to inline this, but it's hard because of forward declaration of UTF8String in perlang_string.h and
     // circular dependencies. We'll have to live with this until we can reimplement it in Perlang... :)
     bool String::operator==(UTF8String& rhs)
@@ -19,90 +591,110 @@ namespace perlang
 
     bool String::operator==(String* rhs)
     {
-        auto* utf8_lhs = dynamic_cast<UTF8String*>(this);
-        auto* utf8_rhs = dynamic_cast<UTF8String*>(rhs);
+        bool lhs_is_utf16 = encoding_ == StringEncoding::utf16;
 
-        const auto* ascii_lhs = dynamic_cast<const ASCIIString*>(this);
-        const auto* ascii_rhs = dynamic_cast<ASCIIString*>(rhs);
+        // Comparing UTF-16 content with content of the other encodings is done without converting either side.
+        if (lhs_is_utf16 != (rhs->encoding_ == StringEncoding::utf16)) {
+            const String& utf16 = lhs_is_utf16 ? *this : *rhs;
+            const String& other = lhs_is_utf16 ? *rhs : *this;
 
-        if (utf8_lhs != nullptr && utf8_rhs != nullptr) {
-            // If the length differs, there's no way the strings can match.
-            if (utf8_lhs->length() != utf8_rhs->length()) {
-                return false;
+            if (const char* latin1 = latin1_of(utf16)) {
+                // ASCII content can only have the same bytes as Latin-1 content which is ASCII-only too, so there is no
+                // need to check that separately.
+                if (other.encoding_ == StringEncoding::ascii) {
+                    return other.length_ == utf16.length_ && memcmp(other.bytes(), latin1, utf16.length_) == 0;
+                }
+
+                return internal::equals_utf8_latin1(other.bytes(), other.length_, latin1, utf16.length_);
             }
 
-            // Pointing at the same backing byte array means the strings are equal.
-            if (utf8_lhs->bytes() == utf8_rhs->bytes()) {
-                return true;
+            const uint16_t* code_units = reinterpret_cast<const uint16_t*>(utf16.bytes());
+
+            if (other.encoding_ == StringEncoding::ascii) {
+                return other.length_ == utf16.length_ &&
+                    internal::mismatch_ascii_utf16(other.bytes(), code_units, utf16.length_) == utf16.length_;
             }
 
-            // memcmp() is an unsafe operation, but since we have verified that both strings have the expected length,
-            // we should be on the safe side by now. The types have been validated to both be UTF8String, so comparing
-            // the backing byte buffers are guaranteed to work.
-            return memcmp(utf8_lhs->bytes(), utf8_rhs->bytes(), length()) == 0;
+            return internal::equals_utf8_utf16(other.bytes(), other.length_, code_units, utf16.length_);
         }
-        else if (ascii_lhs != nullptr && ascii_rhs != nullptr)
-        {
-            // If the length differs, there's no way the strings can match.
-            if (ascii_lhs->length() != ascii_rhs->length()) {
-                return false;
-            }
 
-            // Pointing at the same backing byte array means the strings are equal.
-            if (ascii_lhs->bytes() == ascii_rhs->bytes()) {
-                return true;
-            }
+        // If the length differs, there's no way the strings can match.
+        if (length_ != rhs->length_) {
+            return false;
+        }
+
+        // A compact UTF-16 string can only equal another compact one, and is compared without widening it.
+        const char* lhs_latin1 = latin1_of(*this);
+        const char* rhs_latin1 = latin1_of(*rhs);
 
-            // memcmp() is an unsafe operation, but since we have verified that both strings have the expected length,
-            // we should be on the safe side by now. The types have been validated to both be UTF8String, so comparing
-            // the backing byte buffers are guaranteed to work.
-            return memcmp(ascii_lhs->bytes(), ascii_rhs->bytes(), length()) == 0;
+        if (lhs_latin1 != nullptr || rhs_latin1 != nullptr) {
+            return lhs_latin1 != nullptr && rhs_latin1 != nullptr && memcmp(lhs_latin1, rhs_latin1, length_) == 0;
         }
-        else if (ascii_lhs != nullptr && utf8_rhs != nullptr) {
-            // If the UTF8 string contains one or more non-ASCII characters, it's logically impossible for the strings
-            // to match.
-            if (!utf8_rhs->is_ascii()) {
-                return false;
-            }
 
-            // Also, if the length differs, there's no way the strings can match.
-            if (ascii_lhs->length() != utf8_rhs->length()) {
-                return false;
-            }
+        // Note that ropes are flattened here, if they haven't been already.
+        const char* lhs_bytes = bytes();
+        const char* rhs_bytes = rhs->bytes();
 
-            // Pointing at the same backing byte array means the strings are equal.
-            if (ascii_lhs->bytes() == utf8_rhs->bytes()) {
-                return true;
-            }
+        // Pointing at the same backing byte array means the strings are equal.
+        if (lhs_bytes == rhs_bytes) {
+            return true;
+        }
 
-            // memcmp() is an unsafe operation, but since we have verified that both strings have the expected length,
-            // we should be on the safe side by now. Both of the types have been validated to contain ASCII-only
-            // content, so comparing the backing byte buffers are guaranteed to work.
-            return memcmp(ascii_lhs->bytes(), utf8_rhs->bytes(), length()) == 0;
+        // ASCII and UTF-8 content can be compared byte by byte, regardless of the type of the strings; ASCII content
+        // is valid UTF-8. A UTF-8 string containing non-ASCII characters can never have the same bytes as an ASCII
+        // string. We must make sure to use a NUL-safe method here, since UTF-8 strings can contain NUL characters.
+        size_t byte_length = encoding_ == StringEncoding::utf16 ? length_ * sizeof(uint16_t) : length_;
+
+        return memcmp(lhs_bytes, rhs_bytes, byte_length) == 0;
+    }
+
+    int String::compare(const String& other) const
+    {
+        bool lhs_is_utf16 = encoding_ == StringEncoding::utf16;
+        bool rhs_is_utf16 = other.encoding_ == StringEncoding::utf16;
+
+        if (!lhs_is_utf16 && !rhs_is_utf16) {
+            return internal::compare_utf8(bytes(), length_, other.bytes(), other.length_);
         }
-        else if (utf8_lhs != nullptr && ascii_rhs != nullptr) {
-            // Identical to the previous branch, but it's the left-hand side that is a UTF8String instead of the
-            // right-hand side.
-            if (!utf8_lhs->is_ascii()) {
-                return false;
-            }
 
-            if (utf8_lhs->length() != ascii_rhs->length()) {
-                return false;
-            }
+        const char* lhs_latin1 = latin1_of(*this);
+        const char* rhs_latin1 = latin1_of(other);
 
-            if (utf8_lhs->bytes() == ascii_rhs->bytes()) {
-                return true;
+        // The bytes of Latin-1 content are ordered by code point, just like the bytes of UTF-8 content. Latin-1 content
+        // is compared with UTF-16 code units by widening it on the fly.
+        if (lhs_is_utf16 && rhs_is_utf16) {
+            if (lhs_latin1 != nullptr && rhs_latin1 != nullptr) {
+                return internal::compare_utf8(lhs_latin1, length_, rhs_latin1, other.length_);
+            }
+            else if (lhs_latin1 != nullptr) {
+                return internal::compare_ascii_utf16(lhs_latin1, length_, reinterpret_cast<const uint16_t*>(other.bytes()), other.length_);
             }
+            else if (rhs_latin1 != nullptr) {
+                return -internal::compare_ascii_utf16(rhs_latin1, other.length_, reinterpret_cast<const uint16_t*>(bytes()), length_);
+            }
+
+            return internal::compare_utf16(reinterpret_cast<const uint16_t*>(bytes()), length_, reinterpret_cast<const uint16_t*>(other.bytes()), other.length_);
+        }
+
+        const String& utf16 = lhs_is_utf16 ? *this : other;
+        const String& non_utf16 = lhs_is_utf16 ? other : *this;
+        const char* latin1 = lhs_is_utf16 ? lhs_latin1 : rhs_latin1;
+        int result;
 
-            return memcmp(utf8_lhs->bytes(), ascii_rhs->bytes(), length()) == 0;
+        if (latin1 != nullptr && non_utf16.encoding_ == StringEncoding::ascii) {
+            result = internal::compare_utf8(non_utf16.bytes(), non_utf16.length_, latin1, utf16.length_);
+        }
+        else if (latin1 != nullptr) {
+            result = internal::compare_utf8_latin1(non_utf16.bytes(), non_utf16.length_, latin1, utf16.length_);
+        }
+        else if (non_utf16.encoding_ == StringEncoding::ascii) {
+            result = internal::compare_ascii_utf16(non_utf16.bytes(), non_utf16.length_, reinterpret_cast<const uint16_t*>(utf16.bytes()), utf16.length_);
         }
         else {
-            // The strings are of different types => consider them unequal. In the future, we want to support
-            // "ASCII-only" strings stored in UTF8String instances (i.e. UTF8Strings with only 7-bit content), and
-            // compare them semantically, regardless of whether the types exactly match or not.
-            return false;
+            result = internal::compare_utf8_utf16(non_utf16.bytes(), non_utf16.length_, reinterpret_cast<const uint16_t*>(utf16.bytes()), utf16.length_);
         }
+
+        return lhs_is_utf16 ? -result : result;
     }
 
     bool String::operator!=(const String& rhs)
@@ -124,4 +716,44 @@ namespace perlang
     {
         return !(*this == rhs);
     }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, const String& rhs)
+    {
+        // Long results are ropes, which operator+ creates (see RopeString::THRESHOLD).
+        if (!is_flat_utf8(lhs) || rhs.encoding() == StringEncoding::utf16 || lhs.length() + rhs.length() >= RopeString::THRESHOLD) {
+            return lhs + const_cast<String&>(rhs);
+        }
+
+        return concat_shared_flat(lhs, rhs.bytes(), rhs.length(), const_cast<String&>(rhs).is_ascii());
+    }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, int64_t rhs)
+    {
+        return concat_shared_number(lhs, rhs);
+    }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, uint64_t rhs)
+    {
+        return concat_shared_number(lhs, rhs);
+    }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, float rhs)
+    {
+        return concat_shared_number(lhs, rhs);
+    }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, double rhs)
+    {
+        return concat_shared_number(lhs, rhs);
+    }
+
+    std::shared_ptr<String> concat_shared(const String& lhs, const BigInt& rhs)
+    {
+        if (!is_flat_utf8(lhs)) {
+            return lhs + rhs;
+        }
+
+        std::string str = rhs.to_string();
+        return concat_shared_flat(lhs, str.c_str(), str.length(), true);
+    }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory> // std::unique_ptr, std::enable_shared_from_this
 
 #include "object.h"
@@ -10,12 +12,28 @@ class BigInt;
 namespace perlang
 {
     class ASCIIString;
+    class StringArray;
     class UTF8String;
     class UTF16String;
 
+    // The encoding of the content of a String, as returned by String::encoding(). Strings with `utf8` encoding may
+    // still contain ASCII-only content; use String::is_ascii() to determine this.
+    enum class StringEncoding : uint8_t
+    {
+        ascii,
+        utf8,
+        utf16
+    };
+
     // Abstract base class for all String types in Perlang
     class String : public Object, public std::enable_shared_from_this<String>
     {
+     protected:
+        explicit String(StringEncoding encoding)
+            : encoding_(encoding)
+        {
+        }
+
      public:
         // TODO: Make this "internal" somehow. It should never be called from (Perlang) user code.
         // TODO: Return const uint8_t * instead
@@ -23,16 +41,37 @@ namespace perlang
         // Returns the backing byte array for this String. This method is generally to be avoided; it is safer to use
         // the String throughout the code and only call this when you really must. If you call it, you
         // **MUST MUST MUST** not modify the data in any way, or use it beyond the lifetime of the String object.
+        //
+        // Note that the data is not necessarily NUL-terminated (StringSlice content isn't); use length() to determine
+        // where it ends.
+        //
+        // This is a plain field access for all strings except ropes (which need to be flattened on the first call), so
+        // it can be inlined in tight loops.
         [[nodiscard]]
-        virtual const char* bytes() const = 0;
+        const char* bytes() const
+        {
+            return data_ != nullptr ? data_ : materialize_bytes();
+        }
 
         // Returns the backing byte array, and releases ownership of it. The caller is now responsible for freeing the
         // memory.
         virtual std::unique_ptr<const char[]> release_bytes() = 0;
 
-        // The length of the string in bytes, excluding the terminating `NUL` character.
+        // The length of the string in bytes (or UTF-16 code units, for UTF16String), excluding the terminating `NUL`
+        // character.
         [[nodiscard]]
-        virtual size_t length() const = 0;
+        size_t length() const
+        {
+            return length_;
+        }
+
+        // Returns the encoding of the content of this string. This can be used instead of dynamic_cast<>() for
+        // determining how the bytes() should be interpreted.
+        [[nodiscard]]
+        StringEncoding encoding() const
+        {
+            return encoding_;
+        }
 
         // Determines if the string is ASCII-safe or not. Multiple subsequent calls to this method may return a cached
         // result from a previous run. The first call may use a pre-calculated value, but this is not guaranteed by
@@ -51,8 +90,86 @@ namespace perlang
         [[nodiscard]]
         virtual std::unique_ptr<UTF16String> as_utf16() const = 0;
 
+        // Returns a UTF8String representation of the current string. For ASCII and UTF-8 strings, this is a copy of the
+        // underlying bytes. For UTF-16 strings, the content is transcoded, throwing an exception if the string contains
+        // unpaired surrogates.
+        [[nodiscard]]
+        virtual std::unique_ptr<UTF8String> as_utf8() const = 0;
+
+        // Returns `length` bytes of this string (or code units, for UTF-16 strings), starting at `start`. For strings
+        // owned by a `std::shared_ptr`, the result is typically a StringSlice, sharing the content with this string
+        // instead of copying it. An std::out_of_range exception is thrown if the range is not within the string.
+        [[nodiscard]]
+        virtual std::unique_ptr<String> substring(size_t start, size_t length) const = 0;
+
+        // Returns the index of the first occurrence of `value` in this string, starting the search at `start`, or -1 if
+        // it is not found. Like all other indices, these are in bytes (or UTF-16 code units, for UTF-16 strings). An
+        // empty `value` is found at `start`. An std::out_of_range exception is thrown if `start` is beyond the end of
+        // the string. `value` does not need to have the same encoding as this string, neither here nor in the methods
+        // below; it is transcoded if necessary.
+        [[nodiscard]]
+        int64_t index_of(const String& value, size_t start = 0) const;
+
+        // Returns the index of the last occurrence of `value` in this string, or -1 if it is not found. An empty
+        // `value` is found at length().
+        [[nodiscard]]
+        int64_t last_index_of(const String& value) const;
+
+        // Returns true if `value` occurs anywhere in this string.
+        [[nodiscard]]
+        bool contains(const String& value) const;
+
+        [[nodiscard]]
+        bool starts_with(const String& value) const;
+
+        [[nodiscard]]
+        bool ends_with(const String& value) const;
+
+        // Splits this string into the parts separated by `separator`. Adjacent separators, or separators at the start
+        // or end of the string, produce empty parts. The parts are substring() of this string, so they typically share
+        // its content rather than copying it. An std::invalid_argument exception is thrown if `separator` is empty.
+        [[nodiscard]]
+        std::unique_ptr<StringArray> split(const String& separator) const;
+
+        // Returns a copy of this string with all occurrences of `old_value` replaced by `new_value`. The result is an
+        // ASCIIString if both this string and `new_value` are ASCII strings. An std::invalid_argument exception is
+        // thrown if `old_value` is empty.
+        [[nodiscard]]
+        std::unique_ptr<String> replace(const String& old_value, const String& new_value) const;
+
+        // Returns this string with all leading and trailing ASCII whitespace removed.
+        [[nodiscard]]
+        std::unique_ptr<String> trim() const;
+
+        // Returns a copy of this string with all characters converted to uppercase, using the Unicode simple case
+        // mappings. The conversion is independent of the current locale. Each character is mapped to exactly one
+        // character, so e.g. 'ß' is left as-is. ASCII content is converted using vectorized code; the result has the
+        // same encoding as this string.
+        [[nodiscard]]
+        virtual std::unique_ptr<String> to_upper() const;
+
+        // Returns a copy of this string with all characters converted to lowercase. See to_upper() for details.
+        [[nodiscard]]
+        virtual std::unique_ptr<String> to_lower() const;
+
         std::shared_ptr<const String> to_string() const override;
 
+        // Returns a 64-bit hash code for the content of this string. Strings which compare equal have the same hash
+        // code, regardless of their type. Since strings are immutable, the hash code is only calculated on the first
+        // call; subsequent calls return the cached value.
+        [[nodiscard]]
+        uint64_t hash() const;
+
+        // Returns the hash code an ASCIIString or UTF8String with the given content has. Useful for looking up strings
+        // in hash-based collections without having to create a String instance for the key.
+        [[nodiscard]]
+        static uint64_t hash_of(const char* data, size_t length);
+
+        // Returns true if the content of this string equals the given UTF-8 content, regardless of the encoding of
+        // this string. Like hash_of(), this is useful for comparing strings to keys without creating String instances.
+        [[nodiscard]]
+        bool content_equals(const char* data, size_t length) const;
+
         // Concatenate this string with another string. The memory for the new string is allocated from the heap.
         [[nodiscard]]
         virtual std::unique_ptr<String> operator+(String& rhs) const = 0;
@@ -135,5 +252,80 @@ namespace perlang
         // Compares this string to another string, returning true if they are not equal.
         [[nodiscard]]
         bool operator!=(String* rhs);
+
+        // Compares this string to another string by Unicode code point, returning a negative value if this string
+        // sorts before `other`, zero if they are equal and a positive value otherwise. The order is the same regardless
+        // of how the strings are encoded, and no converted copy of either string is created.
+        [[nodiscard]]
+        int compare(const String& other) const;
+
+     protected:
+        // Called by bytes() for strings whose content is not (yet) available as a contiguous buffer, i.e. when `data_`
+        // is null. The default implementation returns null.
+        [[nodiscard]]
+        virtual const char* materialize_bytes() const;
+
+        // Calculates the hash code returned by hash(). The default implementation hashes the bytes() of the string.
+        // Overrides must use hash_of() to calculate the result, since it makes sure that it is never 0.
+        [[nodiscard]]
+        virtual uint64_t compute_hash() const;
+
+        // The content of the string, or null if it has not been materialized (see materialize_bytes()). Set by the
+        // constructors of the subclasses, and never modified after the string has been handed out to other code.
+        const char* data_ = nullptr;
+
+        // The length of the string in bytes (or UTF-16 code units, for UTF16String).
+        size_t length_ = 0;
+
+        const StringEncoding encoding_;
+
+     private:
+        // The cached hash code, or 0 if it has not been calculated yet. Atomic since multiple threads may call hash()
+        // simultaneously; they all calculate the same value, so it doesn't matter which one of them stores it.
+        mutable std::atomic<uint64_t> hash_ { 0 };
     };
+
+    // The concat_shared() functions concatenate like operator+ and produce a string of the same type, but return it
+    // owned by a `std::shared_ptr`. For flat (non-rope) results, the control block, the string object and its content
+    // are placed in a single heap allocation; converting the result of operator+ to a `std::shared_ptr` would require
+    // three. Ropes and UTF-16 strings are concatenated using operator+, since their content is not a single UTF-8
+    // buffer.
+
+    // Concatenates two strings. See operator+ for the type of the resulting string.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, const String& rhs);
+
+    // Concatenates a string with an int64.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, int64_t rhs);
+
+    // Concatenates a string with a uint64.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, uint64_t rhs);
+
+    // Concatenates a string with a float.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, float rhs);
+
+    // Concatenates a string with a double.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, double rhs);
+
+    // Concatenates a string with a BigInt.
+    [[nodiscard]]
+    std::shared_ptr<String> concat_shared(const String& lhs, const BigInt& rhs);
+
+    // Concatenates a string with an int32.
+    [[nodiscard]]
+    inline std::shared_ptr<String> concat_shared(const String& lhs, int32_t rhs)
+    {
+        return concat_shared(lhs, static_cast<int64_t>(rhs));
+    }
+
+    // Concatenates a string with a uint32.
+    [[nodiscard]]
+    inline std::shared_ptr<String> concat_shared(const String& lhs, uint32_t rhs)
+    {
+        return concat_shared(lhs, static_cast<uint64_t>(rhs));
+    }
 }
@@ -1,29 +1,55 @@
 #include <stdio.h>
-#include <codecvt>
-
-// fmt is an open-source formatting library providing a fast and safe alternative to C stdio and C++ iostreams.
-// https://github.com/fmtlib/fmt
-#define FMT_HEADER_ONLY
-#include "fmt/format.h"
+#include <unistd.h>
 
 #include "ascii_string.h"
 #include "bigint.h"
 #include "object.h"
 #include "perlang_stdlib.h"
 #include "perlang_type.h"
-#include "internal/string_utils.h"
+#include "text/stream_writer.h"
 
 namespace perlang
 {
-    // Global constant in an anonymous namespace, to avoid polluting the public API
+    // Globals and helpers in an anonymous namespace, to avoid polluting the public API
     namespace
     {
         const std::shared_ptr<const String> null_string = ASCIIString::from_static_string("null");
+
+        // Interactive output must be shown line by line, while output redirected to a file or pipe is best written in
+        // large chunks.
+        const bool stdout_is_terminal = isatty(fileno(stdout));
+
+        // Returns the buffer which print() writes to. Each thread has its own buffer, so that printing never needs any
+        // locking. The StreamWriter flushes the buffer when the thread exits, which for the main thread happens when
+        // the program exits (before the C library flushes its own stdout buffer).
+        text::StreamWriter& stdout_writer()
+        {
+            thread_local text::StreamWriter writer(stdout);
+            return writer;
+        }
+
+        void end_line(text::StreamWriter& writer)
+        {
+            writer.append_line();
+
+            if (stdout_is_terminal) {
+                writer.flush();
+            }
+        }
+
+        // Formats the value directly into the buffer, followed by a newline.
+        template <typename T>
+        void print_line(const T& value)
+        {
+            text::StreamWriter& writer = stdout_writer();
+            writer.append(value);
+            end_line(writer);
+        }
     }
 
     void print()
     {
-        puts("");
+        end_line(stdout_writer());
     }
 
     void print(const Object* obj)
@@ -37,32 +63,23 @@ namespace perlang
 
         // Safeguard against both `str` and `str->bytes()` potentially returning `null`
         if (bytes == nullptr) {
-            puts("null");
+            print_line("null");
         }
         else {
-            // For C-style (NUL-terminated, char*) strings, there's no need to use the overhead which `printf` induces.
-            // `puts` can potentially be a tiny bit faster.
-            puts(bytes);
+            // The content is not necessarily NUL-terminated (for StringSlice instances), so the length must be given.
+            text::StreamWriter& writer = stdout_writer();
+            writer.append(bytes, str->length());
+            end_line(writer);
         }
     }
 
     void print(const UTF16String* str)
     {
-        const char* bytes = str != nullptr ? str->bytes() : nullptr;
-
-        // Safeguard against both `str` and `str->bytes()` potentially returning `null`
-        if (bytes == nullptr) {
-            puts("null");
+        if (str == nullptr) {
+            print_line("null");
         }
         else {
-            auto data = (char16_t*)bytes;
-
-            // wstring_convert is deprecated in C++17 and removed in C++20, but should be fine for now. Once we have an
-            // as_utf8() method in UTF16String, we can use that instead.
-            std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> convert;
-            std::string utf8 = convert.to_bytes(data);
-
-            puts(utf8.c_str());
+            print_line(*str->as_utf8());
         }
     }
 
@@ -173,75 +190,61 @@ namespace perlang
 
     void print(bool b)
     {
-        if (b) {
-            puts("true");
-        }
-        else {
-            puts("false");
-        }
+        print_line(b);
     }
 
     void print(char c)
     {
-        printf("%c\n", c);
+        print_line(c);
     }
 
     void print(char16_t c)
     {
-        wprintf(L"%lc\n", c);
+        print_line(c);
     }
 
     void print(int32_t i)
     {
-        printf("%d\n", i);
+        print_line(i);
     }
 
     void print(uint32_t u)
     {
-        printf("%u\n", u);
+        print_line(u);
     }
 
     void print(int64_t i)
     {
-        // The parameter type is defined slightly differently on different platforms, forcing us to do this
-        // conditionally.
-#ifdef __OpenBSD__
-        printf("%lld\n", i);
-#else
-        printf("%ld\n", i);
-#endif
+        print_line(i);
     }
 
     void print(uint64_t u)
     {
-        // The parameter type is defined slightly differently on different platforms, forcing us to do this
-        // conditionally.
-#ifdef __OpenBSD__
-        printf("%llu\n", u);
-#else
-        printf("%lu\n", u);
-#endif
+        print_line(u);
     }
 
     void print(const BigInt& bigint)
     {
-        puts(bigint.to_string().c_str());
+        print_line(bigint);
     }
 
     void print(float f)
     {
-        const std::string& str = internal::float_to_string(f) + "\n";
-        fwrite(str.c_str(), str.length(), 1, stdout);
+        print_line(f);
     }
 
     void print(double d)
     {
-        const std::string& str = internal::double_to_string(d) + "\n";
-        fwrite(str.c_str(), str.length(), 1, stdout);
+        print_line(d);
     }
 
     void print(std::shared_ptr<perlang::PerlangType> type)
     {
         print(type->get_name());
     }
+
+    void flush()
+    {
+        stdout_writer().flush();
+    }
 }
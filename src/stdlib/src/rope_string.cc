@@ -0,0 +1,199 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ascii_string.h"
+#include "bigint.h"
+#include "rope_string.h"
+#include "string_slice.h"
+#include "utf8_string.h"
+#include "utf16_string.h"
+#include "internal/string_utils.h"
+
+namespace perlang
+{
+    std::unique_ptr<RopeString> RopeString::concat(const String& lhs, const String& rhs)
+    {
+        return std::unique_ptr<RopeString>(new RopeString(share(lhs), share(rhs)));
+    }
+
+    std::shared_ptr<const String> RopeString::share(const String& s)
+    {
+        // UTF16String content cannot be concatenated byte-wise with the other string types, so it must be converted.
+        if (s.encoding() == StringEncoding::utf16) {
+            return s.as_utf8();
+        }
+
+        // Strings are immutable, so a string owned by a shared_ptr can safely be referenced for as long as we need it.
+        if (auto shared = s.weak_from_this().lock()) {
+            return shared;
+        }
+
+        // A RopeString not owned by a shared_ptr is typically an intermediate result in a chained concatenation. Its
+        // parts can be shared even though the rope itself cannot, which is what keeps the chain linear.
+        if (auto rope = dynamic_cast<const RopeString*>(&s)) {
+            return std::shared_ptr<const String>(new RopeString(rope->left_, rope->right_));
+        }
+
+        // Anything else might be a temporary, so we have no choice but to copy it.
+        return UTF8String::from_copied_string(s.bytes(), s.length());
+    }
+
+    RopeString::RopeString(std::shared_ptr<const String> left, std::shared_ptr<const String> right)
+        // is_ascii() is non-const since it can cache its result, but it doesn't modify the content of the string.
+        : String(const_cast<String&>(*left).is_ascii() && const_cast<String&>(*right).is_ascii() ? StringEncoding::ascii : StringEncoding::utf8)
+    {
+        // `data_` is deliberately left null, so that bytes() calls materialize_bytes() which flattens the rope.
+        length_ = left->length() + right->length();
+
+        left_ = std::move(left);
+        right_ = std::move(right);
+    }
+
+    RopeString::~RopeString()
+    {
+        // Ropes built in loops can be extremely deep. Destroying them recursively (which is what would happen with the
+        // default destructor) could overflow the stack, so we detach the parts of all ropes which are exclusively
+        // owned by this one, and destroy them one by one instead.
+        auto is_exclusively_owned_rope = [](const std::shared_ptr<const String>& node) {
+            return node.use_count() == 1 && dynamic_cast<const RopeString*>(node.get()) != nullptr;
+        };
+
+        // Fast path for the common case, where the parts are shared with other strings (or not ropes at all).
+        if (!is_exclusively_owned_rope(left_) && !is_exclusively_owned_rope(right_)) {
+            return;
+        }
+
+        std::vector<std::shared_ptr<const String>> pending;
+        pending.push_back(std::move(left_));
+        pending.push_back(std::move(right_));
+
+        while (!pending.empty()) {
+            std::shared_ptr<const String> node = std::move(pending.back());
+            pending.pop_back();
+
+            if (node.use_count() == 1) {
+                if (auto rope = const_cast<RopeString*>(dynamic_cast<const RopeString*>(node.get()))) {
+                    pending.push_back(std::move(rope->left_));
+                    pending.push_back(std::move(rope->right_));
+                }
+            }
+        }
+    }
+
+    const String& RopeString::flattened() const
+    {
+        std::call_once(flatten_once_, [this] {
+            char* buffer;
+
+            if (encoding() == StringEncoding::ascii) {
+                flattened_ = ASCIIString::allocate(length_, buffer);
+            }
+            else {
+                flattened_ = UTF8String::allocate(length_, buffer);
+            }
+
+            // Walk the tree iteratively (left to right), for the same reason as in the destructor.
+            std::vector<const String*> pending = { right_.get(), left_.get() };
+            size_t position = 0;
+
+            while (!pending.empty()) {
+                const String* node = pending.back();
+                pending.pop_back();
+
+                if (auto rope = dynamic_cast<const RopeString*>(node)) {
+                    pending.push_back(rope->right_.get());
+                    pending.push_back(rope->left_.get());
+                }
+                else {
+                    memcpy(buffer + position, node->bytes(), node->length());
+                    position += node->length();
+                }
+            }
+        });
+
+        return *flattened_;
+    }
+
+    const char* RopeString::materialize_bytes() const
+    {
+        return flattened().bytes();
+    }
+
+    std::unique_ptr<const char[]> RopeString::release_bytes()
+    {
+        // The flattened string might already have been handed out via bytes(), so we cannot release its buffer.
+        char* result = new char[length_ + 1];
+        memcpy(result, bytes(), length_ + 1);
+
+        return std::unique_ptr<const char[]>(result);
+    }
+
+    std::unique_ptr<String> RopeString::get_type() const
+    {
+        return ASCIIString::from_static_string(encoding() == StringEncoding::ascii ? "perlang.ASCIIString" : "perlang.UTF8String");
+    }
+
+    std::unique_ptr<ASCIIString> RopeString::as_ascii() const
+    {
+        return flattened().as_ascii();
+    }
+
+    std::unique_ptr<UTF16String> RopeString::as_utf16() const
+    {
+        return flattened().as_utf16();
+    }
+
+    std::unique_ptr<UTF8String> RopeString::as_utf8() const
+    {
+        return flattened().as_utf8();
+    }
+
+    std::unique_ptr<String> RopeString::substring(size_t start, size_t length) const
+    {
+        // The slice refers to the flattened content, which lives for as long as the rope itself.
+        return StringSlice::of(*this, start, length, encoding() == StringEncoding::ascii ? std::optional<bool>(true) : std::nullopt);
+    }
+
+    std::unique_ptr<String> RopeString::operator+(String& rhs) const
+    {
+        return concat(*this, rhs);
+    }
+
+    std::unique_ptr<String> RopeString::operator+(int64_t rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> RopeString::operator+(uint64_t rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> RopeString::operator+(float rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> RopeString::operator+(double rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> RopeString::operator+(const BigInt& rhs) const
+    {
+        std::string str = rhs.to_string();
+        return concat_ascii(str.c_str(), str.length());
+    }
+
+    std::unique_ptr<String> RopeString::concat_ascii(const char* rhs, size_t rhs_length) const
+    {
+        std::shared_ptr<const String> rhs_string = ASCIIString::make_shared_copy(rhs, rhs_length);
+
+        return std::unique_ptr<RopeString>(new RopeString(share(*this), std::move(rhs_string)));
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "perlang_string.h"
+
+namespace perlang
+{
+    // A string representing the concatenation of two other strings, without copying their content until it is actually
+    // needed. The `left` and `right` parts can themselves be RopeStrings, which makes it possible to build long strings
+    // in chained `a + b + c + ...` expressions in linear time. Without this, every step in the chain would have to copy
+    // the full string built so far, making it quadratic in the number of parts.
+    //
+    // The content is flattened to a contiguous buffer the first time bytes() (or any other method needing the actual
+    // content) is called. RopeStrings are never created directly; operator+ on the other string classes returns them
+    // when the result is at least THRESHOLD bytes long.
+    class RopeString : public String
+    {
+     public:
+        // The minimum length of concatenation results which are represented as RopeStrings. Shorter strings are cheap
+        // enough to copy that the extra bookkeeping of a rope doesn't pay off.
+        static constexpr size_t THRESHOLD = 256;
+
+        // Creates a new RopeString representing the concatenation of `lhs` and `rhs`. Strings owned by a
+        // `std::shared_ptr` (as well as the parts of other RopeStrings) are referenced without copying them; other
+        // strings are presumed to be temporary and are copied. UTF16String content is converted to UTF-8.
+        [[nodiscard]]
+        static std::unique_ptr<RopeString> concat(const String& lhs, const String& rhs);
+
+     private:
+        RopeString(std::shared_ptr<const String> left, std::shared_ptr<const String> right);
+
+     public:
+        ~RopeString() override;
+
+        // Returns a copy of the flattened content. The caller is responsible for freeing the memory.
+        std::unique_ptr<const char[]> release_bytes() override;
+
+        // Determines if the string is ASCII-safe or not. This is calculated from the parts when the rope is created, so
+        // it never requires the rope to be flattened.
+        [[nodiscard]]
+        bool is_ascii() override
+        {
+            return encoding() == StringEncoding::ascii;
+        }
+
+        // Ropes are an implementation detail, so the type of the flattened string is returned here.
+        [[nodiscard]]
+        std::unique_ptr<String> get_type() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<ASCIIString> as_ascii() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<UTF16String> as_utf16() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<UTF8String> as_utf8() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<String> substring(size_t start, size_t length) const override;
+
+        // Returns the flattened representation of this string, which is either an ASCIIString or a UTF8String. The
+        // result is cached, so the flattening only happens once per rope. Note that `data_` is never set for ropes,
+        // since other threads might be reading it while the rope is being flattened.
+        [[nodiscard]]
+        const String& flattened() const;
+
+        // Workaround false -Werror=overloaded-virtual positives
+        using String::operator+;
+
+        // Concatenates this string with another string. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(String& rhs) const override;
+
+        // Concatenates this string with an int64. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(int64_t rhs) const override;
+
+        // Concatenates this string with a uint64. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(uint64_t rhs) const override;
+
+        // Concatenates this string with a float. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(float rhs) const override;
+
+        // Concatenates this string with a double. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(double rhs) const override;
+
+        // Concatenates this string with a BigInt. The result is always a RopeString.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(const BigInt& rhs) const override;
+
+     protected:
+        // Returns the content of the flattened string, flattening the rope on the first call.
+        [[nodiscard]]
+        const char* materialize_bytes() const override;
+
+     private:
+        // Returns a reference to `s` which can be kept in a rope, beyond the lifetime of the `s` object itself.
+        static std::shared_ptr<const String> share(const String& s);
+
+        // Concatenates this string with the given ASCII content.
+        [[nodiscard]]
+        std::unique_ptr<String> concat_ascii(const char* rhs, size_t rhs_length) const;
+
+        // The two halves of the string. These are either RopeStrings or "flat" (ASCIIString or UTF8String) strings.
+        std::shared_ptr<const String> left_;
+        std::shared_ptr<const String> right_;
+
+        // The flattened content, created on demand. Guarded by `flatten_once_` since multiple threads may call bytes()
+        // simultaneously, and the result must not be replaced once it has been handed out.
+        mutable std::unique_ptr<String> flattened_;
+        mutable std::once_flag flatten_once_;
+    };
+}
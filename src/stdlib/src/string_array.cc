@@ -23,6 +23,20 @@ namespace perlang
         owned_ = true;
     }
 
+    StringArray::StringArray(std::vector<std::shared_ptr<const perlang::String>>&& arr)
+    {
+        size_t length = arr.size();
+        auto new_arr = new std::shared_ptr<const perlang::String>[length];
+
+        for (size_t i = 0; i < length; i++) {
+            new_arr[i] = std::move(arr[i]);
+        }
+
+        arr_ = new_arr;
+        length_ = length;
+        owned_ = true;
+    }
+
     StringArray::~StringArray()
     {
         if (owned_) {
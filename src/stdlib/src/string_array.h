@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <initializer_list>
+#include <vector>
 
 #include "perlang_string.h"
 
@@ -16,6 +17,9 @@ namespace perlang
         // deallocated when it's no longer needed.
         StringArray(std::initializer_list<std::shared_ptr<const perlang::String>> arr);
 
+        // Creates a new StringArray from a vector of strings, moving the elements into the array.
+        explicit StringArray(std::vector<std::shared_ptr<const perlang::String>>&& arr);
+
         // TODO: Support array constructor with fixed size (see IntArrayTests for relevant tests that can be copied)
 
         ~StringArray();
@@ -0,0 +1,233 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
+#include "ascii_string.h"
+#include "bigint.h"
+#include "rope_string.h"
+#include "string_slice.h"
+#include "utf8_string.h"
+#include "utf16_string.h"
+#include "internal/ascii.h"
+#include "internal/string_utils.h"
+
+namespace perlang
+{
+    namespace
+    {
+        // Returns true if `c` is a continuation byte in a multi-byte UTF-8 sequence, i.e. not the start of a character.
+        bool is_utf8_continuation_byte(char c)
+        {
+            return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+        }
+    }
+
+    std::unique_ptr<String> StringSlice::of(const String& parent, size_t start, size_t length, std::optional<bool> is_ascii)
+    {
+        size_t parent_length = parent.length();
+
+        if (start > parent_length || length > parent_length - start) {
+            throw std::out_of_range(fmt::format("Range {0}..{1} is out-of-bounds for a string with length {2}", start, start + length, parent_length));
+        }
+
+        const char* data = parent.bytes() + start;
+
+        if (is_ascii != true) {
+            // The byte following the slice is always readable, since it's either part of the parent or its NUL
+            // terminator (or a byte within the parent's parent, for slices).
+            if ((start < parent_length && is_utf8_continuation_byte(data[0])) ||
+                (start + length < parent_length && is_utf8_continuation_byte(data[length]))) {
+                throw std::invalid_argument(fmt::format("Range {0}..{1} splits a multi-byte UTF-8 sequence", start, start + length));
+            }
+        }
+
+        // Short substrings are copied, since they fit in the inline buffer of a new string. This is cheaper than the
+        // reference counting needed for sharing the parent, and avoids keeping a potentially large parent string alive
+        // just for the sake of a few bytes.
+        if (length <= UTF8String::INLINE_CAPACITY) {
+            return copy(data, length, is_ascii);
+        }
+
+        // Slices of slices refer to the original parent directly, so that long chains of slices never need to be
+        // traversed.
+        if (typeid(parent) == typeid(StringSlice)) {
+            const auto& slice = static_cast<const StringSlice&>(parent);
+            return std::unique_ptr<String>(new StringSlice(slice.parent_, data, length, is_ascii));
+        }
+
+        if (auto shared = parent.weak_from_this().lock()) {
+            return std::unique_ptr<String>(new StringSlice(std::move(shared), data, length, is_ascii));
+        }
+
+        // The parent might be a temporary, so we have no choice but to copy it.
+        return copy(data, length, is_ascii);
+    }
+
+    std::unique_ptr<String> StringSlice::copy(const char* data, size_t length, std::optional<bool> is_ascii)
+    {
+        char* buffer;
+        std::unique_ptr<String> result;
+
+        if (is_ascii == true) {
+            result = ASCIIString::allocate(length, buffer);
+        }
+        else {
+            result = UTF8String::allocate(length, buffer);
+        }
+
+        memcpy(buffer, data, length);
+
+        return result;
+    }
+
+    StringSlice::StringSlice(std::shared_ptr<const String> parent, const char* data, size_t length, std::optional<bool> is_ascii)
+        : String(parent->encoding()),
+          parent_(std::move(parent)),
+          is_ascii_(is_ascii)
+    {
+        data_ = data;
+        length_ = length;
+    }
+
+    std::unique_ptr<const char[]> StringSlice::release_bytes()
+    {
+        // The content belongs to the parent string, so it cannot be released.
+        char* result = new char[length_ + 1];
+        memcpy(result, data_, length_);
+        result[length_] = '\0';
+
+        return std::unique_ptr<const char[]>(result);
+    }
+
+    bool StringSlice::is_ascii()
+    {
+        // Like in UTF8String::is_ascii(), the potential data race here is harmless.
+        if (!is_ascii_.has_value()) {
+            is_ascii_ = internal::is_ascii(data_, length_);
+        }
+
+        return *is_ascii_;
+    }
+
+    std::unique_ptr<String> StringSlice::get_type() const
+    {
+        return parent_->get_type();
+    }
+
+    std::unique_ptr<ASCIIString> StringSlice::as_ascii() const
+    {
+        if (is_ascii_ != true) {
+            size_t non_ascii_index = internal::find_non_ascii(data_, length_);
+
+            if (non_ascii_index != length_) {
+                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(non_ascii_index) + ". This string cannot be converted to ASCIIString.");
+            }
+        }
+
+        // ASCIIString and UTF8String content must be NUL-terminated, so the content of the parent can only be shared
+        // when the slice extends to its end.
+        if (data_[length_] == '\0') {
+            return ASCIIString::from_shared_content(parent_, data_, length_);
+        }
+
+        char* buffer;
+        auto result = ASCIIString::allocate(length_, buffer);
+        memcpy(buffer, data_, length_);
+
+        return result;
+    }
+
+    std::unique_ptr<UTF16String> StringSlice::as_utf16() const
+    {
+        return UTF16String::from_copied_string(data_, length_);
+    }
+
+    std::unique_ptr<UTF8String> StringSlice::as_utf8() const
+    {
+        if (data_[length_] == '\0') {
+            return UTF8String::from_shared_content(parent_, data_, length_, is_ascii_);
+        }
+
+        return UTF8String::from_copied_string(data_, length_);
+    }
+
+    std::unique_ptr<String> StringSlice::substring(size_t start, size_t length) const
+    {
+        return of(*this, start, length, is_ascii_ == true ? std::optional<bool>(true) : std::nullopt);
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(String& rhs) const
+    {
+        size_t length = length_ + rhs.length();
+
+        // Long strings are concatenated lazily, to make chained concatenations run in linear time.
+        if (length >= RopeString::THRESHOLD || rhs.encoding() == StringEncoding::utf16) {
+            return RopeString::concat(*this, rhs);
+        }
+
+        char* bytes;
+        std::unique_ptr<String> result;
+
+        if (const_cast<StringSlice*>(this)->is_ascii() && rhs.is_ascii()) {
+            result = ASCIIString::allocate(length, bytes);
+        }
+        else {
+            result = UTF8String::allocate(length, bytes);
+        }
+
+        memcpy(bytes, data_, length_);
+        memcpy(bytes + length_, rhs.bytes(), rhs.length());
+
+        return result;
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(int64_t rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(uint64_t rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(float rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(double rhs) const
+    {
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
+    }
+
+    std::unique_ptr<String> StringSlice::operator+(const BigInt& rhs) const
+    {
+        std::string str = rhs.to_string();
+        return concat_ascii(str.c_str(), str.length());
+    }
+
+    std::unique_ptr<String> StringSlice::concat_ascii(const char* rhs, size_t rhs_length) const
+    {
+        size_t length = length_ + rhs_length;
+        char* bytes;
+        std::unique_ptr<String> result;
+
+        if (const_cast<StringSlice*>(this)->is_ascii()) {
+            result = ASCIIString::allocate(length, bytes);
+        }
+        else {
+            result = UTF8String::allocate(length, bytes);
+        }
+
+        memcpy(bytes, data_, length_);
+        memcpy(bytes + length_, rhs, rhs_length);
+
+        return result;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "perlang_string.h"
+
+namespace perlang
+{
+    // A string representing a part of another ASCII or UTF-8 string, sharing the content of the parent string instead
+    // of copying it. The parent string is kept alive for as long as the slice exists.
+    //
+    // Unlike the other string types, the content of a StringSlice is not NUL-terminated (unless the slice happens to
+    // end where its parent ends). Code passing bytes() to C functions expecting NUL-terminated strings must take this
+    // into account.
+    //
+    // The content is accessed via bytes() and length() like for other strings; `data_` points into the content of the
+    // parent string.
+    //
+    // StringSlices are never created directly; String::substring() returns them for longer parts of strings owned by a
+    // `std::shared_ptr`.
+    class StringSlice : public String
+    {
+     public:
+        // Creates a new string for `length` bytes of the content of `parent`, starting at byte `start`. If the parent is
+        // owned by a `std::shared_ptr`, the result is a StringSlice sharing its content; otherwise (or if the result is
+        // short enough to be stored inline in a new string), the content is copied. `is_ascii` is the ASCII-ness of the
+        // result, if already known by the caller.
+        //
+        // An std::out_of_range exception is thrown if the range is not within the parent string. For non-ASCII
+        // content, an std::invalid_argument exception is thrown if the range would split a multi-byte UTF-8 sequence.
+        [[nodiscard]]
+        static std::unique_ptr<String> of(const String& parent, size_t start, size_t length, std::optional<bool> is_ascii);
+
+     private:
+        // Creates a new, flat string with a copy of the given content.
+        [[nodiscard]]
+        static std::unique_ptr<String> copy(const char* data, size_t length, std::optional<bool> is_ascii);
+
+        StringSlice(std::shared_ptr<const String> parent, const char* data, size_t length, std::optional<bool> is_ascii);
+
+     public:
+        // Returns a NUL-terminated copy of the content. The caller is responsible for freeing the memory.
+        std::unique_ptr<const char[]> release_bytes() override;
+
+        // Determines if the string is ASCII-safe or not. This is inherited from the parent string when it is known to
+        // be ASCII-only; otherwise, it is calculated and cached on the first call.
+        [[nodiscard]]
+        bool is_ascii() override;
+
+        // Slices are an implementation detail, so the type of the parent string is returned here.
+        [[nodiscard]]
+        std::unique_ptr<String> get_type() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<ASCIIString> as_ascii() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<UTF16String> as_utf16() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<UTF8String> as_utf8() const override;
+
+        // Returns a part of this slice. The result shares the content of the parent string of this slice.
+        [[nodiscard]]
+        std::unique_ptr<String> substring(size_t start, size_t length) const override;
+
+        // Workaround false -Werror=overloaded-virtual positives
+        using String::operator+;
+
+        // Concatenates this string with another string. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(String& rhs) const override;
+
+        // Concatenates this string with an int64. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(int64_t rhs) const override;
+
+        // Concatenates this string with a uint64. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(uint64_t rhs) const override;
+
+        // Concatenates this string with a float. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(float rhs) const override;
+
+        // Concatenates this string with a double. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(double rhs) const override;
+
+        // Concatenates this string with a BigInt. The memory for the new string is allocated from the heap.
+        [[nodiscard]]
+        std::unique_ptr<String> operator+(const BigInt& rhs) const override;
+
+     private:
+        // Concatenates this string with the given ASCII content.
+        [[nodiscard]]
+        std::unique_ptr<String> concat_ascii(const char* rhs, size_t rhs_length) const;
+
+        // The string whose content this slice refers to. This is never another StringSlice; slices of slices refer to
+        // the parent of the original slice directly.
+        std::shared_ptr<const String> parent_;
+
+        std::optional<bool> is_ascii_;
+    };
+}
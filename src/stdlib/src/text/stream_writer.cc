@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "text/stream_writer.h"
+
+namespace perlang::text
+{
+    StreamWriter::StreamWriter(int fd, size_t buffer_size)
+        : StreamWriter(fd, nullptr, buffer_size)
+    {
+        if (fd < 0) {
+            throw std::invalid_argument("'fd' argument must be a valid file descriptor");
+        }
+    }
+
+    StreamWriter::StreamWriter(FILE* stream, size_t buffer_size)
+        : StreamWriter(-1, stream, buffer_size)
+    {
+        if (stream == nullptr) {
+            throw std::invalid_argument("'stream' argument cannot be null");
+        }
+    }
+
+    StreamWriter::StreamWriter(int fd, FILE* stream, size_t buffer_size)
+        : TextWriter(nullptr, 0)
+    {
+        fd_ = fd;
+        stream_ = stream;
+
+        buffer_size = std::max(buffer_size, MINIMUM_BUFFER_SIZE);
+        buffer_storage_ = std::unique_ptr<char[]>(new char[buffer_size]);
+
+        buffer_ = buffer_storage_.get();
+        capacity_ = buffer_size;
+    }
+
+    StreamWriter::~StreamWriter()
+    {
+        // Destructors must not throw. Callers who care about write errors must call flush() themselves.
+        try {
+            flush();
+        }
+        catch (const std::runtime_error&) {
+        }
+    }
+
+    void StreamWriter::flush()
+    {
+        // The buffer is emptied even if writing fails, so that the same content isn't attempted to be written again by
+        // the next flush.
+        size_t length = length_;
+        length_ = 0;
+
+        if (length > 0) {
+            write(buffer_, length);
+        }
+
+        if (stream_ != nullptr && fflush(stream_) != 0) {
+            throw std::runtime_error(std::string("Failed to flush stream: ") + strerror(errno));
+        }
+    }
+
+    size_t StreamWriter::bytes_written() const
+    {
+        return flushed_length_ + length_;
+    }
+
+    void StreamWriter::make_room(size_t)
+    {
+        size_t length = length_;
+        length_ = 0;
+
+        write(buffer_, length);
+    }
+
+    void StreamWriter::append_overflow(const char* str, size_t length)
+    {
+        if (length < capacity_) {
+            TextWriter::append_overflow(str, length);
+            return;
+        }
+
+        // Content at least as large as the buffer is written directly, instead of being copied through the buffer.
+        make_room(length);
+        write(str, length);
+    }
+
+    void StreamWriter::write(const char* data, size_t length)
+    {
+        if (stream_ != nullptr) {
+            size_t written = fwrite(data, 1, length, stream_);
+            flushed_length_ += written;
+
+            if (written != length) {
+                throw std::runtime_error(std::string("Failed to write to stream: ") + strerror(errno));
+            }
+
+            return;
+        }
+
+        while (length > 0) {
+            ssize_t result = ::write(fd_, data, length);
+
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw std::runtime_error(std::string("Failed to write to file descriptor: ") + strerror(errno));
+            }
+
+            // Partial writes are normal for pipes and sockets; the rest is written by the next iteration.
+            data += result;
+            length -= (size_t)result;
+            flushed_length_ += (size_t)result;
+        }
+    }
+}
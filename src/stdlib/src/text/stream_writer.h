@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+
+#include "text/text_writer.h"
+
+namespace perlang::text
+{
+    // Writes text to a file descriptor or a C stdio stream, through a fixed-size buffer which is flushed whenever it
+    // gets full. This makes it possible to produce output of any size in constant memory, using few and large writes.
+    //
+    // The writer does not take ownership of the file descriptor or stream, and never closes it. Any content remaining
+    // in the buffer is flushed when the writer is destroyed, but write errors can only be detected by calling flush()
+    // explicitly before that.
+    class StreamWriter : public TextWriter
+    {
+     public:
+        // The default size of the buffer. Large enough to make the cost of each write(2) call negligible.
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+        // Smaller buffer sizes are rounded up to this.
+        static constexpr size_t MINIMUM_BUFFER_SIZE = 2 * MAX_PREPARED_LENGTH;
+
+        // Creates a writer which writes to the given file descriptor using write(2).
+        explicit StreamWriter(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+        // Creates a writer which writes to the given stream using fwrite(). flush() also flushes the stream itself.
+        explicit StreamWriter(FILE* stream, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+        ~StreamWriter() override;
+
+        // Writes all buffered content to the file descriptor or stream. Throws std::runtime_error if writing fails.
+        void flush();
+
+        // Returns the total number of bytes appended to the writer so far, including content which is still buffered.
+        [[nodiscard]]
+        size_t bytes_written() const;
+
+     protected:
+        void make_room(size_t length) override;
+        void append_overflow(const char* str, size_t length) override;
+
+     private:
+        StreamWriter(int fd, FILE* stream, size_t buffer_size);
+
+        // Writes content directly to the file descriptor or stream, bypassing the buffer.
+        void write(const char* data, size_t length);
+
+        int fd_;
+        FILE* stream_;
+
+        // The number of bytes written to the file descriptor or stream so far.
+        size_t flushed_length_ = 0;
+
+        std::unique_ptr<char[]> buffer_storage_;
+    };
+}
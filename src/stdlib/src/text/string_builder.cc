@@ -1,50 +1,113 @@
-#include <stdexcept>
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
 
 #include "perlang_stdlib.h"
 
 namespace perlang::text
 {
     StringBuilder::StringBuilder()
+        : TextWriter(inline_buffer_, INLINE_CAPACITY)
     {
-        buffer_capacity_ = DEFAULT_BUFFER_SIZE;
-        buffer_ = new std::vector<char>(buffer_capacity_);
     }
 
-    StringBuilder::~StringBuilder()
+    StringBuilder::StringBuilder(size_t capacity)
+        : StringBuilder()
     {
-        delete buffer_;
+        reserve(capacity);
     }
 
-    void StringBuilder::append(const String& str)
+    StringBuilder::~StringBuilder() = default;
+
+    void StringBuilder::reserve(size_t capacity)
     {
-        if (current_position_ + str.length() >= buffer_capacity_) {
-            // Give the buffer enough size to fit the whole of str, and round it up to the closest 1KB boundary. For
-            // some applications (adding large strings  to the StringBuilder), this will lead to a large number of
-            // reallocations, but let's attempt to optimize for conserving memory consumption for now.
-            buffer_capacity_ = ((buffer_capacity_ + str.length()) | 1023) + 1;
-            buffer_->resize(buffer_capacity_);
+        if (capacity > capacity_) {
+            grow(capacity);
         }
+    }
 
-        memcpy((void*)&buffer_->data()[current_position_], str.bytes(), str.length());
-        current_position_ += str.length();
-        length_ += str.length();
+    size_t StringBuilder::length() const
+    {
+        return length_;
     }
 
-    void StringBuilder::append_line(const String& str)
+    const char* StringBuilder::data() const
     {
-        append(str);
-        append(*ASCIIString::from_static_string("\n"));
+        return buffer_;
     }
 
-    uint StringBuilder::length() const
+    size_t StringBuilder::capacity() const
     {
-        return length_;
+        return capacity_;
     }
 
     std::unique_ptr<perlang::String> StringBuilder::to_string()
     {
-        // TODO: Make this return ASCIIString for cases when the string contains ASCII-only content.
-        return UTF8String::from_copied_string(buffer_->data(), length_);
+        // The content is never validated again here, since its ASCII-ness is already known.
+        char* buffer;
+
+        if (ascii_) {
+            auto result = ASCIIString::allocate(length_, buffer);
+            memcpy(buffer, buffer_, length_);
+
+            return result;
+        }
+        else {
+            auto result = UTF8String::allocate(length_, buffer);
+            memcpy(buffer, buffer_, length_);
+
+            return result;
+        }
+    }
+
+    std::unique_ptr<perlang::String> StringBuilder::release_string()
+    {
+        std::unique_ptr<perlang::String> result;
+
+        // Content in the inline buffer is short and must be copied anyway. Heap buffers are handed over as-is, unless
+        // less than half of the buffer is used (which can only happen after reserve()). Copying that content to a
+        // right-sized string only temporarily needs 50% more memory, and avoids keeping the unused part alive for as
+        // long as the string lives.
+        if (heap_buffer_ == nullptr || length_ < capacity_ / 2) {
+            result = to_string();
+        }
+        else {
+            buffer_[length_] = '\0';
+
+            if (ascii_) {
+                result = ASCIIString::from_owned_ascii_content(heap_buffer_.get(), length_);
+            }
+            else {
+                result = UTF8String::from_owned_string(heap_buffer_.get(), length_);
+            }
+
+            // Only give up the ownership once the string has been successfully created.
+            heap_buffer_.release();
+        }
+
+        heap_buffer_ = nullptr;
+        buffer_ = inline_buffer_;
+        capacity_ = INLINE_CAPACITY;
+        length_ = 0;
+        ascii_ = true;
+
+        return result;
+    }
+
+    void StringBuilder::make_room(size_t length)
+    {
+        // Growing geometrically (rather than by a fixed amount) keeps the amortized cost of each append constant, even
+        // for builders which end up being many megabytes large.
+        grow(std::max(capacity_ * 2, length_ + length));
+    }
+
+    void StringBuilder::grow(size_t new_capacity)
+    {
+        auto new_buffer = std::unique_ptr<char[]>(new char[new_capacity + 1]);
+        memcpy(new_buffer.get(), buffer_, length_);
+
+        heap_buffer_ = std::move(new_buffer);
+        buffer_ = heap_buffer_.get();
+        capacity_ = new_capacity;
     }
 }
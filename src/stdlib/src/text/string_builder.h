@@ -1,66 +1,64 @@
 #pragma once
 
-#include <vector>
+#include <memory>
 
 #include "perlang_string.h"
+#include "text/text_writer.h"
 
 namespace perlang::text
 {
-    class StringBuilder
+    // Builds a string in memory, by appending content to a buffer which grows as needed.
+    class StringBuilder : public TextWriter
     {
-     private:
-        // TODO: Make this be calculated dynamically based on average sizes of previous StringBuilders that has been
-        // TODO: created. Implementing this should be fairly trivial by two extra static fields: num_instances and
-        // TODO: total_size. The problem is that these should be atomic, so we need some locking primitives in place
-        // TODO: to make the implementation be thread safe.
-        const uint DEFAULT_BUFFER_SIZE = 1024;
-
-        std::vector<char>* buffer_;
-        uint buffer_capacity_;
-        uint current_position_ = 0;
-        uint length_ = 0;
-
      public:
+        // The number of bytes which can be appended before the builder allocates any memory on the heap. Most
+        // builders are short-lived and only used for building short strings, which then need no heap allocation at all
+        // (other than for the string returned by to_string()).
+        static constexpr size_t INLINE_CAPACITY = 128;
+
+        // Creates a new, empty StringBuilder using the inline buffer.
         StringBuilder();
-        ~StringBuilder();
 
-        void append(const String& str);
+        // Creates a new, empty StringBuilder with room for at least `capacity` bytes before it needs to grow. Useful
+        // when the approximate size of the result is known up front.
+        explicit StringBuilder(size_t capacity);
+
+        ~StringBuilder() override;
 
-        inline void append(const std::unique_ptr<String>& str)
-        {
-            append(*str);
-        }
+        // Makes sure that at least `capacity` bytes can be held by the builder without any further reallocations.
+        void reserve(size_t capacity);
 
-        inline void append(const std::unique_ptr<ASCIIString>& str)
-        {
-            append(*str);
-        }
+        [[nodiscard]]
+        size_t length() const;
 
-        inline void append(const std::unique_ptr<UTF8String>& str)
-        {
-            append(*str);
-        }
+        // Returns the content appended so far, which is length() bytes long and not NUL-terminated. The pointer is only
+        // valid until more content is appended.
+        [[nodiscard]]
+        const char* data() const;
 
-        void append_line(const String& str);
+        // Returns the number of bytes the builder can hold before it needs to grow.
+        [[nodiscard]]
+        size_t capacity() const;
 
-        inline void append_line(const std::unique_ptr<String>& str)
-        {
-            append_line(*str);
-        }
+        // Returns a copy of the content, as an ASCIIString if it is ASCII-only and as a UTF8String otherwise. The
+        // builder can still be used afterwards.
+        std::unique_ptr<perlang::String> to_string();
 
-        inline void append_line(const std::unique_ptr<ASCIIString>& str)
-        {
-            append_line(*str);
-        }
+        // Like to_string(), but hands the buffer over to the returned string instead of copying it whenever possible.
+        // This avoids temporarily holding two copies of the content, which matters when building large strings. The
+        // builder is empty afterwards.
+        std::unique_ptr<perlang::String> release_string();
 
-        inline void append_line(const std::unique_ptr<UTF8String>& str)
-        {
-            append_line(*str);
-        }
+     protected:
+        void make_room(size_t length) override;
 
-        [[nodiscard]]
-        uint length() const;
+     private:
+        // Moves the content to a new heap buffer with room for `new_capacity` bytes (and a terminating `NUL`
+        // character, so that the buffer can be handed over to a string as-is).
+        void grow(size_t new_capacity);
 
-        std::unique_ptr<perlang::String> to_string();
+        // The heap buffer, once the content no longer fits in `inline_buffer_`.
+        std::unique_ptr<char[]> heap_buffer_;
+        char inline_buffer_[INLINE_CAPACITY];
     };
 }
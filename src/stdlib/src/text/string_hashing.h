@@ -1,25 +1,50 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory> // std::shared_ptr
 
 #include "perlang_string.h"
 
+// A reference to UTF-8 content along with its hash code, used for looking up keys in the containers below without
+// having to create a perlang::String for the key. The content is not copied, so the key must not outlive it.
+struct string_key
+{
+    // Creates a key for the given NUL-terminated string.
+    explicit string_key(const char* data)
+        : string_key(data, strlen(data))
+    {
+    }
+
+    // Creates a key for `length` bytes of content at `data`. The hash code is calculated immediately, and is the same
+    // as the one an ASCIIString or UTF8String with this content would have.
+    string_key(const char* data, size_t length)
+        : data(data),
+          length(length),
+          hash(perlang::String::hash_of(data, length))
+    {
+    }
+
+    const char* data;
+    size_t length;
+    uint64_t hash;
+};
+
 class string_hasher
 {
  public:
-    int operator()(const std::shared_ptr<perlang::String>& x) const {
-        // Based on an example from https://stackoverflow.com/a/2624210/227779
-        int hash = 7;
-
-        // TODO: Use x[i] instead, once we have an index operator for Perlang strings (and can avoid range checks for
-        // TODO: every step in the loop)
-        const char* bytes = x->bytes();
+    // Enables heterogeneous lookup in the tsl containers, i.e. the lookup methods taking a string_key.
+    using is_transparent = void;
 
-        for (size_t i = 0; i < x->length(); i++) {
-            hash = hash * 31 + bytes[i];
-        }
+    size_t operator()(const std::shared_ptr<perlang::String>& x) const {
+        // The hash code is cached in the string itself, so this is cheap for strings which have been hashed before
+        // (like the keys already stored in a hash set or dictionary).
+        return static_cast<size_t>(x->hash());
+    }
 
-        return hash;
+    size_t operator()(const string_key& x) const {
+        return static_cast<size_t>(x.hash);
     }
 };
 
@@ -27,7 +52,27 @@ class string_hasher
 class string_comparer
 {
  public:
+    using is_transparent = void;
+
     bool operator()(const std::shared_ptr<perlang::String>& x, const std::shared_ptr<perlang::String>& y) const {
+        if (x == y) {
+            return true;
+        }
+
+        // Strings with different hash codes can never be equal. Comparing the (cached) hash codes first avoids the
+        // full comparison for most of the non-matching keys in the same bucket.
+        if (x->hash() != y->hash()) {
+            return false;
+        }
+
         return *x == *y;
     }
+
+    bool operator()(const std::shared_ptr<perlang::String>& x, const string_key& y) const {
+        return x->hash() == y.hash && x->content_equals(y.data, y.length);
+    }
+
+    bool operator()(const string_key& x, const std::shared_ptr<perlang::String>& y) const {
+        return (*this)(y, x);
+    }
 };
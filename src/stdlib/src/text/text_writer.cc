@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "internal/ascii.h"
+#include "internal/string_utils.h"
+#include "perlang_stdlib.h"
+
+namespace perlang::text
+{
+    TextWriter::TextWriter(char* buffer, size_t capacity)
+    {
+        buffer_ = buffer;
+        capacity_ = capacity;
+    }
+
+    TextWriter::~TextWriter() = default;
+
+    void TextWriter::append(const String& str)
+    {
+        // The ASCII-ness of the string is usually already known (or cached once computed), which makes this cheaper
+        // than scanning the bytes here.
+        if (ascii_) {
+            ascii_ = const_cast<String&>(str).is_ascii();
+        }
+
+        append_bytes(str.bytes(), str.length());
+    }
+
+    void TextWriter::append(const char* str, size_t length)
+    {
+        if (ascii_) {
+            ascii_ = internal::is_ascii(str, length);
+        }
+
+        append_bytes(str, length);
+    }
+
+    void TextWriter::append(const char* str)
+    {
+        if (str == nullptr) {
+            throw std::invalid_argument("'str' argument cannot be null");
+        }
+
+        append(str, strlen(str));
+    }
+
+    void TextWriter::append(char c)
+    {
+        *prepare_append(1) = c;
+        length_++;
+
+        ascii_ = ascii_ && (uint8_t)c < 0x80;
+    }
+
+    void TextWriter::append(char16_t c)
+    {
+        // A char16_t on its own cannot hold a full surrogate pair, and a lone surrogate cannot be encoded as UTF-8.
+        if (c >= 0xD800 && c <= 0xDFFF) {
+            c = 0xFFFD;
+        }
+
+        char* position = prepare_append(3);
+
+        if (c < 0x80) {
+            position[0] = (char)c;
+            length_ += 1;
+            return;
+        }
+
+        ascii_ = false;
+
+        if (c < 0x800) {
+            position[0] = (char)(0xC0 | (c >> 6));
+            position[1] = (char)(0x80 | (c & 0x3F));
+            length_ += 2;
+        }
+        else {
+            position[0] = (char)(0xE0 | (c >> 12));
+            position[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+            position[2] = (char)(0x80 | (c & 0x3F));
+            length_ += 3;
+        }
+    }
+
+    void TextWriter::append(int32_t value)
+    {
+        append((int64_t)value);
+    }
+
+    void TextWriter::append(uint32_t value)
+    {
+        append((uint64_t)value);
+    }
+
+    void TextWriter::append(int64_t value)
+    {
+        // 20 bytes is enough for any int64_t, including the sign.
+        char* position = prepare_append(20);
+
+        if (value < 0) {
+            // Negating the value as unsigned avoids overflow for INT64_MIN.
+            *position = '-';
+            length_ += 1 + internal::FormattedNumber::write_decimal(position + 1, 0 - static_cast<uint64_t>(value));
+        }
+        else {
+            length_ += internal::FormattedNumber::write_decimal(position, static_cast<uint64_t>(value));
+        }
+    }
+
+    void TextWriter::append(uint64_t value)
+    {
+        length_ += internal::FormattedNumber::write_decimal(prepare_append(20), value);
+    }
+
+    void TextWriter::append(float value)
+    {
+        internal::FormattedNumber number(value);
+        append_bytes(number.data(), number.length());
+    }
+
+    void TextWriter::append(double value)
+    {
+        internal::FormattedNumber number(value);
+        append_bytes(number.data(), number.length());
+    }
+
+    void TextWriter::append(bool value)
+    {
+        if (value) {
+            append_bytes("true", 4);
+        }
+        else {
+            append_bytes("false", 5);
+        }
+    }
+
+    void TextWriter::append(const BigInt& value)
+    {
+        std::string str = value.to_string();
+        append_bytes(str.data(), str.length());
+    }
+
+    void TextWriter::append_repeat(char c, size_t count)
+    {
+        ascii_ = ascii_ && ((uint8_t)c < 0x80 || count == 0);
+
+        while (count > 0) {
+            if (length_ == capacity_) {
+                make_room(count);
+            }
+
+            size_t part_length = std::min(count, capacity_ - length_);
+            memset(buffer_ + length_, c, part_length);
+
+            length_ += part_length;
+            count -= part_length;
+        }
+    }
+
+    void TextWriter::append_line()
+    {
+        append('\n');
+    }
+
+    void TextWriter::append_line(const String& str)
+    {
+        append(str);
+        append('\n');
+    }
+
+    bool TextWriter::is_ascii() const
+    {
+        return ascii_;
+    }
+
+    void TextWriter::append_overflow(const char* str, size_t length)
+    {
+        make_room(length);
+
+        // Writers with a fixed-size buffer may not be able to make room for all of the content at once.
+        while (length > capacity_ - length_) {
+            size_t part_length = capacity_ - length_;
+            memcpy(buffer_ + length_, str, part_length);
+
+            length_ += part_length;
+            str += part_length;
+            length -= part_length;
+
+            make_room(length);
+        }
+
+        memcpy(buffer_ + length_, str, length);
+        length_ += length;
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+
+#include "ascii_string.h"
+#include "perlang_string.h"
+#include "utf8_string.h"
+
+class BigInt;
+
+namespace perlang::text
+{
+    // Base class for classes which text can be appended to, like StringBuilder (which keeps the text in memory) and
+    // StreamWriter (which writes it to a file). The content is appended to a buffer provided by the subclass, which
+    // decides what to do when the buffer is full.
+    class TextWriter
+    {
+     public:
+        virtual ~TextWriter();
+
+        // The buffer may point into the object itself, so instances cannot be copied by copying their fields.
+        TextWriter(const TextWriter&) = delete;
+        TextWriter& operator=(const TextWriter&) = delete;
+
+        void append(const String& str);
+
+        // Appends `length` bytes of UTF-8 content.
+        void append(const char* str, size_t length);
+
+        // Appends a NUL-terminated string of UTF-8 content. Without this overload, string literals would be appended as
+        // bool values.
+        void append(const char* str);
+
+        // Appends a single byte, which is meant to be an ASCII character. Other byte values are appended as-is, which
+        // only makes sense when appending UTF-8 content byte by byte.
+        void append(char c);
+
+        // Appends a character, encoded as UTF-8. Unpaired surrogates are appended as U+FFFD REPLACEMENT CHARACTER.
+        void append(char16_t c);
+
+        // The overloads below format the value directly into the buffer, using the same format as the string
+        // concatenation operators. No heap allocations are made, other than when a StringBuilder needs to grow.
+        void append(int32_t value);
+        void append(uint32_t value);
+        void append(int64_t value);
+        void append(uint64_t value);
+        void append(float value);
+        void append(double value);
+
+        // Appends "true" or "false".
+        void append(bool value);
+
+        // BigInt values are formatted via std::string, so this makes a temporary heap allocation.
+        void append(const BigInt& value);
+
+        // Appends the character `c`, `count` times.
+        void append_repeat(char c, size_t count);
+
+        inline void append(const std::unique_ptr<String>& str)
+        {
+            append(*str);
+        }
+
+        inline void append(const std::unique_ptr<ASCIIString>& str)
+        {
+            append(*str);
+        }
+
+        inline void append(const std::unique_ptr<UTF8String>& str)
+        {
+            append(*str);
+        }
+
+        // Appends a newline character.
+        void append_line();
+
+        void append_line(const String& str);
+
+        inline void append_line(const std::unique_ptr<String>& str)
+        {
+            append_line(*str);
+        }
+
+        inline void append_line(const std::unique_ptr<ASCIIString>& str)
+        {
+            append_line(*str);
+        }
+
+        inline void append_line(const std::unique_ptr<UTF8String>& str)
+        {
+            append_line(*str);
+        }
+
+        // Returns true if all content appended so far is ASCII-only. This is tracked while appending, so calling this is
+        // cheap.
+        [[nodiscard]]
+        bool is_ascii() const;
+
+     protected:
+        // The longest content appended using prepare_append(). Subclasses with a fixed-size buffer must make sure that
+        // this much content always fits in an empty buffer.
+        static constexpr size_t MAX_PREPARED_LENGTH = 32;
+
+        TextWriter(char* buffer, size_t capacity);
+
+        // Called when `length` more bytes do not fit in the remaining space of the buffer. Implementations must either
+        // make room for at least `length` bytes, or empty the buffer completely.
+        virtual void make_room(size_t length) = 0;
+
+        // Called when content does not fit in the remaining space of the buffer. The default implementation calls
+        // make_room() and copies the content in as many parts as needed. Subclasses can override this to avoid
+        // copying large content to the buffer at all.
+        virtual void append_overflow(const char* str, size_t length);
+
+        // The buffer being written to, the number of bytes it can hold and the number of bytes currently in it.
+        char* buffer_;
+        size_t capacity_;
+        size_t length_ = 0;
+
+        // True if all content appended so far is ASCII-only.
+        bool ascii_ = true;
+
+     private:
+        // Makes sure that at least `length` more bytes can be appended, and returns a pointer to where they should be
+        // written. The caller is responsible for updating `length_` afterwards. `length` must not be larger than
+        // MAX_PREPARED_LENGTH.
+        char* prepare_append(size_t length)
+        {
+            if (length > capacity_ - length_) {
+                make_room(length);
+            }
+
+            return buffer_ + length_;
+        }
+
+        // Appends bytes without updating `ascii_`. Used directly for content which is known to be ASCII-only, like
+        // formatted numbers.
+        void append_bytes(const char* str, size_t length)
+        {
+            if (length > capacity_ - length_) {
+                append_overflow(str, length);
+                return;
+            }
+
+            memcpy(buffer_ + length_, str, length);
+            length_ += length;
+        }
+    };
+}
@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t UIntArray::length() const
+    {
+        return length_;
+    }
+
     bool UIntArray::contains(uint32_t value) const
     {
         if (this == nullptr) {
@@ -28,6 +28,10 @@ namespace perlang
         // instead.
         void set(size_t index, uint32_t value);
 
+        // The length of the array.
+        [[nodiscard]]
+        size_t length() const;
+
         [[nodiscard]]
         bool contains(uint32_t value) const;
 
@@ -64,6 +64,11 @@ namespace perlang
         arr_[index] = value;
     }
 
+    size_t ULongArray::length() const
+    {
+        return length_;
+    }
+
     bool ULongArray::contains(uint64_t value) const
     {
         if (this == nullptr) {
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 
@@ -5,15 +7,32 @@
 #include "utf8_string.h"
 #include "utf16_string.h"
 #include "exceptions/null_pointer_exception.h"
+#include "internal/ascii.h"
+#include "internal/case_mapping.h"
+#include "internal/latin1.h"
 #include "internal/string_utils.h"
+#include "internal/transcoding.h"
 
 namespace perlang
 {
     std::unique_ptr<perlang::UTF16String> UTF16String::from_owned_string(std::vector<uint16_t> s)
     {
-        auto result = new UTF16String(s);
+        // The vector always contains an extra NUL terminating character; see the constructor.
+        size_t length = s.size() - 1;
+
+        // Like Java's "compact strings", content which fits in Latin-1 is stored using one byte per character. This
+        // halves the memory footprint (and the memory bandwidth needed to scan the string) for the common case. The
+        // content is scanned before allocating anything, so that content which cannot be stored compactly doesn't pay
+        // for a buffer it won't use. The scan stops at the first character which doesn't fit, which is usually early.
+        if (internal::find_non_latin1(s.data(), length) == length) {
+            char* latin1;
+            auto result = allocate_latin1(length, latin1);
+            internal::narrow_to_latin1(s.data(), length, latin1);
+
+            return result;
+        }
 
-        return std::unique_ptr<UTF16String>(result);
+        return std::unique_ptr<UTF16String>(new UTF16String(std::move(s)));
     }
 
     std::unique_ptr<UTF16String> UTF16String::from_copied_string(const char* str)
@@ -27,34 +46,85 @@ namespace perlang
 
     std::unique_ptr<UTF16String> UTF16String::from_copied_string(const char* str, size_t length)
     {
-        auto utf8_str = UTF8String::from_copied_string(str, length);
-        return utf8_str->as_utf16();
+        // ASCII content is valid Latin-1 as-is, so no transcoding is needed for it.
+        if (internal::is_ascii(str, length)) {
+            return from_latin1_string(str, length);
+        }
+
+        // Transcode directly from the source buffer, to avoid an intermediate copy of the UTF-8 data. The +1 is for the
+        // NUL terminator, which our print() implementation expects for now.
+        auto data = std::vector<uint16_t>(internal::utf16_length_from_utf8(str, length) + 1);
+        internal::utf8_to_utf16(str, length, data.data());
+
+        return from_owned_string(std::move(data));
+    }
+
+    std::unique_ptr<UTF16String> UTF16String::from_latin1_string(const char* str, size_t length)
+    {
+        char* latin1;
+        auto result = allocate_latin1(length, latin1);
+        memcpy(latin1, str, length);
+
+        return result;
+    }
+
+    std::unique_ptr<UTF16String> UTF16String::allocate_latin1(size_t length, char*& buffer)
+    {
+        auto latin1 = std::unique_ptr<char[]>(new char[length + 1]);
+        latin1[length] = '\0';
+        buffer = latin1.get();
+
+        return std::unique_ptr<UTF16String>(new UTF16String(std::move(latin1), length));
     }
 
     UTF16String::UTF16String(std::vector<uint16_t> string)
+        : String(StringEncoding::utf16)
+    {
+        code_units_ = std::move(string);
+
+        // The vector always contains an extra NUL terminating character for now, because our print() implementation
+        // needs it.
+        data_ = reinterpret_cast<const char*>(code_units_.data());
+        length_ = code_units_.size() - 1;
+    }
+
+    UTF16String::UTF16String(std::unique_ptr<char[]> latin1, size_t length)
+        : String(StringEncoding::utf16)
     {
-        data_ = std::move(string);
+        // `data_` is deliberately left null, so that bytes() calls materialize_bytes() which widens the content. Most
+        // code never needs the UTF-16 code units of compact strings though, since the methods in this class use the
+        // Latin-1 content directly.
+        latin1_ = std::move(latin1);
+        length_ = length;
     }
 
     UTF16String::~UTF16String() = default;
 
-    const char* UTF16String::bytes() const
+    std::unique_ptr<UTF16String> UTF16String::copy() const
     {
-        return (const char*)data_.data();
+        if (is_compact()) {
+            return from_latin1_string(latin1_.get(), length_);
+        }
+
+        std::vector<uint16_t> copied_data = code_units_;
+        auto new_string = new UTF16String(std::move(copied_data));
+        return std::unique_ptr<UTF16String>(new_string);
     }
 
-    std::unique_ptr<const char[]> UTF16String::release_bytes()
+    const char* UTF16String::materialize_bytes() const
     {
-        throw std::logic_error("UTF16String::release_bytes() is not supported; this class uses another data structure under the hood");
+        std::call_once(widen_once_, [this] {
+            // The +1 is for the NUL terminator, like in the other constructor.
+            code_units_ = std::vector<uint16_t>(length_ + 1);
+            std::copy_n(reinterpret_cast<const uint8_t*>(latin1_.get()), length_, code_units_.begin());
+        });
+
+        return reinterpret_cast<const char*>(code_units_.data());
     }
 
-    size_t UTF16String::length() const
+    std::unique_ptr<const char[]> UTF16String::release_bytes()
     {
-        // TODO: Consider caching this in the constructor, to avoid the extra overhead. Since strings are immutable, it
-        // should be perfectly safe.
-
-        // The vector always contains an extra NUL terminating character for now, because our print() implementation needs it.
-        return data_.size() - 1;
+        throw std::logic_error("UTF16String::release_bytes() is not supported; this class uses another data structure under the hood");
     }
 
     bool UTF16String::is_ascii()
@@ -63,33 +133,41 @@ namespace perlang
         // this is considered tolerable. Either one of them will "win" and set the is_ascii_ value accordingly; the data
         // is immutable, so they will inevitably end up with the same result anyway.
 
-        if (is_ascii_ != nullptr)
+        if (is_ascii_.has_value())
             return *is_ascii_;
 
-        for (size_t i = 0; i < data_.size(); i++) {
-            if (data_[i] > 127) {
-                is_ascii_ = std::make_unique<bool>(false);
-                return *is_ascii_;
-            }
+        if (is_compact()) {
+            is_ascii_ = internal::is_ascii(latin1_.get(), length_);
+        }
+        else {
+            // No uint16 elements with bit 7-15 set => this is an ASCII string.
+            is_ascii_ = internal::is_ascii(code_units_.data(), code_units_.size());
         }
 
-        // No uint16 elements with bit 7-15 set => this is an ASCII string.
-        is_ascii_ = std::make_unique<bool>(true);
         return *is_ascii_;
     }
 
     std::unique_ptr<ASCIIString> UTF16String::as_ascii() const
     {
         size_t len = length();
+        size_t non_ascii_index = is_compact() ? internal::find_non_ascii(latin1_.get(), len) : internal::find_non_ascii(code_units_.data(), len);
+
+        if (non_ascii_index != len) {
+            throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(non_ascii_index) + ". This string cannot be converted to ASCIIString.");
+        }
+
+        if (is_compact()) {
+            char* buffer;
+            auto result = ASCIIString::allocate(len, buffer);
+            memcpy(buffer, latin1_.get(), len);
+
+            return result;
+        }
+
         char* buf = new char[len + 1];
 
         for (size_t i = 0; i < len; i++) {
-            if (data_[i] > 127) {
-                delete[] buf;
-                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(i) + ". This string cannot be converted to ASCIIString.");
-            }
-
-            buf[i] = static_cast<char>(data_[i]);
+            buf[i] = static_cast<char>(code_units_[i]);
         }
 
         buf[len] = '\0';
@@ -105,6 +183,148 @@ namespace perlang
         return copy();
     }
 
+    std::unique_ptr<UTF8String> UTF16String::as_utf8() const
+    {
+        // Like UTF8String::as_utf16(), we use a vectorized pre-pass to calculate the exact length of the result. The
+        // conversion itself validates the surrogate pairs as it goes, throwing an exception on unpaired surrogates.
+        size_t len = length();
+
+        if (is_compact()) {
+            // Latin-1 content is always valid, and characters above U+007F are two bytes long in UTF-8.
+            char* buffer;
+            auto result = UTF8String::allocate(internal::utf8_length_from_latin1(latin1_.get(), len), buffer);
+            internal::latin1_to_utf8(latin1_.get(), len, buffer);
+
+            return result;
+        }
+
+        // The string owns the buffer from the start, so it is freed if the conversion throws.
+        char* buffer;
+        auto result = UTF8String::allocate(internal::utf8_length_from_utf16(code_units_.data(), len), buffer);
+        internal::utf16_to_utf8(code_units_.data(), len, buffer);
+
+        return result;
+    }
+
+    std::unique_ptr<String> UTF16String::substring(size_t start, size_t length) const
+    {
+        size_t string_length = this->length();
+
+        if (start > string_length || length > string_length - start) {
+            throw std::out_of_range(fmt::format("Range {0}..{1} is out-of-bounds for a string with length {2}", start, start + length, string_length));
+        }
+
+        if (is_compact()) {
+            return from_latin1_string(latin1_.get() + start, length);
+        }
+
+        // The content is stored in a std::vector, which cannot be shared with another string. The +1 is for the NUL
+        // terminator, like in from_copied_string().
+        auto data = std::vector<uint16_t>(length + 1);
+        std::copy_n(code_units_.begin() + start, length, data.begin());
+
+        return from_owned_string(std::move(data));
+    }
+
+    uint64_t UTF16String::compute_hash() const
+    {
+        // UTF16String instances compare equal to ASCII and UTF-8 strings with the same content, so they must also have
+        // the same hash code. We therefore hash the UTF-8 representation of the content. This only happens once per
+        // string, since the result is cached by hash().
+        const uint16_t* data = code_units_.data();
+        size_t utf8_length = is_compact() ? internal::utf8_length_from_latin1(latin1_.get(), length_) : internal::utf8_length_from_utf16(data, length_);
+
+        // ASCII content is identical in UTF-8, so compact strings with such content can be hashed as-is.
+        if (is_compact() && utf8_length == length_) {
+            return hash_of(latin1_.get(), length_);
+        }
+
+        char stack_buffer[256];
+        std::unique_ptr<char[]> heap_buffer;
+        char* buffer = stack_buffer;
+
+        if (utf8_length > sizeof(stack_buffer)) {
+            heap_buffer = std::unique_ptr<char[]>(new char[utf8_length]);
+            buffer = heap_buffer.get();
+        }
+
+        if (is_compact()) {
+            internal::latin1_to_utf8(latin1_.get(), length_, buffer);
+            return hash_of(buffer, utf8_length);
+        }
+
+        try {
+            internal::utf16_to_utf8(data, length_, buffer);
+        }
+        catch (const std::invalid_argument&) {
+            // Content with unpaired surrogates cannot be represented in UTF-8, and is thus never equal to an ASCII or
+            // UTF-8 string. Hashing the code units directly is fine in this case.
+            return hash_of(reinterpret_cast<const char*>(data), length_ * sizeof(uint16_t));
+        }
+
+        return hash_of(buffer, utf8_length);
+    }
+
+    std::unique_ptr<String> UTF16String::to_upper() const
+    {
+        if (is_compact()) {
+            if (auto result = change_case_compact(true)) {
+                return result;
+            }
+        }
+
+        return String::to_upper();
+    }
+
+    std::unique_ptr<String> UTF16String::to_lower() const
+    {
+        if (is_compact()) {
+            if (auto result = change_case_compact(false)) {
+                return result;
+            }
+        }
+
+        return String::to_lower();
+    }
+
+    std::unique_ptr<UTF16String> UTF16String::change_case_compact(bool upper) const
+    {
+        const char* data = latin1_.get();
+        auto latin1 = std::unique_ptr<char[]>(new char[length_ + 1]);
+        size_t i = 0;
+
+        while (i < length_) {
+            size_t ascii_length = internal::find_non_ascii(data + i, length_ - i);
+
+            if (upper) {
+                internal::ascii_to_upper(data + i, ascii_length, latin1.get() + i);
+            }
+            else {
+                internal::ascii_to_lower(data + i, ascii_length, latin1.get() + i);
+            }
+
+            i += ascii_length;
+
+            if (i == length_) {
+                break;
+            }
+
+            char32_t mapped = upper ? internal::to_upper((uint8_t)data[i]) : internal::to_lower((uint8_t)data[i]);
+
+            // 'µ' and 'ÿ' have uppercase forms outside of the Latin-1 range. Strings containing them are converted by
+            // the generic implementation instead, which produces a non-compact string.
+            if (mapped > 0xFF) {
+                return nullptr;
+            }
+
+            latin1[i++] = (char)mapped;
+        }
+
+        latin1[length_] = '\0';
+
+        return std::unique_ptr<UTF16String>(new UTF16String(std::move(latin1), length_));
+    }
+
     char16_t UTF16String::operator[](size_t index) const
     {
         if (this == nullptr) {
@@ -114,7 +334,7 @@ namespace perlang
         if (index < length()) {
             // Since we have performed the bounds checking manually now, we can now use the more "dangerous" index
             // operator rather than at(), which would perform bounds checking again.
-            return data_[index];
+            return is_compact() ? (uint8_t)latin1_[index] : code_units_[index];
         }
         else {
             throw std::out_of_range(fmt::format("Index {0} is out-of-bounds for a string with length {1} (valid range: 0..{2})", index, length(), length() - 1));
@@ -142,54 +362,61 @@ namespace perlang
 
     std::unique_ptr<String> UTF16String::operator+(const int64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF16String::operator+(const uint64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF16String::operator+(float rhs) const
     {
-        std::string str = internal::float_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF16String::operator+(double rhs) const
     {
-        std::string str = internal::double_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat_ascii(number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF16String::operator+(const BigInt& rhs) const
     {
         std::string str = rhs.to_string();
-        return *this + str;
+        return concat_ascii(str.c_str(), str.length());
     }
 
     std::unique_ptr<String> UTF16String::operator+(const std::string& rhs) const
     {
-        // Note: the new string is deliberately not NUL-terminated, since there is little point in NUL-terminating UTF16
-        // strings.
-        size_t length = this->data_.size() + rhs.length();
-        auto bytes = std::vector<uint16_t>(length);
+        if (!internal::is_ascii(rhs.c_str(), rhs.length())) {
+            throw std::logic_error("UTF16String::operator+(const std::string&) currently only supports concatenation with ASCII strings");
+        }
 
-        memcpy(bytes.data(), this->data_.data(), this->data_.size() * 2);
+        return concat_ascii(rhs.c_str(), rhs.length());
+    }
 
-        size_t rhs_length = rhs.length();
-        auto rhs_string = rhs.c_str();
+    std::unique_ptr<UTF16String> UTF16String::concat_ascii(const char* rhs, size_t rhs_length) const
+    {
+        // ASCII content can be appended to compact strings as-is, keeping the result compact.
+        if (is_compact()) {
+            char* latin1;
+            auto result = allocate_latin1(length_ + rhs_length, latin1);
+            memcpy(latin1, latin1_.get(), length_);
+            memcpy(latin1 + length_, rhs, rhs_length);
+
+            return result;
+        }
 
-        for (size_t i = 0; i < rhs_length; i++) {
-            if ((uint8_t)rhs_string[i] > 127) {
-                throw std::logic_error("UTF16String::operator+(const std::string&) currently only supports concatenation with ASCII strings");
-            }
+        // The +1 is for the NUL terminator, like in from_copied_string().
+        auto bytes = std::vector<uint16_t>(length_ + rhs_length + 1);
 
-            bytes[this->data_.size() + i] = (uint8_t)rhs_string[i];
-        }
+        memcpy(bytes.data(), this->code_units_.data(), length_ * sizeof(uint16_t));
+        std::copy_n(reinterpret_cast<const uint8_t*>(rhs), rhs_length, bytes.begin() + length_);
 
-        return from_owned_string(bytes);
+        return std::unique_ptr<UTF16String>(new UTF16String(std::move(bytes)));
     }
 }
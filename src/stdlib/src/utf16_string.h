@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include "perlang_string.h"
@@ -27,37 +29,58 @@ namespace perlang
         [[nodiscard]]
         static std::unique_ptr<UTF16String> from_copied_string(const char* str, size_t length);
 
+        // Creates a new UTF16String from Latin-1 (ISO-8859-1) content, i.e. content where each byte is a code point in
+        // the U+0000-U+00FF range. ASCII content is a subset of this. The content is copied, and stored compactly using
+        // one byte per character.
+        [[nodiscard]]
+        static std::unique_ptr<UTF16String> from_latin1_string(const char* str, size_t length);
+
+        // Creates a new, compact UTF16String with room for `length` Latin-1 characters, and sets `buffer` to point at
+        // the memory where the content should be written. The terminating `NUL` character is written by this method.
+        //
+        // This is meant to be used by the standard library itself when it constructs new strings. The caller **MUST
+        // NOT** modify the buffer after the string has been handed out to other code.
+        [[nodiscard]]
+        static std::unique_ptr<UTF16String> allocate_latin1(size_t length, char*& buffer);
+
      private:
         // Private constructor for creating a new UTF16String from an array of UTF16LE bytes.
         explicit UTF16String(std::vector<uint16_t> string);
 
+        // Private constructor for creating a new compact UTF16String from a buffer of `length` Latin-1 bytes.
+        UTF16String(std::unique_ptr<char[]> latin1, size_t length);
+
      public:
         ~UTF16String() override;
 
-        // Returns the backing byte array for this UTF816String. This method is generally to be avoided; it is safer to
-        // use the UTF16String throughout the code and only call this when you really must.
-        [[nodiscard]]
-        const char* bytes() const override;
-
         // Returns the backing byte array, and releases ownership of it. The caller is now responsible for freeing the
         // memory.
         std::unique_ptr<const char[]> release_bytes() override;
 
-        // The length of the string in number of uint16 elements
-        [[nodiscard]]
-        size_t length() const override;
-
         // Determines if the string is ASCII safe or not. Multiple subsequent calls to this method may return a cached
         // result from a previous run. The first call may use a pre-calculated value, but this is not guaranteed by
         // this method.
         bool is_ascii() override;
 
         [[nodiscard]]
-        std::unique_ptr<UTF16String> copy() const
+        std::unique_ptr<UTF16String> copy() const;
+
+        // Returns true if the string is stored compactly, using one byte per character. This is the case for all
+        // strings whose characters are in the U+0000-U+00FF range (ASCII and Latin-1), which is how most source code
+        // and text in general looks like. The representation is an implementation detail; all methods behave the same
+        // regardless of it.
+        [[nodiscard]]
+        bool is_compact() const
+        {
+            return latin1_ != nullptr;
+        }
+
+        // Returns the content of compact strings, one Latin-1 byte per character. Null for strings which are not compact.
+        // Unlike bytes(), this never needs to widen the content.
+        [[nodiscard]]
+        const char* latin1_bytes() const
         {
-            std::vector<uint16_t> copied_data = data_;
-            auto new_string = new UTF16String(std::move(copied_data));
-            return std::unique_ptr<UTF16String>(new_string);
+            return latin1_.get();
         }
 
         [[nodiscard]]
@@ -72,6 +95,19 @@ namespace perlang
         [[nodiscard]]
         std::unique_ptr<UTF16String> as_utf16() const override;
 
+        [[nodiscard]]
+        std::unique_ptr<UTF8String> as_utf8() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<String> substring(size_t start, size_t length) const override;
+
+        // Compact strings are converted directly, keeping the result compact whenever possible.
+        [[nodiscard]]
+        std::unique_ptr<String> to_upper() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<String> to_lower() const override;
+
         // Indexes the string, returning the character at the given position. Note that this method performs bounds
         // checking; attempting to read outside the string will result in an exception.
         char16_t operator[](size_t index) const;
@@ -105,16 +141,39 @@ namespace perlang
 
         // Concatenates this string with a std::string. The memory for the new string is allocated from the heap.
         [[nodiscard]]
-        inline std::unique_ptr<String> operator+(const std::string& rhs) const;
+        std::unique_ptr<String> operator+(const std::string& rhs) const;
+
+     protected:
+        // Widens the content of compact strings to UTF-16 code units, the first time bytes() is called.
+        const char* materialize_bytes() const override;
+
+        // Hashes the UTF-8 representation of the string, so that equal strings of other types get the same hash code.
+        [[nodiscard]]
+        uint64_t compute_hash() const override;
 
      private:
+        // Concatenates this string with the given ASCII content, which is not validated.
+        [[nodiscard]]
+        std::unique_ptr<UTF16String> concat_ascii(const char* rhs, size_t rhs_length) const;
+
+        // Converts the case of a compact string. Returns null if the result cannot be stored compactly.
+        [[nodiscard]]
+        std::unique_ptr<UTF16String> change_case_compact(bool upper) const;
+
+        // The content of compact strings (see is_compact()), one Latin-1 byte per character and NUL-terminated. Null
+        // for strings which contain characters outside of the Latin-1 range.
+        std::unique_ptr<char[]> latin1_;
+
         // The backing UTF16LE array for this string. This is to be considered immutable and MUST NOT be modified at any
-        // point. There might be multiple UTF16String objects pointing to the same `data_`, so modifying one of them
-        // would unintentionally spread the modifications to these other objects too.
-        std::vector<uint16_t> data_;
+        // point, except when it is populated by materialize_bytes() for compact strings. `data_` points into it for
+        // non-compact strings, and is left null for compact ones.
+        mutable std::vector<uint16_t> code_units_;
+
+        // Guards the widening of compact strings in materialize_bytes(), since multiple threads may call bytes().
+        mutable std::once_flag widen_once_;
 
         // A flag indicating whether this string contains only ASCII characters or not. Strings containing ASCII-only
         // content can be converted to ASCIIString without errors.
-        std::unique_ptr<bool> is_ascii_;
+        std::optional<bool> is_ascii_;
     };
 }
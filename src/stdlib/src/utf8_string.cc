@@ -1,25 +1,46 @@
 #include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include "bigint.h"
+#include "rope_string.h"
+#include "string_slice.h"
+#include "internal/ascii.h"
 #include "internal/string_utils.h"
+#include "internal/trailing_allocator.h"
+#include "internal/transcoding.h"
 #include "utf8_string.h"
 
-#define TWO_BYTE_UTF8(c)   (((c) & 0b11100000) == 0b11000000)
-#define THREE_BYTE_UTF8(c) (((c) & 0b11110000) == 0b11100000)
-#define FOUR_BYTE_UTF8(c)  (((c) & 0b11111000) == 0b11110000)
+namespace perlang
+{
+    namespace
+    {
+        // Concatenates two buffers with UTF-8 content into a new UTF8String.
+        std::unique_ptr<UTF8String> concat(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length)
+        {
+            char* bytes;
+            auto result = UTF8String::allocate(lhs_length + rhs_length, bytes);
 
-#define TWO_BYTE_UTF8_WITHOUT_MASK(c)   ((c) & 0b00011111)
-#define THREE_BYTE_UTF8_WITHOUT_MASK(c) ((c) & 0b00001111)
-#define FOUR_BYTE_UTF8_WITHOUT_MASK(c)  ((c) & 0b00000111)
+            memcpy(bytes, lhs, lhs_length);
+            memcpy(bytes + lhs_length, rhs, rhs_length);
 
-// This is present in all bytes of a UTF-8 sequence except for the first one
-#define IS_UTF8_SEQUENCE_MASK(c) (((c) & 0b11000000) == 0b10000000)
-#define UTF8_WITHOUT_SEQUENCE_MASK(c) ((c) & 0b00111111)
+            return result;
+        }
+
+        // Like concat(), but returns a string owned by a `std::shared_ptr`; see UTF8String::allocate_shared().
+        std::shared_ptr<UTF8String> concat_shared(const char* lhs, size_t lhs_length, const char* rhs, size_t rhs_length)
+        {
+            char* bytes;
+            auto result = UTF8String::allocate_shared(lhs_length + rhs_length, bytes);
+
+            memcpy(bytes, lhs, lhs_length);
+            memcpy(bytes + lhs_length, rhs, rhs_length);
+
+            return result;
+        }
+    }
 
-namespace perlang
-{
     std::unique_ptr<UTF8String> UTF8String::from_static_string(const char* s)
     {
         if (s == nullptr) {
@@ -55,16 +76,62 @@ namespace perlang
     {
         // Create a new buffer and copy the string into it. Since we know the length anyway, we can use memcpy() instead
         // of strcpy() to avoid an extra iteration over the string.
-        char* new_str = new char[length + 1];
-        memcpy(new_str, str, length);
-        new_str[length] = '\0';
+        char* buffer;
+        auto result = allocate(length, buffer);
+        memcpy(buffer, str, length);
 
-        auto result = new UTF8String(new_str, length, true);
+        return result;
+    }
 
-        return std::unique_ptr<UTF8String>(result);
+    std::unique_ptr<UTF8String> UTF8String::from_shared_content(std::shared_ptr<const String> owner, const char* data, size_t length, std::optional<bool> is_ascii)
+    {
+        auto result = std::unique_ptr<UTF8String>(new UTF8String(data, length, false));
+        result->static_content_ = owner == nullptr;
+        result->owner_ = std::move(owner);
+        result->is_ascii_ = is_ascii;
+
+        return result;
+    }
+
+    std::unique_ptr<UTF8String> UTF8String::allocate(size_t length, char*& buffer)
+    {
+        // Longer strings have their content stored directly after the object, so that the string can be created with
+        // a single heap allocation. The constructor doesn't throw when given trailing storage, so there is no need to
+        // guard against leaking the memory here.
+        size_t trailing_bytes = length <= INLINE_CAPACITY ? 0 : length + 1;
+        void* memory = ::operator new(sizeof(UTF8String) + trailing_bytes);
+
+        auto result = std::unique_ptr<UTF8String>(::new (memory) UTF8String(length, trailing_bytes > 0));
+        buffer = const_cast<char*>(result->bytes_.get());
+
+        return result;
+    }
+
+    std::shared_ptr<UTF8String> UTF8String::make_shared_copy(const char* str, size_t length)
+    {
+        if (str == nullptr) {
+            throw std::invalid_argument("'str' argument cannot be null");
+        }
+
+        char* buffer;
+        auto result = allocate_shared(length, buffer);
+        memcpy(buffer, str, length);
+
+        return result;
+    }
+
+    std::shared_ptr<UTF8String> UTF8String::allocate_shared(size_t length, char*& buffer)
+    {
+        // Short strings are stored inline, so they don't need any extra storage.
+        size_t trailing_bytes = length <= INLINE_CAPACITY ? 0 : length + 1;
+        internal::TrailingAllocator<UTF8String> allocator(trailing_bytes, buffer);
+
+        // Note that `buffer` is passed by reference, since the allocator only sets it once the memory is allocated.
+        return std::allocate_shared<UTF8String>(allocator, shared_key(), length, buffer);
     }
 
     UTF8String::UTF8String()
+        : String(StringEncoding::utf8)
     {
         bytes_ = std::unique_ptr<const char[]>(nullptr);
         length_ = 0;
@@ -72,10 +139,61 @@ namespace perlang
     }
 
     UTF8String::UTF8String(const char* string, size_t length, bool owned)
+        : String(StringEncoding::utf8)
     {
         bytes_ = std::unique_ptr<const char[]>(string);
+        data_ = string;
         length_ = length;
         owned_ = owned;
+
+        // Borrowed content is always static content (like a string literal), except for the strings created by
+        // from_shared_content() which override this.
+        static_content_ = !owned;
+    }
+
+    UTF8String::UTF8String(size_t length, bool trailing_storage)
+        : String(StringEncoding::utf8)
+    {
+        initialize_buffer(length, trailing_storage ? reinterpret_cast<char*>(this + 1) : nullptr);
+    }
+
+    UTF8String::UTF8String(shared_key, const char* string, size_t length)
+        : UTF8String(string, length, false)
+    {
+    }
+
+    UTF8String::UTF8String(shared_key, size_t length, char*& buffer)
+        : String(StringEncoding::utf8)
+    {
+        buffer = initialize_buffer(length, buffer);
+    }
+
+    char* UTF8String::initialize_buffer(size_t length, char* storage)
+    {
+        char* buffer;
+
+        if (length <= INLINE_CAPACITY) {
+            // The inline buffer is part of this object, so it must never be deallocated by the unique_ptr.
+            buffer = inline_bytes_;
+            owned_ = false;
+        }
+        else if (storage != nullptr) {
+            // Likewise for storage placed in the same allocation as this object by allocate() or allocate_shared().
+            buffer = storage;
+            owned_ = false;
+        }
+        else {
+            buffer = new char[length + 1];
+            owned_ = true;
+        }
+
+        buffer[length] = '\0';
+
+        bytes_ = std::unique_ptr<const char[]>(buffer);
+        data_ = buffer;
+        length_ = length;
+
+        return buffer;
     }
 
     UTF8String::~UTF8String()
@@ -87,19 +205,21 @@ namespace perlang
         }
     }
 
-    const char* UTF8String::bytes() const
-    {
-        return bytes_.get();
-    }
-
     std::unique_ptr<const char[]> UTF8String::release_bytes()
     {
-        return std::move(bytes_);
-    }
+        if (!owned_ && bytes_ != nullptr) {
+            // Memory we don't own cannot be handed over to the caller. This includes the inline buffer and the storage
+            // allocated by allocate() and allocate_shared(), since they are part of the same allocation as this object.
+            char* result = new char[length_ + 1];
+            memcpy(result, bytes_.get(), length_ + 1);
 
-    size_t UTF8String::length() const
-    {
-        return length_;
+            return std::unique_ptr<const char[]>(result);
+        }
+
+        // The string no longer has any content after this.
+        data_ = nullptr;
+
+        return std::move(bytes_);
     }
 
     bool UTF8String::is_ascii()
@@ -108,178 +228,248 @@ namespace perlang
         // this is considered tolerable. Either one of them will "win" and set the is_ascii_ value accordingly; the data
         // is immutable, so they will inevitably end up with the same result anyway.
 
-        if (is_ascii_ != nullptr)
+        if (is_ascii_.has_value())
             return *is_ascii_;
 
-        for (size_t i = 0; i < length_; i++) {
-            if ((uint8_t)bytes_[i] > 127) {
-                is_ascii_ = std::make_unique<bool>(false);
-                return *is_ascii_;
-            }
-        }
-
         // No bytes with bit 7 (value 128) set => this is an ASCII string.
-        is_ascii_ = std::make_unique<bool>(true);
+        is_ascii_ = internal::is_ascii(bytes_.get(), length_);
         return *is_ascii_;
     }
 
-    std::unique_ptr<ASCIIString> UTF8String::as_ascii() const
+    char32_t UTF8String::CodePointIterator::decode(const char* position, const char* end, size_t& length)
     {
-        for (size_t i = 0; i < length_; i++) {
-            if ((uint8_t)bytes_[i] > 127) {
-                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(i) + ". This string cannot be converted to ASCIIString.");
+        constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+        auto lead = (uint8_t)*position;
+        size_t sequence_length;
+        char32_t code_point;
+        char32_t minimum;
+
+        length = 1;
+
+        if (lead < 0x80) {
+            return lead;
+        }
+        else if ((lead & 0xE0) == 0xC0) {
+            sequence_length = 2;
+            code_point = lead & 0x1F;
+            minimum = 0x80;
+        }
+        else if ((lead & 0xF0) == 0xE0) {
+            sequence_length = 3;
+            code_point = lead & 0x0F;
+            minimum = 0x800;
+        }
+        else if ((lead & 0xF8) == 0xF0) {
+            sequence_length = 4;
+            code_point = lead & 0x07;
+            minimum = 0x10000;
+        }
+        else {
+            return REPLACEMENT_CHARACTER;
+        }
+
+        if (sequence_length > (size_t)(end - position)) {
+            return REPLACEMENT_CHARACTER;
+        }
+
+        for (size_t i = 1; i < sequence_length; i++) {
+            auto continuation = (uint8_t)position[i];
+
+            if ((continuation & 0xC0) != 0x80) {
+                return REPLACEMENT_CHARACTER;
             }
+
+            code_point = (code_point << 6) | (continuation & 0x3F);
+        }
+
+        if (code_point < minimum || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+            return REPLACEMENT_CHARACTER;
         }
 
-        return ASCIIString::from_copied_string(bytes_.get());
+        length = sequence_length;
+        return code_point;
     }
 
-    std::unique_ptr<UTF16String> UTF8String::as_utf16() const
+    struct UTF8String::CodePointIndex
     {
-        // This would technically not be *required* to be handled separately; I was at one point thinking of using a
-        // "do/while" construct below which would have been prone to buffer overruns, which is why I added it. Either
-        // way, special-casing it so we could at some point return a (pre-instantiated) UTF16String::empty() or
-        // something might not hurt.
-        if (length_ == 0) {
-            return UTF16String::from_copied_string("");
-        }
-
-        // The max size of the buffer needed is twice the size of the UTF-8 string, if we presume that 100% of its
-        // content is ASCII (One byte per character in ASCII => 16 bits in UTF-16). For UTF-8 encoded characters, a
-        // maximum of 4 bytes can be used per RFC3629. Each UTF-8 can be represented in at most two UTF-16 code points
-        // (=4 bytes), so such characters will fit in the above.
-        //
-        // This is likely to be too big for most strings we encounter, so we resize the array at the end to the right
-        // size. The downside of this is a potential extra allocation; the upside is that we don't need an extra
-        // iteration over the string just to determine its length before the allocation. Future improvements here could
-        // be to stack-allocate the intermediate buffer if the string is below a given threshold (say, 1KB or 8KB) to
-        // minimize the number of allocations further.
-        auto data = std::vector<uint16_t>(length_ * 2);
-
-        size_t i = 0;
-        size_t new_length = 0;
-
-        while (i < length_) {
-            uint8_t c = bytes_[i];
-
-            if (c <= 127) {
-                // This is an ASCII character; no special measures are needed
-                data[new_length] = c;
-                i++;
-                new_length++;
-            }
-            else {
-                // There are three valid scenarios at this point, as described nicely here:
-                // https://dev.to/emnudge/decoding-utf-8-3947 (examples are in binary):
-                //
-                // - Starting with 110 - UTF-8 code point with 2 bytes
-                // - Starting with 1110 - code point with 3 bytes
-                // - Starting with 11110 - code point with 4 bytes
-                //
-                // Anything else (like 10) is to be considered invalid; it's only expected in the subsequent bytes.
-                // Because we can make those assumptions, this is now implemented as a simple list of if/else
-                // statements. We also need to do bounds checking, to ensure we don't cause a buffer overrun.
-                if (TWO_BYTE_UTF8(c)) {
-                    if (i + 1 >= length_) {
-                        throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit two bytes of expected UTF-8 data)");
-                    }
+        // The byte offset of code point 0, CODE_POINT_INDEX_INTERVAL, 2 * CODE_POINT_INDEX_INTERVAL and so forth.
+        std::vector<size_t> offsets;
 
-                    uint8_t d = bytes_[i + 1];
+        size_t code_point_count = 0;
+    };
 
-                    if (!IS_UTF8_SEQUENCE_MASK(d)) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (second byte lacks UTF-8 mask)");
+    const UTF8String::CodePointIndex& UTF8String::code_point_index() const
+    {
+        std::call_once(code_point_index_once_, [this] {
+            auto index = std::make_unique<CodePointIndex>();
+            const char* data = bytes_.get();
+            size_t count = 0;
+            size_t i = 0;
+
+            index->offsets.reserve(length_ / CODE_POINT_INDEX_INTERVAL + 1);
+
+            while (i < length_) {
+                if ((uint8_t)data[i] < 0x80) {
+                    // Runs of ASCII characters are skipped using the vectorized scan; each byte is a code point, so
+                    // the offsets of the indexed code points within the run can be calculated directly.
+                    size_t run_length = internal::find_non_ascii(data + i, length_ - i);
+                    size_t next = (count + CODE_POINT_INDEX_INTERVAL - 1) / CODE_POINT_INDEX_INTERVAL * CODE_POINT_INDEX_INTERVAL;
+
+                    for (; next < count + run_length; next += CODE_POINT_INDEX_INTERVAL) {
+                        index->offsets.push_back(i + (next - count));
                     }
 
-                    uint16_t target_char = (TWO_BYTE_UTF8_WITHOUT_MASK(c) << 6) +
-                                           UTF8_WITHOUT_SEQUENCE_MASK(d);
-
-                    // "Overlong" sequences must be treated as invalid per RFC 3629
-                    if (target_char < 128) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
+                    i += run_length;
+                    count += run_length;
+                }
+                else {
+                    if (count % CODE_POINT_INDEX_INTERVAL == 0) {
+                        index->offsets.push_back(i);
                     }
 
-                    data[new_length] = target_char;
+                    size_t sequence_length;
+                    CodePointIterator::decode(data + i, data + length_, sequence_length);
 
-                    i += 2;
-                    new_length++;
+                    i += sequence_length;
+                    count++;
                 }
-                else if (THREE_BYTE_UTF8(c)) {
-                    if (i + 2 >= length_) {
-                        throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit three bytes of expected UTF-8 data)");
-                    }
+            }
 
-                    uint8_t d = bytes_[i + 1];
-                    uint8_t e = bytes_[i + 2];
+            index->code_point_count = count;
+            code_point_index_ = std::move(index);
+        });
 
-                    if (!IS_UTF8_SEQUENCE_MASK(d) || !IS_UTF8_SEQUENCE_MASK(e)) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (one or more byte(s) lacks UTF-8 mask)");
-                    }
+        return *code_point_index_;
+    }
 
-                    uint16_t target_char = (THREE_BYTE_UTF8_WITHOUT_MASK(c) << 12) +
-                                           (UTF8_WITHOUT_SEQUENCE_MASK(d) << 6) +
-                                           UTF8_WITHOUT_SEQUENCE_MASK(e);
+    size_t UTF8String::code_point_count() const
+    {
+        if (const_cast<UTF8String*>(this)->is_ascii()) {
+            return length_;
+        }
 
-                    // "Overlong" sequences must be treated as invalid per RFC 3629
-                    if (target_char < 2048) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
-                    }
+        return code_point_index().code_point_count;
+    }
 
-                    data[new_length] = target_char;
+    char32_t UTF8String::code_point_at(size_t index) const
+    {
+        if (const_cast<UTF8String*>(this)->is_ascii()) {
+            if (index >= length_) {
+                throw std::out_of_range(fmt::format("Index {0} is out-of-bounds for a string with {1} code points", index, length_));
+            }
 
-                    i += 3;
-                    new_length++;
-                }
-                else if (FOUR_BYTE_UTF8(c)) {
-                    if (i + 3 >= length_) {
-                        throw std::invalid_argument("Truncated UTF-8 sequence encountered (string was too short to fit four bytes of expected UTF-8 data)");
-                    }
+            return (uint8_t)bytes_[index];
+        }
 
-                    uint8_t d = bytes_[i + 1];
-                    uint8_t e = bytes_[i + 2];
-                    uint8_t f = bytes_[i + 3];
+        const CodePointIndex& code_point_index = this->code_point_index();
 
-                    if (!IS_UTF8_SEQUENCE_MASK(d) || !IS_UTF8_SEQUENCE_MASK(e) || !IS_UTF8_SEQUENCE_MASK(f)) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (one or more  byte(s) lacks UTF-8 mask)");
-                    }
+        if (index >= code_point_index.code_point_count) {
+            throw std::out_of_range(fmt::format("Index {0} is out-of-bounds for a string with {1} code points", index, code_point_index.code_point_count));
+        }
 
-                    // Note that the target character is a surrogate pair in this case, so we need to store two
-                    // characters in the resulting array.
-                    uint32_t target_char = (FOUR_BYTE_UTF8_WITHOUT_MASK(c) << 18) +
-                                           (UTF8_WITHOUT_SEQUENCE_MASK(d) << 12) +
-                                           (UTF8_WITHOUT_SEQUENCE_MASK(e) << 6) +
-                                           UTF8_WITHOUT_SEQUENCE_MASK(f);
+        const char* data = bytes_.get();
+        CodePointIterator iterator(data + code_point_index.offsets[index / CODE_POINT_INDEX_INTERVAL], data + length_);
 
-                    // "Overlong" sequences must be treated as invalid per RFC 3629
-                    if (target_char < 65536) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
-                    }
+        for (size_t i = index % CODE_POINT_INDEX_INTERVAL; i > 0; i--) {
+            ++iterator;
+        }
 
-                    if (target_char > 0x10FFFF) {
-                        throw std::invalid_argument("Invalid UTF-8 sequence encountered (code point exceeds maximum allowed value of 0x10FFFF)");
-                    }
+        return *iterator;
+    }
 
-                    // Convert the code point to a surrogate pair
-                    target_char -= 0x10000;
-                    data[new_length] = (target_char >> 10) + 0xD800;        // High surrogate
-                    data[new_length + 1] = (target_char & 0x3FF) + 0xDC00;  // Low surrogate
+    bool UTF8String::can_share_content(std::shared_ptr<const String>& owner) const
+    {
+        if (static_content_) {
+            owner = nullptr;
+            return true;
+        }
 
-                    i += 4;
-                    new_length += 2;
-                }
-                else {
-                    throw std::invalid_argument("Invalid UTF-8 sequence encountered (first byte does not match any known UTF-8 encoding scheme)");
-                }
+        if (owner_ != nullptr) {
+            owner = owner_;
+            return true;
+        }
+
+        // Strings are immutable, so the content of a string owned by a shared_ptr can be shared for as long as we hold
+        // a reference to it.
+        if (length_ > INLINE_CAPACITY) {
+            owner = weak_from_this().lock();
+            return owner != nullptr;
+        }
+
+        return false;
+    }
+
+    std::unique_ptr<ASCIIString> UTF8String::as_ascii() const
+    {
+        // The content only needs to be validated if is_ascii() hasn't already done it.
+        if (is_ascii_ != true) {
+            size_t non_ascii_index = internal::find_non_ascii(data_, length_);
+
+            if (non_ascii_index != length_) {
+                throw std::invalid_argument("Non-ASCII character encountered at index " + std::to_string(non_ascii_index) + ". This string cannot be converted to ASCIIString.");
             }
         }
 
-        // Shrink the std::vector to the actual size we need, now that we know the actual length of the converted
-        // string. The +1 part is because our print() implementation expects the string to be NUL-terminated for now.
-        // We'll try to get rid of this limitation eventually.
-        data.resize(new_length + 1);
+        std::shared_ptr<const String> owner;
+
+        if (can_share_content(owner)) {
+            return ASCIIString::from_shared_content(std::move(owner), data_, length_);
+        }
+
+        char* buffer;
+        auto result = ASCIIString::allocate(length_, buffer);
+        memcpy(buffer, data_, length_);
+
+        return result;
+    }
+
+    std::unique_ptr<UTF16String> UTF8String::as_utf16() const
+    {
+        // ASCII content is stored compactly by UTF16String, using one byte per character; no transcoding is needed.
+        // The check is a cheap vectorized scan, and its result is cached for later calls.
+        if (const_cast<UTF8String*>(this)->is_ascii()) {
+            return UTF16String::from_latin1_string(bytes_.get(), length_);
+        }
+
+        // A vectorized pre-pass over the string gives us the exact number of UTF-16 code units needed, so that the
+        // result can be written directly into a right-sized buffer. This is typically much cheaper than the alternative
+        // of allocating a worst-case sized buffer (twice the UTF-8 length) and shrinking it afterwards, since the
+        // pre-pass only reads the data and doesn't touch the allocator at all.
+        //
+        // The +1 part is because our print() implementation expects the string to be NUL-terminated for now. We'll try
+        // to get rid of this limitation eventually.
+        size_t utf16_length = internal::utf16_length_from_utf8(bytes_.get(), length_);
+        auto data = std::vector<uint16_t>(utf16_length + 1);
+
+        // The conversion validates the string as it goes, throwing an exception on invalid or overlong sequences.
+        internal::utf8_to_utf16(bytes_.get(), length_, data.data());
 
         return UTF16String::from_owned_string(std::move(data));
     }
 
+    std::unique_ptr<UTF8String> UTF8String::as_utf8() const
+    {
+        std::shared_ptr<const String> owner;
+
+        if (can_share_content(owner)) {
+            return from_shared_content(std::move(owner), data_, length_, is_ascii_);
+        }
+
+        char* buffer;
+        auto result = allocate(length_, buffer);
+        memcpy(buffer, data_, length_);
+        result->is_ascii_ = is_ascii_;
+
+        return result;
+    }
+
+    std::unique_ptr<String> UTF8String::substring(size_t start, size_t length) const
+    {
+        // A part of an ASCII-only string is also ASCII-only, but nothing is known about the parts of other strings.
+        return StringSlice::of(*this, start, length, is_ascii_ == true ? std::optional<bool>(true) : std::nullopt);
+    }
+
     bool UTF8String::operator==(const UTF8String& rhs) const
     {
         if (bytes_ == rhs.bytes_ &&
@@ -303,50 +493,56 @@ namespace perlang
     std::unique_ptr<String> UTF8String::operator+(String& rhs) const
     {
         size_t length = this->length_ + rhs.length();
-        char *bytes = new char[length + 1];
 
-        // TODO: This won't work once we bring in UTF16String into the picture.
+        // Long strings are concatenated lazily, to make chained concatenations run in linear time. UTF-16 content
+        // cannot be copied byte-wise, so it is left for the rope to convert.
+        if (length >= RopeString::THRESHOLD || rhs.encoding() == StringEncoding::utf16) {
+            return RopeString::concat(*this, rhs);
+        }
+
+        char* bytes;
+        auto result = allocate(length, bytes);
+
         memcpy(bytes, this->bytes_.get(), this->length_);
         memcpy((bytes + this->length_), rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
 
-        return from_owned_string(bytes, length);
+        return result;
     }
 
     std::unique_ptr<UTF8String> UTF8String::operator+(const UTF8String& rhs) const
     {
         size_t length = this->length_ + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = allocate(length, bytes);
 
         memcpy(bytes, this->bytes_.get(), this->length_);
         memcpy((bytes + this->length_), rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
 
-        return from_owned_string(bytes, length);
+        return result;
     }
 
     std::unique_ptr<String> UTF8String::operator+(const int64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF8String::operator+(const uint64_t rhs) const
     {
-        std::string str = std::to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF8String::operator+(float rhs) const
     {
-        std::string str = internal::float_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF8String::operator+(double rhs) const
     {
-        std::string str = internal::double_to_string(rhs);
-        return *this + str;
+        internal::FormattedNumber number(rhs);
+        return concat(bytes_.get(), length_, number.data(), number.length());
     }
 
     std::unique_ptr<String> UTF8String::operator+(const BigInt& rhs) const
@@ -358,48 +554,83 @@ namespace perlang
     std::unique_ptr<String> UTF8String::operator+(const std::string& rhs) const
     {
         size_t length = this->length_ + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = allocate(length, bytes);
 
         memcpy(bytes, this->bytes_.get(), this->length_);
         memcpy((bytes + this->length_), rhs.c_str(), rhs.length());
-        bytes[length] = '\0';
 
-        return from_owned_string(bytes, length);
+        return result;
     }
 
     std::unique_ptr<UTF8String> operator+(const int64_t lhs, const UTF8String& rhs)
     {
-        std::string str = std::to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<UTF8String> operator+(const uint64_t lhs, const UTF8String& rhs)
     {
-        std::string str = std::to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<UTF8String> operator+(const float lhs, const UTF8String& rhs)
     {
-        std::string str = internal::float_to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<UTF8String> operator+(const double lhs, const UTF8String& rhs)
     {
-        std::string str = internal::double_to_string(lhs);
-        return str + rhs;
+        internal::FormattedNumber number(lhs);
+        return concat(number.data(), number.length(), rhs.bytes(), rhs.length());
     }
 
     std::unique_ptr<UTF8String> operator+(const std::string& lhs, const UTF8String& rhs)
     {
         size_t length = lhs.length() + rhs.length();
-        char *bytes = new char[length + 1];
+        char* bytes;
+        auto result = UTF8String::allocate(length, bytes);
 
         memcpy(bytes, lhs.c_str(), lhs.length());
         memcpy((bytes + lhs.length()), rhs.bytes(), rhs.length());
-        bytes[length] = '\0';
 
-        return UTF8String::from_owned_string(bytes, length);
+        return result;
+    }
+
+    std::shared_ptr<UTF8String> concat_shared(const UTF8String& lhs, const UTF8String& rhs)
+    {
+        return concat_shared(lhs.bytes(), lhs.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<UTF8String> concat_shared(const int64_t lhs, const UTF8String& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<UTF8String> concat_shared(const uint64_t lhs, const UTF8String& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<UTF8String> concat_shared(const float lhs, const UTF8String& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<UTF8String> concat_shared(const double lhs, const UTF8String& rhs)
+    {
+        internal::FormattedNumber number(lhs);
+        return concat_shared(number.data(), number.length(), rhs.bytes(), rhs.length());
+    }
+
+    std::shared_ptr<const String> concat_shared(const BigInt& lhs, const UTF8String& rhs)
+    {
+        std::string str = lhs.to_string();
+        return concat_shared(str.c_str(), str.length(), rhs.bytes(), rhs.length());
     }
 }
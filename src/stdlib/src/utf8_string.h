@@ -2,6 +2,9 @@
 
 #include <cstddef>
 #include <atomic>
+#include <iterator>
+#include <mutex>
+#include <optional>
 
 #include "ascii_string.h"
 #include "perlang_string.h"
@@ -11,7 +14,111 @@ namespace perlang
 {
     class UTF8String : public String
     {
+     private:
+        // A "pass key" for the constructors used by the make_shared_*() and allocate_shared() methods. These
+        // constructors must be public for std::make_shared() and std::allocate_shared() to be able to call them, but
+        // since only UTF8String itself can create a shared_key, they cannot be called from other code.
+        struct shared_key
+        {
+            explicit shared_key() = default;
+        };
+
      public:
+        // A forward iterator over the code points of a UTF-8 string, decoding them on the fly. Invalid UTF-8 sequences
+        // (including overlong encodings and encoded surrogates) are returned as U+FFFD REPLACEMENT CHARACTER, one per
+        // offending byte. ASCII characters are handled inline; only other characters need a call to decode().
+        class CodePointIterator
+        {
+         public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = char32_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const char32_t*;
+            using reference = char32_t;
+
+            CodePointIterator(const char* position, const char* end)
+                : position_(position), end_(end)
+            {
+            }
+
+            char32_t operator*() const
+            {
+                auto byte = (uint8_t)*position_;
+
+                if (byte < 0x80) {
+                    return byte;
+                }
+
+                size_t length;
+                return decode(position_, end_, length);
+            }
+
+            CodePointIterator& operator++()
+            {
+                if ((uint8_t)*position_ < 0x80) {
+                    position_++;
+                }
+                else {
+                    size_t length;
+                    decode(position_, end_, length);
+                    position_ += length;
+                }
+
+                return *this;
+            }
+
+            CodePointIterator operator++(int)
+            {
+                CodePointIterator result = *this;
+                ++*this;
+                return result;
+            }
+
+            bool operator==(const CodePointIterator& rhs) const
+            {
+                return position_ == rhs.position_;
+            }
+
+            bool operator!=(const CodePointIterator& rhs) const
+            {
+                return position_ != rhs.position_;
+            }
+
+            // Returns a pointer to the first byte of the current code point.
+            [[nodiscard]]
+            const char* position() const
+            {
+                return position_;
+            }
+
+            // Decodes the code point starting at `position`, setting `length` to the number of bytes it occupies.
+            // Invalid sequences yield U+FFFD, with a `length` of 1.
+            static char32_t decode(const char* position, const char* end, size_t& length);
+
+         private:
+            const char* position_;
+            const char* end_;
+        };
+
+        // A range of code points, usable in range-based for loops. Returned by code_points().
+        struct CodePointRange
+        {
+            CodePointIterator first;
+            CodePointIterator last;
+
+            [[nodiscard]]
+            CodePointIterator begin() const
+            {
+                return first;
+            }
+
+            [[nodiscard]]
+            CodePointIterator end() const
+            {
+                return last;
+            }
+        };
+
         // Creates a new UTF8String from a "static string", like a string constant. The static string is guaranteed to
         // have "static lifetime" (in Rust terms); in other words, that it exists during the remaining lifetime of the
         // running program. We also extend this to presume that the content of the string remains the same during this
@@ -23,6 +130,16 @@ namespace perlang
         [[nodiscard]]
         static std::unique_ptr<UTF8String> from_static_string(const char* s);
 
+        // Creates a new UTF8String from a string literal. Like from_static_string(), the string "borrows" the literal
+        // instead of copying it, but the length is determined at compile time. This is used by the code generated by
+        // the Perlang compiler.
+        template <size_t N>
+        [[nodiscard]]
+        static std::unique_ptr<UTF8String> from_literal(const char (&s)[N])
+        {
+            return std::unique_ptr<UTF8String>(new UTF8String(s, N - 1, false));
+        }
+
         // Creates a new UTF8String from an "owned string", which is presumed to have been allocated on the heap using
         // the C++ "new" operator. The ownership of the memory is transferred to the UTF8String, which is then
         // responsible for deallocating the memory when it is no longer needed (i.e. when no references to it remains).
@@ -45,6 +162,44 @@ namespace perlang
         [[nodiscard]]
         static std::unique_ptr<UTF8String> from_copied_string(const char* str, size_t length);
 
+        // Creates a new UTF8String with room for `length` bytes of content, returning a pointer to the (uninitialized)
+        // content in `buffer`. The content is stored inline in the UTF8String object itself (for short strings) or
+        // directly after it, which means that strings of any length are created using a single heap allocation. The
+        // terminating `NUL` character is written by this method.
+        //
+        // This is meant to be used by the standard library itself when it constructs new strings (concatenation etc).
+        // The caller **MUST NOT** modify the buffer after the string has been handed out to other code.
+        [[nodiscard]]
+        static std::unique_ptr<UTF8String> allocate(size_t length, char*& buffer);
+
+        // Creates a new UTF8String which shares `length` bytes of content at `data` with `owner`, instead of copying it.
+        // The content is kept alive by holding a reference to `owner`; a null `owner` means that the content has static
+        // lifetime. The content must be NUL-terminated. `is_ascii` is used as the cached result of is_ascii(), if
+        // known by the caller.
+        [[nodiscard]]
+        static std::unique_ptr<UTF8String> from_shared_content(std::shared_ptr<const String> owner, const char* data, size_t length, std::optional<bool> is_ascii);
+
+        // Creates a new UTF8String owned by a `std::shared_ptr`, by copying `length` bytes from `str`. The control block,
+        // the UTF8String object and its content are placed in a single heap allocation, which makes this the
+        // preferred way to create strings that will be stored in a `std::shared_ptr` anyway (like all strings in the
+        // code generated by the Perlang compiler).
+        [[nodiscard]]
+        static std::shared_ptr<UTF8String> make_shared_copy(const char* str, size_t length);
+
+        // Like from_literal(), but returns a string owned by a `std::shared_ptr`. The control block and the
+        // UTF8String object are placed in a single heap allocation, while the literal itself is borrowed.
+        template <size_t N>
+        [[nodiscard]]
+        static std::shared_ptr<UTF8String> make_shared_literal(const char (&str)[N])
+        {
+            return std::make_shared<UTF8String>(shared_key(), str, N - 1);
+        }
+
+        // Like allocate(), but returns a string owned by a `std::shared_ptr`. The content is placed in the same heap
+        // allocation as the control block and the UTF8String object; see make_shared_copy().
+        [[nodiscard]]
+        static std::shared_ptr<UTF8String> allocate_shared(size_t length, char*& buffer);
+
         // Public constructor for initializing an empty UTF8String. Necessary for being able to create an array of
         // UTF8String instances.
         UTF8String();
@@ -55,22 +210,52 @@ namespace perlang
         // responsible for deallocating it when it is no longer needed.
         UTF8String(const char* string, size_t length, bool owned);
 
+        // Private constructor for creating a new, uninitialized UTF8String with room for `length` bytes of content. If
+        // `trailing_storage` is true, the content is stored directly after the object itself, in the same allocation.
+        // See allocate() for more details.
+        UTF8String(size_t length, bool trailing_storage);
+
+        // Sets up the content buffer for a string with room for `length` bytes of content, and returns a pointer to it.
+        // Short strings use the inline buffer; longer ones use `storage` if it is non-null, or a new heap allocation
+        // otherwise.
+        char* initialize_buffer(size_t length, char* storage);
+
+        // Determines whether the content of this string can be shared with another string instead of being copied. If
+        // so, `owner` is set to the object keeping the content alive (or null, for static content). Short strings are
+        // never shared, since copying them into the inline buffer of the new string is cheaper.
+        bool can_share_content(std::shared_ptr<const String>& owner) const;
+
      public:
+        // Constructor used by make_shared_literal(). See `shared_key` for why this is public.
+        UTF8String(shared_key, const char* string, size_t length);
+
+        // Constructor used by allocate_shared(). On entry, `buffer` points to the storage allocated for the content
+        // (or is null for short strings); on return, it points to the buffer the caller should write the content to.
+        UTF8String(shared_key, size_t length, char*& buffer);
+
+        // The maximum length (in bytes) of strings which are stored inline in the UTF8String object, without a separate
+        // heap allocation for the content.
+        static constexpr size_t INLINE_CAPACITY = 23;
+
         ~UTF8String() override;
 
-        // Returns the backing byte array for this UTF8String. This method is generally to be avoided; it is safer to
-        // use the UTF8String throughout the code and only call this when you really must.
-        [[nodiscard]]
-        const char* bytes() const override;
+        // Objects created by allocate() may have their content stored after the object, in the same allocation. The
+        // memory must therefore be freed without passing the size of the object to the global operator delete, which
+        // in turn means that the matching operator new must be defined as well.
+        static void* operator new(size_t size)
+        {
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* p)
+        {
+            ::operator delete(p);
+        }
 
         // Returns the backing byte array, and releases ownership of it. The caller is now responsible for freeing the
-        // memory.
+        // memory. For strings stored inline, a heap-allocated copy of the content is returned.
         std::unique_ptr<const char[]> release_bytes() override;
 
-        // The length of the string in bytes, excluding the terminating `NUL` character.
-        [[nodiscard]]
-        size_t length() const override;
-
         // Determines if the string is ASCII safe or not. Multiple subsequent calls to this method may return a cached
         // result from a previous run. The first call may use a pre-calculated value, but this is not guaranteed by
         // this method.
@@ -88,6 +273,37 @@ namespace perlang
         [[nodiscard]]
         std::unique_ptr<UTF16String> as_utf16() const override;
 
+        [[nodiscard]]
+        std::unique_ptr<UTF8String> as_utf8() const override;
+
+        [[nodiscard]]
+        std::unique_ptr<String> substring(size_t start, size_t length) const override;
+
+        // Returns the code points of this string, for sequential scans. This is much cheaper than indexing the string
+        // using code_point_at() in a loop, and doesn't need the index which code_point_at() builds for non-ASCII
+        // strings.
+        [[nodiscard]]
+        CodePointRange code_points() const
+        {
+            return { CodePointIterator(bytes_.get(), bytes_.get() + length_), CodePointIterator(bytes_.get() + length_, bytes_.get() + length_) };
+        }
+
+        // Returns the number of code points in this string. For ASCII strings, this is the same as length().
+        [[nodiscard]]
+        size_t code_point_count() const;
+
+        // Returns the code point at the given code point index. Note that this method performs bounds checking;
+        // attempting to read outside the string will result in an exception.
+        //
+        // For ASCII strings, this is a constant-time operation. For other strings, an index of the byte offset of every
+        // CODE_POINT_INDEX_INTERVAL:th code point is built on the first call, after which each call decodes at most
+        // that many code points. The index uses at most one `size_t` per CODE_POINT_INDEX_INTERVAL bytes of content.
+        [[nodiscard]]
+        char32_t code_point_at(size_t index) const;
+
+        // The distance (in code points) between the entries in the index used by code_point_at().
+        static constexpr size_t CODE_POINT_INDEX_INTERVAL = 64;
+
         // Compares the equality of two `UTF8String`s, returning `true` if they point to the same backing byte array
         // and have the same length. Note that this method does *not* compare referential equality; two different
         // `UTF8String` instances pointing at the same backing byte array are considered equal in Perlang. For all
@@ -140,17 +356,36 @@ namespace perlang
         // would unintentionally spread the modifications to these other objects too.
         std::unique_ptr<const char[]> bytes_;
 
-        // The length of the string in bytes, excluding the terminating `NUL` character.
-        size_t length_;
-
         // A flag indicating whether this string owns the memory it points to. If this is true, the string is
         // responsible for deallocating the memory when it is no longer needed. If false, the string is borrowing the
         // memory from somewhere else, and should not deallocate it.
         bool owned_;
 
         // A flag indicating whether this string contains only ASCII characters or not. Characters containing ASCII-only
-        // content can trivially be compared to ASCIIString instances.
-        std::unique_ptr<bool> is_ascii_;
+        // content can trivially be compared to ASCIIString instances. Empty until is_ascii() has been called.
+        std::optional<bool> is_ascii_;
+
+        // True if the content has static lifetime (like a string literal), meaning that it can be borrowed by other
+        // strings without any further bookkeeping.
+        bool static_content_ = false;
+
+        // The string whose content this string shares, for strings created by from_shared_content(). Keeps the content
+        // alive for as long as this string exists.
+        std::shared_ptr<const String> owner_;
+
+        // The index used by code_point_at() for non-ASCII strings. Created on demand, guarded by `code_point_index_once_`
+        // since multiple threads may index the same string.
+        struct CodePointIndex;
+
+        [[nodiscard]]
+        const CodePointIndex& code_point_index() const;
+
+        mutable std::unique_ptr<const CodePointIndex> code_point_index_;
+        mutable std::once_flag code_point_index_once_;
+
+        // Inline storage for short strings (including the terminating `NUL` character). When used, `bytes_` points to
+        // this buffer and `owned_` is false.
+        char inline_bytes_[INLINE_CAPACITY + 1];
     };
 
     // Concatenate an int/long+UTF8String. The memory for the new string is allocated from the heap. This is a free
@@ -179,4 +414,45 @@ namespace perlang
     // function, since the left-hand side is not an UTF8String.
     [[nodiscard]]
     inline std::unique_ptr<UTF8String> operator+(const std::string& lhs, const UTF8String& rhs);
+
+    // The following concat_shared() overloads return the same string types as the corresponding operator+
+    // overloads. See the concat_shared() overloads in perlang_string.h for details.
+
+    // Concatenates two UTF8Strings, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<UTF8String> concat_shared(const UTF8String& lhs, const UTF8String& rhs);
+
+    // Concatenates an int/long+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<UTF8String> concat_shared(int64_t lhs, const UTF8String& rhs);
+
+    // Concatenates a uint/ulong+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<UTF8String> concat_shared(uint64_t lhs, const UTF8String& rhs);
+
+    // Concatenates a float+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<UTF8String> concat_shared(float lhs, const UTF8String& rhs);
+
+    // Concatenates a double+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<UTF8String> concat_shared(double lhs, const UTF8String& rhs);
+
+    // Concatenates a BigInt+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    std::shared_ptr<const String> concat_shared(const BigInt& lhs, const UTF8String& rhs);
+
+    // Concatenates an int32+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    inline std::shared_ptr<UTF8String> concat_shared(int32_t lhs, const UTF8String& rhs)
+    {
+        return concat_shared(static_cast<int64_t>(lhs), rhs);
+    }
+
+    // Concatenates a uint32+UTF8String, using a single heap allocation.
+    [[nodiscard]]
+    inline std::shared_ptr<UTF8String> concat_shared(uint32_t lhs, const UTF8String& rhs)
+    {
+        return concat_shared(static_cast<uint64_t>(lhs), rhs);
+    }
 }
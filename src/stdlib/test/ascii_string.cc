@@ -1,5 +1,7 @@
 // ascii_string.cc - tests for the perlang::ASCIIString class
 
+#include <cstring>
+#include <typeinfo>
 #include <catch2/catch_test_macros.hpp>
 
 #include "perlang_stdlib.h"
@@ -12,3 +14,219 @@ TEST_CASE( "perlang::ASCIIString, throws expected error when initialized with no
     std::shared_ptr<perlang::Object> o = perlang::Object::convert_from(perlang::ASCIIString::from_static_string("this is a string"));
     perlang::print(o);
 }
+
+TEST_CASE( "perlang::ASCIIString, error message contains the index of the first non-ASCII character" )
+{
+    std::string s(100, 'a');
+    s += "åäö";
+
+    // Assert
+    REQUIRE_THROWS_WITH(perlang::ASCIIString::from_copied_string(s.c_str()), "Non-ASCII character encountered at index 100. ASCIIStrings can only contain ASCII characters.");
+}
+
+TEST_CASE( "perlang::ASCIIString::from_copied_string(), copies strings on both sides of the inline capacity" )
+{
+    for (size_t length : { (size_t)0, perlang::ASCIIString::INLINE_CAPACITY, perlang::ASCIIString::INLINE_CAPACITY + 1 }) {
+        std::string original(length, 'a');
+        std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_copied_string(original.c_str());
+
+        // Assert
+        REQUIRE(s->length() == length);
+        REQUIRE(std::string(s->bytes()) == original);
+    }
+}
+
+TEST_CASE( "perlang::ASCIIString::release_bytes(), returns a heap-allocated copy for short strings" )
+{
+    std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_copied_string("short");
+    const char* inline_bytes = s->bytes();
+
+    std::unique_ptr<const char[]> bytes = s->release_bytes();
+
+    // Assert
+    REQUIRE(bytes.get() != inline_bytes);
+    REQUIRE(std::string(bytes.get()) == "short");
+}
+
+TEST_CASE( "perlang::ASCIIString::release_bytes(), hands over the buffer for owned strings" )
+{
+    const char* content = "this string is too long to be stored inline";
+    char* heap_bytes = new char[strlen(content) + 1];
+    strcpy(heap_bytes, content);
+
+    std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_owned_string(heap_bytes, strlen(content));
+
+    std::unique_ptr<const char[]> bytes = s->release_bytes();
+
+    // Assert
+    REQUIRE(bytes.get() == heap_bytes);
+    REQUIRE(std::string(bytes.get()) == content);
+}
+
+TEST_CASE( "perlang::ASCIIString::release_bytes(), returns a heap-allocated copy for long copied strings" )
+{
+    std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_copied_string("this string is too long to be stored inline");
+    const char* trailing_bytes = s->bytes();
+
+    std::unique_ptr<const char[]> bytes = s->release_bytes();
+
+    // Assert
+    REQUIRE(bytes.get() != trailing_bytes);
+    REQUIRE(std::string(bytes.get()) == "this string is too long to be stored inline");
+}
+
+TEST_CASE( "perlang::ASCIIString::operator+, concatenates strings across the inline capacity boundary" )
+{
+    std::unique_ptr<perlang::ASCIIString> s1 = perlang::ASCIIString::from_copied_string("abcdefghijkl");
+    std::unique_ptr<perlang::ASCIIString> s2 = perlang::ASCIIString::from_copied_string("mnopqrstuvw");
+
+    // 12 + 11 bytes fits inline, while 12 + 12 bytes does not.
+    REQUIRE(std::string((*s1 + *s2)->bytes()) == "abcdefghijklmnopqrstuvw");
+    REQUIRE(std::string((*s1 + *s1)->bytes()) == "abcdefghijklabcdefghijkl");
+}
+
+TEST_CASE( "perlang::ASCIIString::operator+, converts UTF16String content" )
+{
+    std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_static_string("ab");
+    std::unique_ptr<perlang::UTF16String> ascii = perlang::UTF16String::from_copied_string("cd");
+    std::unique_ptr<perlang::UTF16String> non_ascii = perlang::UTF16String::from_copied_string("å€");
+
+    std::unique_ptr<perlang::String> ascii_result = *s + *ascii;
+    std::unique_ptr<perlang::String> non_ascii_result = *s + *non_ascii;
+
+    // Assert
+    REQUIRE(ascii_result->length() == 4);
+    REQUIRE(std::string(ascii_result->bytes()) == "abcd");
+    REQUIRE(non_ascii_result->length() == 7);
+    REQUIRE(std::string(non_ascii_result->bytes()) == "abå€");
+}
+
+TEST_CASE( "perlang::concat_shared(), with ASCIIString operands" )
+{
+    std::unique_ptr<perlang::ASCIIString> s1 = perlang::ASCIIString::from_copied_string("abcdefghijkl");
+    std::unique_ptr<perlang::ASCIIString> s2 = perlang::ASCIIString::from_copied_string("mnopqrstuvw");
+    BigInt bigint("-123456789012345678901234567890");
+
+    std::shared_ptr<perlang::ASCIIString> result = perlang::concat_shared(*s1, *s2);
+    std::shared_ptr<const perlang::ASCIIString> int_result = perlang::concat_shared((int32_t)-42, *s1);
+    std::shared_ptr<const perlang::String> bigint_result = perlang::concat_shared(bigint, *s2);
+
+    // Assert
+    REQUIRE(std::string(result->bytes()) == "abcdefghijklmnopqrstuvw");
+    REQUIRE(result->to_string().get() == result.get());
+    REQUIRE(std::string(int_result->bytes()) == "-42abcdefghijkl");
+    REQUIRE(*perlang::concat_shared((uint64_t)18446744073709551615U, *s2) == *((uint64_t)18446744073709551615U + *s2));
+    REQUIRE(*perlang::concat_shared(2.5f, *s2) == *(2.5f + *s2));
+    REQUIRE(*perlang::concat_shared(0.1, *s2) == *(0.1 + *s2));
+    REQUIRE(typeid(*bigint_result) == typeid(perlang::ASCIIString));
+    REQUIRE(std::string(bigint_result->bytes()) == "-123456789012345678901234567890mnopqrstuvw");
+}
+
+TEST_CASE( "perlang::ASCIIString::from_literal(), borrows the literal and determines its length at compile time" )
+{
+    static const char literal[] = "this is a literal";
+    std::unique_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_literal(literal);
+
+    // Assert
+    REQUIRE(s->bytes() == literal);
+    REQUIRE(s->length() == 17);
+    REQUIRE(*s == *perlang::ASCIIString::from_static_string("this is a literal"));
+}
+
+TEST_CASE( "perlang::ASCIIString::make_shared_copy(), copies strings on both sides of the inline capacity" )
+{
+    for (size_t length : { (size_t)0, perlang::ASCIIString::INLINE_CAPACITY, perlang::ASCIIString::INLINE_CAPACITY + 1, (size_t)1000 }) {
+        std::string original(length, 'a');
+        std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_copy(original.c_str(), original.length());
+
+        // Assert
+        REQUIRE(s->length() == length);
+        REQUIRE(std::string(s->bytes()) == original);
+        REQUIRE(s->bytes() != original.c_str());
+    }
+}
+
+TEST_CASE( "perlang::ASCIIString::make_shared_copy(), throws expected error when given non-ASCII content" )
+{
+    std::string s = "åäö";
+
+    // Assert
+    REQUIRE_THROWS_AS(perlang::ASCIIString::make_shared_copy(s.c_str(), s.length()), std::invalid_argument);
+}
+
+TEST_CASE( "perlang::ASCIIString::make_shared_copy(), returns a string which can be shared" )
+{
+    std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_copy("this string is too long to be stored inline", 43);
+
+    // Assert
+    REQUIRE(s->to_string().get() == s.get());
+}
+
+TEST_CASE( "perlang::ASCIIString::make_shared_literal(), borrows the literal" )
+{
+    static const char literal[] = "this is a literal";
+    std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_literal(literal);
+
+    // Assert
+    REQUIRE(s->bytes() == literal);
+    REQUIRE(s->length() == 17);
+}
+
+TEST_CASE( "perlang::ASCIIString::release_bytes(), returns a heap-allocated copy for shared strings" )
+{
+    std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_copy("this string is too long to be stored inline", 43);
+    const char* shared_bytes = s->bytes();
+
+    std::unique_ptr<const char[]> bytes = s->release_bytes();
+
+    // Assert
+    REQUIRE(bytes.get() != shared_bytes);
+    REQUIRE(std::string(bytes.get()) == "this string is too long to be stored inline");
+}
+
+TEST_CASE( "perlang::ASCIIString::as_ascii(), shares static content" )
+{
+    auto s = perlang::ASCIIString::from_static_string("a string which is too long to be stored inline");
+
+    REQUIRE(s->as_ascii()->bytes() == s->bytes());
+    REQUIRE(s->as_utf8()->bytes() == s->bytes());
+}
+
+TEST_CASE( "perlang::ASCIIString::as_ascii(), shares the content of strings owned by a shared_ptr" )
+{
+    std::string content(100, 'x');
+    std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_copy(content.c_str(), content.length());
+    const char* bytes = s->bytes();
+
+    auto ascii = s->as_ascii();
+    auto utf8 = s->as_utf8();
+    s.reset();
+
+    // The content is kept alive by the converted strings.
+    REQUIRE(ascii->bytes() == bytes);
+    REQUIRE(utf8->bytes() == bytes);
+    REQUIRE(std::string(ascii->bytes()) == content);
+    REQUIRE(utf8->is_ascii());
+}
+
+TEST_CASE( "perlang::ASCIIString::as_ascii(), copies strings which are not owned by a shared_ptr" )
+{
+    std::string content(100, 'x');
+    auto s = perlang::ASCIIString::from_copied_string(content.c_str());
+
+    auto ascii = s->as_ascii();
+
+    REQUIRE(ascii->bytes() != s->bytes());
+    REQUIRE(*ascii == *s);
+}
+
+TEST_CASE( "perlang::ASCIIString::as_utf16(), widens the content" )
+{
+    auto s = perlang::ASCIIString::from_static_string("hello");
+
+    auto utf16 = s->as_utf16();
+
+    REQUIRE(utf16->length() == 5);
+    REQUIRE((*utf16)[4] == u'o');
+    REQUIRE(*utf16 == *s);
+}
@@ -0,0 +1,781 @@
+// benchmarks.cc - throughput benchmarks for performance-sensitive parts of the stdlib
+//
+// These are built as a separate `benchmarks` executable, since they take a while to run and their results are only
+// interesting when looked at by a human. Run them using `make benchmark-stdlib`, or by passing "[benchmark]" to the
+// benchmarks executable.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <new>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+#include "internal/ascii.h"
+#include "internal/case_mapping.h"
+#include "internal/hashing.h"
+#include "internal/string_comparison.h"
+#include "internal/string_search.h"
+#include "internal/transcoding.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+// The number of heap allocations made by the benchmarks executable so far. Used by the benchmarks to report the number of
+// allocations per operation, which is often a better indicator of performance than the raw timings for small strings.
+static std::atomic<size_t> allocation_count;
+
+// The number of bytes allocated on the heap so far. For conversions between string types, this is a good approximation
+// of the number of bytes copied, since the content is always copied to a newly allocated buffer.
+static std::atomic<size_t> allocated_bytes;
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* ptr = malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+namespace
+{
+    // Large enough to not fit in the L2 cache of most CPUs, to get a realistic idea of the throughput for the kind of
+    // multi-megabyte payloads we want to be able to handle.
+    constexpr size_t BENCHMARK_BUFFER_SIZE = 8 * 1024 * 1024;
+
+    // Sink for benchmark results, to prevent the compiler from optimizing away the code being measured.
+    volatile size_t benchmark_sink;
+
+    // Runs `func` repeatedly for a fixed amount of time and prints the throughput, based on the given number of bytes
+    // being processed per invocation.
+    template <typename Func>
+    void report_throughput(const std::string& name, size_t bytes_per_iteration, Func&& func)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Warm up caches and let the CPU settle on a stable frequency before we start measuring.
+        benchmark_sink = func();
+
+        size_t iterations = 0;
+        auto start = clock::now();
+        std::chrono::duration<double> elapsed {};
+
+        do {
+            benchmark_sink = func();
+            iterations++;
+            elapsed = clock::now() - start;
+        }
+        while (elapsed < std::chrono::milliseconds(250));
+
+        double gigabytes = (double)bytes_per_iteration * (double)iterations / 1e9;
+        printf("%-60s %8.2f GB/s\n", name.c_str(), gigabytes / elapsed.count());
+    }
+
+    // Runs `func` repeatedly for a fixed amount of time and prints the time and the number of heap allocations per
+    // invocation.
+    template <typename Func>
+    void report_allocations(const std::string& name, Func&& func)
+    {
+        using clock = std::chrono::steady_clock;
+
+        benchmark_sink = func();
+
+        size_t iterations = 0;
+        size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        std::chrono::duration<double, std::nano> elapsed {};
+
+        // Many of the operations measured here are so cheap that reading the clock after each of them would distort the
+        // results, so we read it after each batch of operations instead.
+        do {
+            for (size_t i = 0; i < 100; i++) {
+                benchmark_sink = func();
+            }
+
+            iterations += 100;
+            elapsed = clock::now() - start;
+        }
+        while (elapsed < std::chrono::milliseconds(250));
+
+        size_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+
+        printf("%-60s %10.2f ns/op %8.2f allocs/op\n", name.c_str(), elapsed.count() / (double)iterations, (double)allocations / (double)iterations);
+    }
+
+    // Runs `func` repeatedly for a fixed amount of time and prints the time, the number of heap allocations and the
+    // number of bytes allocated per invocation.
+    template <typename Func>
+    void report_copies(const std::string& name, Func&& func)
+    {
+        using clock = std::chrono::steady_clock;
+
+        benchmark_sink = func();
+
+        size_t iterations = 0;
+        size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+        size_t bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+        auto start = clock::now();
+        std::chrono::duration<double, std::nano> elapsed {};
+
+        do {
+            for (size_t i = 0; i < 100; i++) {
+                benchmark_sink = func();
+            }
+
+            iterations += 100;
+            elapsed = clock::now() - start;
+        }
+        while (elapsed < std::chrono::milliseconds(250));
+
+        size_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+        size_t bytes = allocated_bytes.load(std::memory_order_relaxed) - bytes_before;
+
+        printf("%-60s %10.2f ns/op %8.2f allocs/op %10.1f bytes/op\n", name.c_str(), elapsed.count() / (double)iterations, (double)allocations / (double)iterations, (double)bytes / (double)iterations);
+    }
+}
+
+TEST_CASE( "benchmark: ASCII validation", "[.benchmark]" )
+{
+    std::string ascii_content(BENCHMARK_BUFFER_SIZE, 'a');
+    std::vector<uint16_t> utf16_content(BENCHMARK_BUFFER_SIZE / 2, 'a');
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("find_non_ascii, bytes, ") + perlang::internal::simd_level_name(level), ascii_content.length(), [&] {
+            return perlang::internal::find_non_ascii(ascii_content.data(), ascii_content.length(), level);
+        });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("find_non_ascii, UTF-16, ") + perlang::internal::simd_level_name(level), utf16_content.size() * 2, [&] {
+            return perlang::internal::find_non_ascii(utf16_content.data(), utf16_content.size(), level);
+        });
+    }
+
+    report_throughput("ASCIIString::from_static_string", ascii_content.length(), [&] {
+        return perlang::ASCIIString::from_static_string(ascii_content.c_str())->length();
+    });
+
+    report_throughput("UTF8String::is_ascii", ascii_content.length(), [&] {
+        // A new string is needed for each iteration, since the result of is_ascii() is cached.
+        return (size_t)perlang::UTF8String::from_static_string(ascii_content.c_str())->is_ascii();
+    });
+}
+
+TEST_CASE( "benchmark: UTF-8 to UTF-16 transcoding", "[.benchmark]" )
+{
+    std::string ascii_content(BENCHMARK_BUFFER_SIZE, 'a');
+    std::string mixed_content;
+
+    while (mixed_content.length() < BENCHMARK_BUFFER_SIZE) {
+        mixed_content += "Some mostly ASCII text, with the occasional non-ASCII character: åäö. ";
+    }
+
+    std::vector<uint16_t> output(BENCHMARK_BUFFER_SIZE);
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf16_length_from_utf8, ") + perlang::internal::simd_level_name(level), mixed_content.length(), [&] {
+            return perlang::internal::utf16_length_from_utf8(mixed_content.data(), mixed_content.length(), level);
+        });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf8_to_utf16, ASCII, ") + perlang::internal::simd_level_name(level), ascii_content.length(), [&] {
+            return perlang::internal::utf8_to_utf16(ascii_content.data(), ascii_content.length(), output.data(), level);
+        });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf8_to_utf16, mixed, ") + perlang::internal::simd_level_name(level), mixed_content.length(), [&] {
+            return perlang::internal::utf8_to_utf16(mixed_content.data(), mixed_content.length(), output.data(), level);
+        });
+    }
+
+    report_throughput("UTF8String::as_utf16, mixed", mixed_content.length(), [&] {
+        return perlang::UTF8String::from_static_string(mixed_content.c_str())->as_utf16()->length();
+    });
+}
+
+TEST_CASE( "benchmark: UTF-16 to UTF-8 transcoding", "[.benchmark]" )
+{
+    std::string mixed_content;
+
+    while (mixed_content.length() < BENCHMARK_BUFFER_SIZE) {
+        mixed_content += "Some mostly ASCII text, with the occasional non-ASCII character: åäö. ";
+    }
+
+    auto ascii_content = std::vector<uint16_t>(BENCHMARK_BUFFER_SIZE, 'a');
+    auto mixed_utf16 = perlang::UTF8String::from_static_string(mixed_content.c_str())->as_utf16();
+    auto mixed_data = (const uint16_t*)mixed_utf16->bytes();
+
+    std::vector<char> output(BENCHMARK_BUFFER_SIZE * 3);
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf8_length_from_utf16, ") + perlang::internal::simd_level_name(level), mixed_utf16->length() * 2, [&] {
+            return perlang::internal::utf8_length_from_utf16(mixed_data, mixed_utf16->length(), level);
+        });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf16_to_utf8, ASCII, ") + perlang::internal::simd_level_name(level), ascii_content.size() * 2, [&] {
+            return perlang::internal::utf16_to_utf8(ascii_content.data(), ascii_content.size(), output.data(), level);
+        });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("utf16_to_utf8, mixed, ") + perlang::internal::simd_level_name(level), mixed_utf16->length() * 2, [&] {
+            return perlang::internal::utf16_to_utf8(mixed_data, mixed_utf16->length(), output.data(), level);
+        });
+    }
+
+    report_throughput("UTF16String::as_utf8, mixed", mixed_utf16->length() * 2, [&] {
+        return mixed_utf16->as_utf8()->length();
+    });
+}
+
+TEST_CASE( "benchmark: short string operations", "[.benchmark]" )
+{
+    auto ascii_identifier = perlang::ASCIIString::from_static_string("identifier");
+    auto utf8_identifier = perlang::UTF8String::from_static_string("identå");
+
+    report_allocations("ASCIIString::from_copied_string, short", [&] {
+        return perlang::ASCIIString::from_copied_string("some_identifier")->length();
+    });
+
+    report_allocations("UTF8String::from_copied_string, short", [&] {
+        return perlang::UTF8String::from_copied_string("some_identifier")->length();
+    });
+
+    report_allocations("ASCIIString + ASCIIString, short", [&] {
+        return (*ascii_identifier + *ascii_identifier)->length();
+    });
+
+    report_allocations("UTF8String + UTF8String, short", [&] {
+        return (*utf8_identifier + *utf8_identifier)->length();
+    });
+
+    report_allocations("ASCIIString + int64_t, short", [&] {
+        return (*ascii_identifier + (int64_t)1234567)->length();
+    });
+
+    report_allocations("ASCIIString::from_static_string, per use", [&] {
+        return perlang::ASCIIString::from_static_string("some_identifier")->length();
+    });
+
+    // This is what the code generated by the Perlang compiler does for string literals.
+    static const std::shared_ptr<perlang::ASCIIString> hoisted_literal = perlang::ASCIIString::make_shared_literal("some_identifier");
+
+    report_allocations("ASCIIString::make_shared_literal, hoisted", [&] {
+        std::shared_ptr<perlang::ASCIIString> s = hoisted_literal;
+        return s->length();
+    });
+
+    report_allocations("UTF8String::is_ascii, new string", [&] {
+        return (size_t)perlang::UTF8String::from_copied_string("some_identifier")->is_ascii();
+    });
+}
+
+TEST_CASE( "benchmark: chained string concatenation", "[.benchmark]" )
+{
+    std::shared_ptr<perlang::String> part = perlang::ASCIIString::from_static_string("some part of a longer string, ");
+
+    for (size_t parts : { 10, 100, 1000, 10000 }) {
+        report_allocations("concatenating " + std::to_string(parts) + " parts", [&] {
+            std::unique_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("");
+
+            for (size_t i = 0; i < parts; i++) {
+                s = *s + *part;
+            }
+
+            return (size_t)s->bytes()[0] + s->length();
+        });
+    }
+}
+
+TEST_CASE( "benchmark: string hashing", "[.benchmark]" )
+{
+    std::vector<char> buffer(BENCHMARK_BUFFER_SIZE, 'a');
+
+    report_throughput("hash_bytes, large buffer", buffer.size(), [&] {
+        return (size_t)perlang::internal::hash_bytes(buffer.data(), buffer.size());
+    });
+
+    for (size_t length : { 8, 16, 32, 64 }) {
+        report_allocations("hash_bytes, " + std::to_string(length) + " bytes", [&] {
+            return (size_t)perlang::internal::hash_bytes(buffer.data(), length);
+        });
+    }
+}
+
+TEST_CASE( "benchmark: string hash set lookups", "[.benchmark]" )
+{
+    // Roughly the size of the keyword table in the Perlang scanner.
+    std::vector<std::shared_ptr<perlang::String>> keys;
+    perlang::collections::MutableStringHashSet set;
+
+    for (size_t i = 0; i < 64; i++) {
+        keys.push_back(perlang::ASCIIString::from_copied_string(("keyword_" + std::to_string(i)).c_str()));
+        set.add(keys.back());
+    }
+
+    tsl::ordered_set<std::shared_ptr<perlang::String>, string_hasher, string_comparer> keys_set(keys.begin(), keys.end());
+    std::shared_ptr<perlang::String> missing_key = perlang::ASCIIString::from_static_string("not_a_keyword");
+    size_t index = 0;
+
+    report_allocations("lookup of existing key, same instance", [&] {
+        return keys_set.count(keys[index++ % keys.size()]);
+    });
+
+    report_allocations("lookup of missing key, same instance", [&] {
+        return keys_set.count(missing_key);
+    });
+
+    report_allocations("MutableStringHashSet::contains(const char*)", [&] {
+        return (size_t)set.contains("keyword_42");
+    });
+}
+
+TEST_CASE( "benchmark: substrings", "[.benchmark]" )
+{
+    std::string content(65536 + 100, 'a');
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_copied_string(content.c_str());
+
+    for (size_t length : { 16, 100, 1000, 4000, 65536 }) {
+        report_allocations("copying " + std::to_string(length) + " bytes of a string", [&] {
+            return perlang::UTF8String::from_copied_string(s->bytes() + 100, length)->length();
+        });
+
+        report_allocations("String::substring, " + std::to_string(length) + " bytes", [&] {
+            return s->substring(100, length)->length();
+        });
+    }
+}
+
+TEST_CASE( "benchmark: shared strings", "[.benchmark]" )
+{
+    for (size_t length : { 15, 100, 1000 }) {
+        std::string content(length, 'a');
+
+        report_allocations("shared_ptr from from_copied_string(), " + std::to_string(length) + " bytes", [&] {
+            std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::from_copied_string(content.c_str());
+            return s->length();
+        });
+
+        report_allocations("ASCIIString::make_shared_copy, " + std::to_string(length) + " bytes", [&] {
+            std::shared_ptr<perlang::ASCIIString> s = perlang::ASCIIString::make_shared_copy(content.c_str(), content.length());
+            return s->length();
+        });
+    }
+
+    auto prefix = perlang::ASCIIString::from_static_string("a string which is too long to be stored inline: ");
+
+    report_allocations("shared_ptr from ASCIIString + ASCIIString", [&] {
+        std::shared_ptr<perlang::ASCIIString> s = *prefix + *prefix;
+        return s->length();
+    });
+
+    report_allocations("concat_shared(ASCIIString, ASCIIString)", [&] {
+        std::shared_ptr<perlang::ASCIIString> s = perlang::concat_shared(*prefix, *prefix);
+        return s->length();
+    });
+
+    report_allocations("concat_shared(ASCIIString, int64_t)", [&] {
+        std::shared_ptr<perlang::String> s = perlang::concat_shared(*prefix, (int64_t)1234567);
+        return s->length();
+    });
+}
+
+TEST_CASE( "benchmark: concatenating strings with numbers", "[.benchmark]" )
+{
+    auto ascii_prefix = perlang::ASCIIString::from_static_string("id=");
+    auto utf8_prefix = perlang::UTF8String::from_static_string("nummer=");
+
+    report_allocations("ASCIIString + int64_t", [&] {
+        return (*ascii_prefix + (int64_t)1234567)->length();
+    });
+
+    report_allocations("int64_t + ASCIIString", [&] {
+        return ((int64_t)-1234567 + *ascii_prefix)->length();
+    });
+
+    report_allocations("UTF8String + uint64_t", [&] {
+        return (*utf8_prefix + (uint64_t)18446744073709551615U)->length();
+    });
+
+    report_allocations("ASCIIString + double", [&] {
+        return (*ascii_prefix + 3.141592653589793)->length();
+    });
+
+    report_allocations("ASCIIString + float", [&] {
+        return (*ascii_prefix + 2.5f)->length();
+    });
+}
+
+TEST_CASE( "benchmark: number parsing", "[.benchmark]" )
+{
+    std::string integers;
+    std::string doubles;
+
+    for (int i = 0; i < 100000; i++) {
+        integers += std::to_string(i * 7919 - 50000000) + ",";
+        doubles += std::to_string(i * 0.731) + "\n";
+    }
+
+    std::shared_ptr<perlang::String> integer_list = perlang::ASCIIString::from_copied_string(integers.c_str());
+    std::shared_ptr<perlang::String> double_list = perlang::ASCIIString::from_copied_string(doubles.c_str());
+
+    report_throughput("Int32::parse_array", integers.length(), [&] {
+        return perlang::Int32::parse_array(*integer_list)->length();
+    });
+
+    report_throughput("Double::parse_array", doubles.length(), [&] {
+        return perlang::Double::parse_array(*double_list, '\n')->length();
+    });
+
+    std::shared_ptr<perlang::String> single = perlang::ASCIIString::from_static_string("-1234567");
+
+    report_allocations("Int32::parse, 8 characters", [&] {
+        return (size_t)perlang::Int32::parse(*single);
+    });
+}
+
+TEST_CASE( "benchmark: string search", "[.benchmark]" )
+{
+    // A haystack where the first byte of the needle is common, but the needle itself only occurs at the very end. This
+    // is the worst case for a search based on memchr() of the first byte only.
+    std::string haystack;
+
+    while (haystack.length() < 1024 * 1024) {
+        haystack += "the quick brown fox jumps over the lazy dog; ";
+    }
+
+    haystack += "the needle";
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("find, 10-byte needle, ") + perlang::internal::simd_level_name(level), haystack.length(), [&] {
+            return perlang::internal::find(haystack.data(), haystack.length(), "the needle", 10, level);
+        });
+    }
+
+    report_throughput("std::string::find, 10-byte needle", haystack.length(), [&] {
+        return haystack.find("the needle");
+    });
+
+    std::shared_ptr<perlang::String> content = perlang::ASCIIString::from_copied_string(haystack.c_str());
+    std::shared_ptr<perlang::String> separator = perlang::ASCIIString::from_static_string("; ");
+    std::shared_ptr<perlang::String> replacement = perlang::ASCIIString::from_static_string("\n");
+
+    report_throughput("String::split", haystack.length(), [&] {
+        return content->split(*separator)->length();
+    });
+
+    report_throughput("String::replace", haystack.length(), [&] {
+        return content->replace(*separator, *replacement)->length();
+    });
+}
+
+TEST_CASE( "benchmark: cross-encoding comparison", "[.benchmark]" )
+{
+    std::string ascii_content(64 * 1024, 'x');
+    std::string utf8_content;
+
+    while (utf8_content.length() < 64 * 1024) {
+        utf8_content += "Räksmörgås med ägg och majonnäs. ";
+    }
+
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_copied_string(ascii_content.c_str());
+    std::shared_ptr<perlang::String> ascii_utf16 = ascii->as_utf16();
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_copied_string(utf8_content.c_str());
+    std::shared_ptr<perlang::String> utf8_utf16 = utf8->as_utf16();
+
+    for (auto level : supported_simd_levels()) {
+        report_throughput(std::string("mismatch_ascii_utf16, ") + perlang::internal::simd_level_name(level), ascii_content.length(), [&] {
+            return perlang::internal::mismatch_ascii_utf16(ascii->bytes(), reinterpret_cast<const uint16_t*>(ascii_utf16->bytes()), ascii->length(), level);
+        });
+    }
+
+    report_throughput("ASCIIString == UTF16String", ascii_content.length(), [&] {
+        return (size_t)(*ascii == *ascii_utf16);
+    });
+
+    report_throughput("UTF8String == UTF16String", utf8_content.length(), [&] {
+        return (size_t)(*utf8 == *utf8_utf16);
+    });
+
+    report_throughput("UTF8String == UTF16String, via as_utf8()", utf8_content.length(), [&] {
+        return (size_t)(*utf8 == *utf8_utf16->as_utf8());
+    });
+
+    perlang::collections::MutableStringHashSet keywords;
+
+    for (const char* keyword : { "class", "else", "false", "for", "fun", "if", "nil", "or", "print", "return", "true", "var", "while" }) {
+        keywords.add(keyword);
+    }
+
+    std::shared_ptr<perlang::String> identifier = perlang::UTF8String::from_static_string("while")->as_utf16();
+
+    report_allocations("MutableStringHashSet::contains(UTF16String)", [&] {
+        return (size_t)keywords.contains(identifier);
+    });
+}
+
+TEST_CASE( "benchmark: string conversions", "[.benchmark]" )
+{
+    std::string content(4096, 'x');
+
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::make_shared_copy(content.c_str(), content.length());
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::make_shared_copy(content.c_str(), content.length());
+    std::shared_ptr<perlang::String> slice = ascii->substring(1024, 3072);
+
+    // Converting a shared string to its own representation (or to a compatible one) shares the content, so the
+    // allocated bytes should only cover the new string object.
+    report_copies("ASCIIString::as_ascii(), 4 KiB", [&] {
+        return ascii->as_ascii()->length();
+    });
+
+    report_copies("ASCIIString::as_utf8(), 4 KiB", [&] {
+        return ascii->as_utf8()->length();
+    });
+
+    report_copies("UTF8String::as_ascii(), 4 KiB", [&] {
+        return utf8->as_ascii()->length();
+    });
+
+    report_copies("UTF8String::as_utf8(), 4 KiB", [&] {
+        return utf8->as_utf8()->length();
+    });
+
+    report_copies("StringSlice::as_ascii(), 3 KiB", [&] {
+        return slice->as_ascii()->length();
+    });
+
+    report_copies("ASCIIString::as_utf16(), 4 KiB", [&] {
+        return ascii->as_utf16()->length();
+    });
+}
+
+TEST_CASE( "benchmark: compact UTF-16 strings", "[.benchmark]" )
+{
+    // Resembles the source code fed to the scanner: mostly ASCII, with a line break every 64 characters. The "wide"
+    // variant has a single character outside of the Latin-1 range at the end, which prevents it from being compact.
+    std::string content;
+
+    while (content.length() < 1024 * 1024) {
+        content += std::string(63, 'x') + "\n";
+    }
+
+    std::shared_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string(content.c_str(), content.length());
+    std::shared_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string((content + "€").c_str());
+
+    auto count_lines = [](const perlang::UTF16String& s) {
+        size_t lines = 0;
+        size_t length = s.length();
+
+        for (size_t i = 0; i < length; i++) {
+            lines += s[i] == u'\n';
+        }
+
+        return lines;
+    };
+
+    // The throughput is reported in characters rather than bytes, so that the two representations can be compared.
+    report_throughput("UTF16String::operator[], compact, 1 Mchar", compact->length(), [&] {
+        return count_lines(*compact);
+    });
+
+    report_throughput("UTF16String::operator[], non-compact, 1 Mchar", wide->length(), [&] {
+        return count_lines(*wide);
+    });
+
+    report_copies("UTF8String::as_utf16(), compact, 1 Mchar", [&] {
+        return perlang::UTF8String::from_copied_string(content.c_str())->as_utf16()->length();
+    });
+
+    report_copies("UTF8String::as_utf16(), non-compact, 1 Mchar", [&] {
+        return perlang::UTF8String::from_copied_string((content + "€").c_str())->as_utf16()->length();
+    });
+}
+
+TEST_CASE( "benchmark: UTF-8 code point access", "[.benchmark]" )
+{
+    // Mostly ASCII text with a sprinkling of non-ASCII characters, like typical Swedish prose.
+    std::string content;
+
+    while (content.length() < 1024 * 1024) {
+        content += "En räksmörgås är gott, även på en måndag. ";
+    }
+
+    std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::make_shared_copy(content.c_str(), content.length());
+    size_t count = s->code_point_count();
+
+    report_throughput("UTF8String::code_points(), 1 MiB", content.length(), [&] {
+        size_t sum = 0;
+
+        for (char32_t c : s->code_points()) {
+            sum += c;
+        }
+
+        return sum;
+    });
+
+    report_allocations("UTF8String::code_point_at(), random index", [&, i = size_t { 0 }]() mutable {
+        i = (i + 7919) % count;
+        return (size_t)s->code_point_at(i);
+    });
+
+    report_allocations("UTF8String::as_utf16(), then index (previous approach)", [&, i = size_t { 0 }]() mutable {
+        i = (i + 7919) % count;
+        return (size_t)(*s->as_utf16())[i];
+    });
+}
+
+TEST_CASE( "benchmark: case conversion", "[.benchmark]" )
+{
+    std::string ascii_content;
+    std::string mixed_content;
+
+    while (ascii_content.length() < 1024 * 1024) {
+        ascii_content += "The Quick Brown Fox Jumps Over The Lazy Dog. ";
+        mixed_content += "En Räksmörgås Är Gott, Även På En Måndag. ";
+    }
+
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::make_shared_copy(ascii_content.c_str(), ascii_content.length());
+    std::shared_ptr<perlang::String> mixed = perlang::UTF8String::make_shared_copy(mixed_content.c_str(), mixed_content.length());
+
+    for (auto level : supported_simd_levels()) {
+        std::string output(ascii_content.length(), '\0');
+
+        report_throughput(std::string("ascii_to_upper, ") + perlang::internal::simd_level_name(level), ascii_content.length(), [&] {
+            perlang::internal::ascii_to_upper(ascii_content.data(), ascii_content.length(), output.data(), level);
+            return (size_t)output[0];
+        });
+    }
+
+    report_throughput("String::to_upper(), ASCIIString, 1 MiB", ascii->length(), [&] {
+        return ascii->to_upper()->length();
+    });
+
+    report_throughput("String::to_upper(), UTF8String (Swedish text), 1 MiB", mixed->length(), [&] {
+        return mixed->to_upper()->length();
+    });
+
+    report_throughput("Char::to_upper(), 1 Mchar", ascii_content.length(), [&] {
+        size_t sum = 0;
+
+        for (char c : ascii_content) {
+            sum += perlang::Char::to_upper(c);
+        }
+
+        return sum;
+    });
+
+    report_throughput("std::towupper() (previous implementation), 1 Mchar", ascii_content.length(), [&] {
+        size_t sum = 0;
+
+        for (char c : ascii_content) {
+            sum += std::towupper(c);
+        }
+
+        return sum;
+    });
+}
+
+TEST_CASE( "benchmark: StringBuilder", "[.benchmark]" )
+{
+    auto part = perlang::ASCIIString::from_static_string("a line of text, ");
+    constexpr size_t total_length = 16 * 1024 * 1024;
+
+    // Building a large string out of many small parts. Growing the buffer by a fixed amount made this quadratic.
+    report_throughput("StringBuilder::append(), 16-byte parts up to 16 MiB", total_length, [&] {
+        perlang::text::StringBuilder sb;
+
+        while (sb.length() < total_length) {
+            sb.append(*part);
+        }
+
+        return sb.length();
+    });
+
+    report_throughput("StringBuilder::append(), reserved, 16-byte parts up to 16 MiB", total_length, [&] {
+        perlang::text::StringBuilder sb(total_length);
+
+        while (sb.length() < total_length) {
+            sb.append(*part);
+        }
+
+        return sb.length();
+    });
+
+    // Getting the result out of the builder: to_string() copies the content, release_string() hands it over.
+    report_throughput("StringBuilder::to_string(), 16 MiB", total_length, [&] {
+        perlang::text::StringBuilder sb(total_length);
+        sb.append_repeat('x', total_length);
+
+        return sb.to_string()->length();
+    });
+
+    report_throughput("StringBuilder::release_string(), 16 MiB", total_length, [&] {
+        perlang::text::StringBuilder sb(total_length);
+        sb.append_repeat('x', total_length);
+
+        return sb.release_string()->length();
+    });
+
+    // Producing output without keeping all of it in memory. StreamWriter writes it in 64 KiB chunks, in constant memory.
+    FILE* null_file = fopen("/dev/null", "w");
+
+    report_throughput("StreamWriter::append(), 16-byte parts up to 16 MiB, to /dev/null", total_length, [&] {
+        perlang::text::StreamWriter writer(fileno(null_file));
+
+        while (writer.bytes_written() < total_length) {
+            writer.append(*part);
+        }
+
+        writer.flush();
+
+        return writer.bytes_written();
+    });
+
+    fclose(null_file);
+
+    report_allocations("StringBuilder, short string", [&] {
+        perlang::text::StringBuilder sb;
+        sb.append(*part);
+        sb.append(*part);
+
+        return sb.to_string()->length();
+    });
+
+    // Formatting values directly into the buffer. This should make no heap allocations at all, since the result fits in
+    // the inline buffer.
+    report_allocations("StringBuilder::append(), formatted values", [&] {
+        perlang::text::StringBuilder sb;
+        sb.append(int32_t { 12345 });
+        sb.append(',');
+        sb.append(int64_t { -9876543210 });
+        sb.append(',');
+        sb.append(3.14159);
+        sb.append(',');
+        sb.append(true);
+        sb.append_line();
+
+        return sb.length();
+    });
+}
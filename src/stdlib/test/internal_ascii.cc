@@ -0,0 +1,75 @@
+// internal_ascii.cc - tests for the ASCII validation kernels in perlang::internal
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/ascii.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+TEST_CASE( "perlang::internal::find_non_ascii, returns length for ASCII-only content of varying lengths" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t length = 0; length < 600; length++) {
+            std::string s(length, 'a');
+
+            // Assert
+            REQUIRE(perlang::internal::find_non_ascii(s.data(), s.length(), level) == length);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::find_non_ascii, finds a non-ASCII byte at every position" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t position = 0; position < 300; position++) {
+            std::string s(300, 'a');
+            s[position] = (char)0xC3;
+
+            // Assert
+            REQUIRE(perlang::internal::find_non_ascii(s.data(), s.length(), level) == position);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::find_non_ascii, finds the first of multiple non-ASCII bytes" )
+{
+    for (auto level : supported_simd_levels()) {
+        std::string s(1000, 'a');
+        s[700] = (char)0x80;
+        s[900] = (char)0xFF;
+
+        // Assert
+        REQUIRE(perlang::internal::find_non_ascii(s.data(), s.length(), level) == 700);
+    }
+}
+
+TEST_CASE( "perlang::internal::find_non_ascii, UTF-16, finds a non-ASCII code unit at every position" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t position = 0; position < 300; position++) {
+            // Use values which only differ from ASCII in the high or the low byte, to ensure both are being checked.
+            for (uint16_t value : { (uint16_t)0x0080, (uint16_t)0x0100, (uint16_t)0xD83C }) {
+                std::vector<uint16_t> s(300, 'a');
+                s[position] = value;
+
+                // Assert
+                REQUIRE(perlang::internal::find_non_ascii(s.data(), s.size(), level) == position);
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::find_non_ascii, UTF-16, returns length for ASCII-only content of varying lengths" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t length = 0; length < 300; length++) {
+            std::vector<uint16_t> s(length, 0x7F);
+
+            // Assert
+            REQUIRE(perlang::internal::find_non_ascii(s.data(), s.size(), level) == length);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// internal_case_mapping.cc - tests for the case mapping functions in perlang::internal
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/case_mapping.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+TEST_CASE( "perlang::internal::ascii_to_upper and ascii_to_lower, convert only ASCII letters" )
+{
+    // All byte values, repeated with different offsets so that every value ends up in every lane of the kernels.
+    std::string data;
+
+    for (size_t i = 0; i < 1000; i++) {
+        data += (char)((i * 7) % 256);
+    }
+
+    for (auto level : supported_simd_levels()) {
+        for (size_t length : { (size_t)0, (size_t)1, (size_t)15, (size_t)31, (size_t)33, data.length() }) {
+            std::string upper(length, '\0');
+            std::string lower(length, '\0');
+
+            perlang::internal::ascii_to_upper(data.data(), length, upper.data(), level);
+            perlang::internal::ascii_to_lower(data.data(), length, lower.data(), level);
+
+            for (size_t i = 0; i < length; i++) {
+                char c = data[i];
+
+                // Assert
+                REQUIRE(upper[i] == (c >= 'a' && c <= 'z' ? c - 32 : c));
+                REQUIRE(lower[i] == (c >= 'A' && c <= 'Z' ? c + 32 : c));
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::to_upper and to_lower, map characters in all planes" )
+{
+    REQUIRE(perlang::internal::to_upper(U'a') == U'A');
+    REQUIRE(perlang::internal::to_upper(U'é') == U'É');
+    REQUIRE(perlang::internal::to_upper(U'ɐ') == U'Ɐ');
+    REQUIRE(perlang::internal::to_upper(U'ſ') == U'S');
+    REQUIRE(perlang::internal::to_lower(U'K') == U'k');
+    REQUIRE(perlang::internal::to_lower(U'Ω') == U'ω');
+
+    // Deseret, outside of the BMP.
+    REQUIRE(perlang::internal::to_upper(U'\U00010428') == U'\U00010400');
+    REQUIRE(perlang::internal::to_lower(U'\U00010400') == U'\U00010428');
+
+    // Characters without case are returned as-is.
+    REQUIRE(perlang::internal::to_upper(U'€') == U'€');
+    REQUIRE(perlang::internal::to_lower(U'\U0001F389') == U'\U0001F389');
+    REQUIRE(perlang::internal::to_upper(0xD800) == 0xD800);
+}
@@ -0,0 +1,73 @@
+// internal_hashing.cc - tests for the hashing kernel in perlang::internal
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/hashing.h"
+
+TEST_CASE( "perlang::internal::hash_bytes, returns the same hash code for equal content" )
+{
+    std::string s1 = "this is a string which is long enough to exercise all the code paths of the hashing kernel";
+    std::string s2 = s1;
+
+    for (size_t length = 0; length <= s1.length(); length++) {
+        INFO("length: " << length);
+        REQUIRE(perlang::internal::hash_bytes(s1.data(), length) == perlang::internal::hash_bytes(s2.data(), length));
+    }
+}
+
+TEST_CASE( "perlang::internal::hash_bytes, hashes every byte of the input" )
+{
+    // Flipping any single bit must change the hash code, for all the length classes handled separately by the kernel.
+    for (size_t length : { 1, 2, 3, 4, 7, 8, 15, 16, 17, 47, 48, 49, 100 }) {
+        std::string s(length, 'x');
+        uint64_t original_hash = perlang::internal::hash_bytes(s.data(), length);
+
+        for (size_t i = 0; i < length; i++) {
+            for (int bit = 0; bit < 8; bit++) {
+                std::string modified = s;
+                modified[i] = static_cast<char>(modified[i] ^ (1 << bit));
+
+                INFO("length: " << length << ", byte: " << i << ", bit: " << bit);
+                REQUIRE(perlang::internal::hash_bytes(modified.data(), length) != original_hash);
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::hash_bytes, includes the length in the hash code" )
+{
+    std::string zeroes(64, '\0');
+    std::unordered_set<uint64_t> hashes;
+
+    for (size_t length = 0; length <= zeroes.length(); length++) {
+        hashes.insert(perlang::internal::hash_bytes(zeroes.data(), length));
+    }
+
+    REQUIRE(hashes.size() == zeroes.length() + 1);
+}
+
+TEST_CASE( "perlang::internal::hash_bytes, distributes similar keys over the low bits" )
+{
+    // Hash tables typically use the low bits of the hash code to select a bucket, so keys differing only slightly
+    // (like identifiers with a numeric suffix) must not end up in the same few buckets.
+    constexpr size_t KEY_COUNT = 4096;
+    constexpr size_t BUCKET_COUNT = 1024;
+    std::vector<size_t> buckets(BUCKET_COUNT);
+
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        std::string key = "identifier_" + std::to_string(i);
+        buckets[perlang::internal::hash_bytes(key.data(), key.length()) % BUCKET_COUNT]++;
+    }
+
+    size_t max_bucket_size = 0;
+
+    for (size_t bucket_size : buckets) {
+        max_bucket_size = std::max(max_bucket_size, bucket_size);
+    }
+
+    // With 4 keys per bucket on average, a uniform hash is extremely unlikely to put more than 16 keys in one bucket.
+    REQUIRE(max_bucket_size <= 16);
+}
@@ -0,0 +1,80 @@
+// internal_latin1.cc - tests for the Latin-1 helper functions in perlang::internal
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/latin1.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+TEST_CASE( "perlang::internal::narrow_to_latin1, converts all code units in the Latin-1 range" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t length = 0; length < 200; length++) {
+            std::vector<uint16_t> data(length);
+            std::string expected(length, '\0');
+
+            for (size_t i = 0; i < length; i++) {
+                data[i] = (uint16_t)((i * 37) % 256);
+                expected[i] = (char)data[i];
+            }
+
+            std::string output(length, '\0');
+
+            // Assert
+            REQUIRE(perlang::internal::narrow_to_latin1(data.data(), length, output.data(), level) == length);
+            REQUIRE(output == expected);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::narrow_to_latin1, stops at the first code unit outside of the Latin-1 range" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t position = 0; position < 100; position++) {
+            std::vector<uint16_t> data(100, 'a');
+            std::string output(100, '\0');
+
+            // Only the high byte is set, so that saturation would turn it into a valid-looking byte if it was missed.
+            data[position] = 0x0100;
+
+            // Assert
+            REQUIRE(perlang::internal::narrow_to_latin1(data.data(), data.size(), output.data(), level) == position);
+            REQUIRE(output.substr(0, position) == std::string(position, 'a'));
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::find_non_latin1, finds the first code unit outside of the Latin-1 range" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t length = 0; length < 100; length++) {
+            std::vector<uint16_t> data(length, 0xFF);
+
+            // Assert
+            REQUIRE(perlang::internal::find_non_latin1(data.data(), length, level) == length);
+
+            for (size_t position = 0; position < length; position++) {
+                data[position] = 0x0100;
+                REQUIRE(perlang::internal::find_non_latin1(data.data(), length, level) == position);
+
+                data[position] = 0xFF;
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::latin1_to_utf8, encodes characters above U+007F as two bytes" )
+{
+    std::string latin1 = "r\xE4ksm\xF6rg\xE5s \xFF\x80";
+    std::string output(perlang::internal::utf8_length_from_latin1(latin1.data(), latin1.length()), '\0');
+
+    // Act
+    size_t written = perlang::internal::latin1_to_utf8(latin1.data(), latin1.length(), output.data());
+
+    // Assert
+    REQUIRE(written == output.length());
+    REQUIRE(output == "räksmörgås ÿ\xC2\x80");
+}
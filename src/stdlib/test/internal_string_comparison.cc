@@ -0,0 +1,174 @@
+// internal_string_comparison.cc - tests for the cross-encoding comparison functions in perlang::internal
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/string_comparison.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+static const uint16_t* units(const std::u16string& s)
+{
+    return reinterpret_cast<const uint16_t*>(s.data());
+}
+
+static int compare_utf8_utf16(const std::string& utf8, const std::u16string& utf16)
+{
+    return perlang::internal::compare_utf8_utf16(utf8.data(), utf8.length(), units(utf16), utf16.length());
+}
+
+static int compare_utf16(const std::u16string& lhs, const std::u16string& rhs)
+{
+    return perlang::internal::compare_utf16(units(lhs), lhs.length(), units(rhs), rhs.length());
+}
+
+TEST_CASE( "perlang::internal::mismatch_ascii_utf16, returns length for equal content of varying lengths" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t length = 0; length < 200; length++) {
+            std::string ascii(length, 'a');
+            std::u16string utf16(length, u'a');
+
+            // Assert
+            REQUIRE(perlang::internal::mismatch_ascii_utf16(ascii.data(), units(utf16), length, level) == length);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::mismatch_ascii_utf16, finds a mismatch at every position" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t position = 0; position < 100; position++) {
+            std::string ascii(100, 'a');
+            std::u16string utf16(100, u'a');
+
+            // A code unit whose low byte matches the ASCII character must still be a mismatch.
+            utf16[position] = 0x0161;
+
+            // Assert
+            REQUIRE(perlang::internal::mismatch_ascii_utf16(ascii.data(), units(utf16), 100, level) == position);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::compare_utf8, orders by code point and then by length" )
+{
+    REQUIRE(perlang::internal::compare_utf8("abc", 3, "abd", 3) < 0);
+    REQUIRE(perlang::internal::compare_utf8("ab", 2, "abc", 3) < 0);
+    REQUIRE(perlang::internal::compare_utf8("abc", 3, "abc", 3) == 0);
+    REQUIRE(perlang::internal::compare_utf8("\xC3\xA5", 2, "z", 1) > 0);
+    REQUIRE(perlang::internal::compare_utf8("", 0, "", 0) == 0);
+}
+
+TEST_CASE( "perlang::internal::compare_utf16, orders supplementary characters after U+E000-U+FFFF" )
+{
+    // U+1F600 is encoded as a surrogate pair (D83D DE00), which is numerically lower than U+FFFD.
+    REQUIRE(compare_utf16(u"\U0001F600", u"�") > 0);
+    REQUIRE(compare_utf16(u"�", u"\U0001F600") < 0);
+    REQUIRE(compare_utf16(u"a\U0001F600", u"a\U0001F601") < 0);
+    REQUIRE(compare_utf16(u"å", u"å") == 0);
+    REQUIRE(compare_utf16(u"abc", u"ab") > 0);
+}
+
+TEST_CASE( "perlang::internal::compare_ascii_utf16, orders by code point and then by length" )
+{
+    std::u16string utf16 = u"abcå";
+
+    REQUIRE(perlang::internal::compare_ascii_utf16("abc", 3, units(utf16), 3) == 0);
+    REQUIRE(perlang::internal::compare_ascii_utf16("abc", 3, units(utf16), 4) < 0);
+    REQUIRE(perlang::internal::compare_ascii_utf16("abcz", 4, units(utf16), 4) < 0);
+    REQUIRE(perlang::internal::compare_ascii_utf16("abd", 3, units(utf16), 4) > 0);
+}
+
+TEST_CASE( "perlang::internal::compare_utf8_utf16, equal content" )
+{
+    REQUIRE(compare_utf8_utf16("", u"") == 0);
+    REQUIRE(compare_utf8_utf16("hello", u"hello") == 0);
+    REQUIRE(compare_utf8_utf16("r\xC3\xA4ksm\xC3\xB6rg\xC3\xA5s", u"räksmörgås") == 0);
+    REQUIRE(compare_utf8_utf16("\xE2\x82\xAC \xF0\x9F\x98\x80", u"€ \U0001F600") == 0);
+}
+
+TEST_CASE( "perlang::internal::compare_utf8_utf16, ordering matches compare_utf8()" )
+{
+    // The same pairs as UTF-8 and UTF-16. The result must be consistent with the byte order of UTF-8.
+    std::vector<std::pair<std::string, std::u16string>> strings = {
+        { "", u"" },
+        { "a", u"a" },
+        { "ab", u"ab" },
+        { "\xC3\xA5", u"å" },
+        { "\xEF\xBF\xBD", u"�" },
+        { "\xF0\x9F\x98\x80", u"\U0001F600" },
+        { "z\xF0\x9F\x98\x80", u"z\U0001F600" },
+    };
+
+    for (auto& [lhs_utf8, lhs_utf16] : strings) {
+        for (auto& [rhs_utf8, rhs_utf16] : strings) {
+            int expected = perlang::internal::compare_utf8(lhs_utf8.data(), lhs_utf8.length(), rhs_utf8.data(), rhs_utf8.length());
+            expected = expected < 0 ? -1 : expected > 0 ? 1 : 0;
+
+            // Assert
+            REQUIRE(compare_utf8_utf16(lhs_utf8, rhs_utf16) == expected);
+            REQUIRE((compare_utf16(lhs_utf16, rhs_utf16) > 0) - (compare_utf16(lhs_utf16, rhs_utf16) < 0) == expected);
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::equals_utf8_utf16, invalid content is never equal" )
+{
+    std::u16string lone_surrogate = u"a";
+    lone_surrogate += (char16_t)0xD800;
+
+    // An encoded surrogate (CESU-8 style) is not valid UTF-8.
+    std::string encoded_surrogate = "a\xED\xA0\x80";
+
+    REQUIRE_FALSE(perlang::internal::equals_utf8_utf16(encoded_surrogate.data(), encoded_surrogate.length(), units(lone_surrogate), lone_surrogate.length()));
+    REQUIRE_FALSE(perlang::internal::equals_utf8_utf16("a\xC3", 2, units(u"aÃ"), 2));
+    REQUIRE_FALSE(perlang::internal::equals_utf8_utf16("\xC0\xA1", 2, units(u"!"), 1));
+    REQUIRE(perlang::internal::equals_utf8_utf16("a\xC3\x83", 3, units(u"aÃ"), 2));
+}
+
+TEST_CASE( "perlang::internal::compare_utf8_utf16, surrogate pairs at chunk boundaries" )
+{
+    for (size_t prefix_length = 120; prefix_length < 132; prefix_length++) {
+        std::string utf8 = std::string(prefix_length, 'a') + "\xF0\x9F\x98\x80" + std::string(300, 'b');
+        std::u16string utf16 = std::u16string(prefix_length, u'a') + u"\U0001F600" + std::u16string(300, u'b');
+
+        // Assert
+        REQUIRE(compare_utf8_utf16(utf8, utf16) == 0);
+        REQUIRE(compare_utf8_utf16(utf8 + "b", utf16) > 0);
+        REQUIRE(compare_utf8_utf16(utf8, utf16 + u"b") < 0);
+
+        utf16.back() = u'c';
+        REQUIRE(compare_utf8_utf16(utf8, utf16) < 0);
+    }
+}
+
+TEST_CASE( "perlang::internal::compare_utf8_latin1, orders by code point and then by length" )
+{
+    auto compare = [](const std::string& utf8, const std::string& latin1) {
+        return perlang::internal::compare_utf8_latin1(utf8.data(), utf8.length(), latin1.data(), latin1.length());
+    };
+
+    // Assert
+    REQUIRE(compare("r\xC3\xA4ksm\xC3\xB6rg\xC3\xA5s", "r\xE4ksm\xF6rg\xE5s") == 0);
+    REQUIRE(compare("", "") == 0);
+    REQUIRE(compare("abc", "abd") < 0);
+    REQUIRE(compare("ab", "abc") < 0);
+    REQUIRE(compare("\xC3\xA4", "a") > 0);
+    REQUIRE(compare("a", "\xE4") < 0);
+    REQUIRE(compare("\xC3\xA4", "\xE5") < 0);
+
+    // Characters outside of the Latin-1 range sort after all Latin-1 characters.
+    REQUIRE(compare("\xC5\xB8", "\xFF") > 0);
+    REQUIRE(compare("\xE2\x82\xAC", "\xFF\xFF") > 0);
+}
+
+TEST_CASE( "perlang::internal::equals_utf8_latin1, invalid content is never equal" )
+{
+    REQUIRE(perlang::internal::equals_utf8_latin1("a\xC3\x83", 3, "a\xC3", 2));
+    REQUIRE_FALSE(perlang::internal::equals_utf8_latin1("a\xC3", 2, "a\xC3", 2));
+    REQUIRE_FALSE(perlang::internal::equals_utf8_latin1("\xC0\xA1", 2, "!", 1));
+    REQUIRE_FALSE(perlang::internal::equals_utf8_latin1("\xC3\xA4", 2, "\xE4\xE4", 2));
+}
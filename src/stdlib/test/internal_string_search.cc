@@ -0,0 +1,148 @@
+// internal_string_search.cc - tests for the substring search kernels in perlang::internal
+
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/string_search.h"
+
+using perlang::internal::NOT_FOUND;
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+static size_t find(const std::string& haystack, const std::string& needle, SimdLevel level)
+{
+    return perlang::internal::find(haystack.data(), haystack.length(), needle.data(), needle.length(), level);
+}
+
+TEST_CASE( "perlang::internal::find, empty needle is found at index 0" )
+{
+    for (auto level : supported_simd_levels()) {
+        REQUIRE(find("", "", level) == 0);
+        REQUIRE(find("abc", "", level) == 0);
+    }
+}
+
+TEST_CASE( "perlang::internal::find, needle longer than haystack is not found" )
+{
+    for (auto level : supported_simd_levels()) {
+        REQUIRE(find("ab", "abc", level) == NOT_FOUND);
+    }
+}
+
+TEST_CASE( "perlang::internal::find, finds needles of varying lengths at every position" )
+{
+    for (auto level : supported_simd_levels()) {
+        for (size_t needle_length = 1; needle_length < 40; needle_length++) {
+            std::string needle;
+
+            for (size_t i = 0; i < needle_length; i++) {
+                needle += (char)('A' + i % 26);
+            }
+
+            for (size_t position = 0; position + needle_length <= 100; position++) {
+                std::string haystack(100, 'x');
+                haystack.replace(position, needle_length, needle);
+
+                // Assert
+                REQUIRE(find(haystack, needle, level) == position);
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::find, verifies the full needle when only the first and last bytes match" )
+{
+    for (auto level : supported_simd_levels()) {
+        // Every 'a' is a candidate for the vectorized prefilter, since the needle also ends with 'a'. Only the last
+        // candidate is a real match.
+        std::string haystack = std::string(200, 'a') + "abca";
+
+        // Assert
+        REQUIRE(find(haystack, "abca", level) == 200);
+        REQUIRE(find(haystack, "abba", level) == NOT_FOUND);
+    }
+}
+
+TEST_CASE( "perlang::internal::find, returns the first of multiple occurrences" )
+{
+    for (auto level : supported_simd_levels()) {
+        std::string haystack = std::string(100, '-') + "needle" + std::string(100, '-') + "needle";
+
+        // Assert
+        REQUIRE(find(haystack, "needle", level) == 100);
+    }
+}
+
+TEST_CASE( "perlang::internal::find, handles non-ASCII and NUL bytes" )
+{
+    for (auto level : supported_simd_levels()) {
+        std::string haystack = std::string(50, '\0') + "h\xC3\xA5llo\xE2\x82\xAC" + std::string(50, '\0');
+
+        // Assert
+        REQUIRE(find(haystack, "\xC3\xA5l", level) == 51);
+        REQUIRE(find(haystack, "\xE2\x82\xAC", level) == 56);
+        REQUIRE(find(haystack, std::string("\xAC\0", 2), level) == 58);
+    }
+}
+
+TEST_CASE( "perlang::internal::find, produces the same result as std::string::find() for pseudo-random input" )
+{
+    uint32_t state = 12345;
+
+    // A small alphabet gives plenty of partial matches, which exercises the verification of candidates.
+    auto next_char = [&state]() {
+        state = state * 1103515245 + 12345;
+        return (char)('a' + (state >> 16) % 3);
+    };
+
+    for (int iteration = 0; iteration < 500; iteration++) {
+        std::string haystack;
+        std::string needle;
+
+        for (size_t i = 0; i < 10 + iteration % 90; i++) {
+            haystack += next_char();
+        }
+
+        for (size_t i = 0; i < 1 + iteration % 6; i++) {
+            needle += next_char();
+        }
+
+        size_t expected = haystack.find(needle);
+
+        for (auto level : supported_simd_levels()) {
+            // Assert
+            REQUIRE(find(haystack, needle, level) == (expected == std::string::npos ? NOT_FOUND : expected));
+        }
+
+        REQUIRE(perlang::internal::rfind(haystack.data(), haystack.length(), needle.data(), needle.length()) ==
+            (haystack.rfind(needle) == std::string::npos ? NOT_FOUND : haystack.rfind(needle)));
+    }
+}
+
+TEST_CASE( "perlang::internal::rfind, returns the last occurrence" )
+{
+    std::string haystack = "abcabcabc";
+
+    // Assert
+    REQUIRE(perlang::internal::rfind(haystack.data(), haystack.length(), "abc", 3) == 6);
+    REQUIRE(perlang::internal::rfind(haystack.data(), haystack.length(), "c", 1) == 8);
+    REQUIRE(perlang::internal::rfind(haystack.data(), haystack.length(), "", 0) == 9);
+    REQUIRE(perlang::internal::rfind(haystack.data(), haystack.length(), "abd", 3) == NOT_FOUND);
+}
+
+TEST_CASE( "perlang::internal::find, UTF-16 code units" )
+{
+    std::u16string haystack = u"abcå€abc€";
+    std::u16string needle = u"€";
+
+    auto h = reinterpret_cast<const uint16_t*>(haystack.data());
+    auto n = reinterpret_cast<const uint16_t*>(needle.data());
+
+    // Assert
+    REQUIRE(perlang::internal::find(h, haystack.length(), n, needle.length()) == 4);
+    REQUIRE(perlang::internal::rfind(h, haystack.length(), n, needle.length()) == 8);
+    REQUIRE(perlang::internal::find(h, haystack.length(), n, 0) == 0);
+    REQUIRE(perlang::internal::rfind(h, haystack.length(), n, 0) == haystack.length());
+    REQUIRE(perlang::internal::find(h, 3, n, needle.length()) == NOT_FOUND);
+}
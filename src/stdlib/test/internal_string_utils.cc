@@ -0,0 +1,58 @@
+// internal_string_utils.cc - tests for the number formatting in perlang::internal
+
+#include <climits>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/string_utils.h"
+
+namespace
+{
+    template <typename T>
+    std::string formatted(T value)
+    {
+        perlang::internal::FormattedNumber number(value);
+        return std::string(number.data(), number.length());
+    }
+}
+
+TEST_CASE( "perlang::internal::FormattedNumber, formats integers like std::to_string()" )
+{
+    for (int64_t value : { (int64_t)0, (int64_t)-1, (int64_t)9, (int64_t)10, (int64_t)99, (int64_t)100, (int64_t)9999,
+                           (int64_t)10000, (int64_t)-123456789, (int64_t)1000000000000000000, INT64_MAX, INT64_MIN }) {
+        INFO("value: " << value);
+        REQUIRE(formatted(value) == std::to_string(value));
+    }
+
+    for (uint64_t value : { (uint64_t)0, (uint64_t)42, (uint64_t)10000000000000000000U, UINT64_MAX }) {
+        INFO("value: " << value);
+        REQUIRE(formatted(value) == std::to_string(value));
+    }
+}
+
+TEST_CASE( "perlang::internal::FormattedNumber, formats every power of ten correctly" )
+{
+    uint64_t value = 1;
+
+    for (size_t digits = 1; digits <= 20; digits++) {
+        INFO("value: " << value);
+        REQUIRE(perlang::internal::FormattedNumber::decimal_length(value) == digits);
+        REQUIRE(perlang::internal::FormattedNumber::decimal_length(value - 1) == (digits == 1 ? 1 : digits - 1));
+        REQUIRE(formatted(value) == std::to_string(value));
+
+        value *= 10;
+    }
+}
+
+TEST_CASE( "perlang::internal::FormattedNumber, formats floating-point numbers like float_to_string() and double_to_string()" )
+{
+    for (float value : { 0.0f, -0.0f, 1.5f, -3.14159265f, 1e-10f, 3.4028235e38f }) {
+        INFO("value: " << value);
+        REQUIRE(formatted(value) == perlang::internal::float_to_string(value));
+    }
+
+    for (double value : { 0.0, 1.0 / 3, -2.5e-300, 1.7976931348623157e308, 123456789012345678.0 }) {
+        INFO("value: " << value);
+        REQUIRE(formatted(value) == perlang::internal::double_to_string(value));
+    }
+}
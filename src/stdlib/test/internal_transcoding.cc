@@ -0,0 +1,196 @@
+// internal_transcoding.cc - tests for the UTF-8/UTF-16 transcoding kernels in perlang::internal
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+#include "internal/transcoding.h"
+
+using perlang::internal::SimdLevel;
+using perlang::internal::supported_simd_levels;
+
+static std::vector<uint16_t> to_utf16(const std::string& s, SimdLevel level)
+{
+    std::vector<uint16_t> result(perlang::internal::utf16_length_from_utf8(s.data(), s.length(), level));
+    size_t written = perlang::internal::utf8_to_utf16(s.data(), s.length(), result.data(), level);
+
+    REQUIRE(written == result.size());
+
+    return result;
+}
+
+// Returns the message of the exception thrown when converting the given string, or an empty string if no exception
+// was thrown.
+static std::string conversion_error(const std::string& s, SimdLevel level)
+{
+    std::vector<uint16_t> output(perlang::internal::utf16_length_from_utf8(s.data(), s.length(), level));
+
+    try {
+        (void)perlang::internal::utf8_to_utf16(s.data(), s.length(), output.data(), level);
+    }
+    catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+
+    return "";
+}
+
+static std::string to_utf8(const std::vector<uint16_t>& s, SimdLevel level)
+{
+    std::string result(perlang::internal::utf8_length_from_utf16(s.data(), s.size(), level), '\0');
+    size_t written = perlang::internal::utf16_to_utf8(s.data(), s.size(), result.data(), level);
+
+    REQUIRE(written == result.size());
+
+    return result;
+}
+
+static std::string utf16_conversion_error(const std::vector<uint16_t>& s, SimdLevel level)
+{
+    std::string output(perlang::internal::utf8_length_from_utf16(s.data(), s.size(), level), '\0');
+
+    try {
+        (void)perlang::internal::utf16_to_utf8(s.data(), s.size(), output.data(), level);
+    }
+    catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+
+    return "";
+}
+
+TEST_CASE( "perlang::internal::utf8_to_utf16, all kernels produce the same result for mixed content" )
+{
+    // Long runs of ASCII interleaved with characters of all UTF-8 sequence lengths, to exercise both the fast and the
+    // slow paths of the kernels.
+    std::string s;
+
+    for (int i = 0; i < 50; i++) {
+        s += std::string(i, 'x') + "åäö" + std::string(i * 3, 'y') + "すし" + "🎉" + "z";
+    }
+
+    auto expected = to_utf16(s, SimdLevel::scalar);
+
+    for (auto level : supported_simd_levels()) {
+        // Assert
+        REQUIRE(to_utf16(s, level) == expected);
+    }
+}
+
+TEST_CASE( "perlang::internal::utf8_to_utf16, converts characters of all sequence lengths correctly" )
+{
+    for (auto level : supported_simd_levels()) {
+        std::vector<uint16_t> expected = { 'a', 0x00E5, 0x3059, 0xD83C, 0xDF89 };
+
+        // Assert
+        REQUIRE(to_utf16("aåす🎉", level) == expected);
+    }
+}
+
+TEST_CASE( "perlang::internal::utf16_length_from_utf8, returns the correct length for long strings" )
+{
+    std::string s;
+
+    for (int i = 0; i < 1000; i++) {
+        s += "abcåす🎉";
+    }
+
+    for (auto level : supported_simd_levels()) {
+        // 3 x ASCII + 1 x two-byte + 1 x three-byte + 1 x surrogate pair
+        REQUIRE(perlang::internal::utf16_length_from_utf8(s.data(), s.length(), level) == 1000 * 7);
+    }
+}
+
+TEST_CASE( "perlang::internal::utf8_to_utf16, throws the expected errors for invalid input at any position" )
+{
+    struct InvalidInput {
+        std::string data;
+        std::string error;
+    };
+
+    std::vector<InvalidInput> invalid_inputs = {
+        { "\xC3", "Truncated UTF-8 sequence encountered (string was too short to fit two bytes of expected UTF-8 data)" },
+        { "\xC3" "a", "Invalid UTF-8 sequence encountered (second byte lacks UTF-8 mask)" },
+        { "\xC1\xBF", "Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)" },
+        { "\xE0\x9F\xBF", "Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)" },
+        { "\xF0\x8F\xBF\xBF", "Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)" },
+        { "\xF4\x90\x80\x80", "Invalid UTF-8 sequence encountered (code point exceeds maximum allowed value of 0x10FFFF)" },
+        { "\x80", "Invalid UTF-8 sequence encountered (first byte does not match any known UTF-8 encoding scheme)" },
+        { "\xFF", "Invalid UTF-8 sequence encountered (first byte does not match any known UTF-8 encoding scheme)" },
+    };
+
+    for (auto level : supported_simd_levels()) {
+        for (const auto& input : invalid_inputs) {
+            for (size_t prefix_length : { 0, 1, 15, 31, 63, 64, 100 }) {
+                // Put the invalid sequence in the middle of a long run of ASCII content, except for the truncated
+                // sequence which must be at the end of the string.
+                std::string suffix = input.data == "\xC3" ? "" : std::string(100, 'b');
+                std::string s = std::string(prefix_length, 'a') + input.data + suffix;
+
+                // Assert
+                REQUIRE(conversion_error(s, level) == input.error);
+            }
+        }
+    }
+}
+
+TEST_CASE( "perlang::internal::utf16_to_utf8, round-trips mixed content with all kernels" )
+{
+    std::string s;
+
+    for (int i = 0; i < 50; i++) {
+        s += std::string(i, 'x') + "åäö" + std::string(i * 3, 'y') + "すし" + "🎉" + "z";
+    }
+
+    auto utf16 = to_utf16(s, SimdLevel::scalar);
+
+    for (auto level : supported_simd_levels()) {
+        // Assert
+        REQUIRE(to_utf8(utf16, level) == s);
+    }
+}
+
+TEST_CASE( "perlang::internal::utf8_length_from_utf16, returns the correct length for long strings" )
+{
+    std::vector<uint16_t> s;
+
+    for (int i = 0; i < 10000; i++) {
+        s.insert(s.end(), { 'a', 'b', 'c', 0x00E5, 0x3059, 0xD83C, 0xDF89 });
+    }
+
+    for (auto level : supported_simd_levels()) {
+        // 3 x ASCII + 1 x two-byte + 1 x three-byte + 1 x four-byte (surrogate pair)
+        REQUIRE(perlang::internal::utf8_length_from_utf16(s.data(), s.size(), level) == 10000 * 12);
+    }
+}
+
+TEST_CASE( "perlang::internal::utf16_to_utf8, throws the expected errors for unpaired surrogates at any position" )
+{
+    struct InvalidInput {
+        std::vector<uint16_t> data;
+        std::string error;
+    };
+
+    std::vector<InvalidInput> invalid_inputs = {
+        { { 0xD83C }, "Invalid UTF-16 sequence encountered (high surrogate not followed by a low surrogate)" },
+        { { 0xD83C, 'a' }, "Invalid UTF-16 sequence encountered (high surrogate not followed by a low surrogate)" },
+        { { 0xD83C, 0xD83C }, "Invalid UTF-16 sequence encountered (high surrogate not followed by a low surrogate)" },
+        { { 0xDF89 }, "Invalid UTF-16 sequence encountered (low surrogate not preceded by a high surrogate)" },
+    };
+
+    for (auto level : supported_simd_levels()) {
+        for (const auto& input : invalid_inputs) {
+            for (size_t prefix_length : { 0, 1, 15, 31, 63, 64, 100 }) {
+                for (size_t suffix_length : { 0, 100 }) {
+                    std::vector<uint16_t> s(prefix_length, 'a');
+                    s.insert(s.end(), input.data.begin(), input.data.end());
+                    s.insert(s.end(), suffix_length, 'b');
+
+                    // Assert
+                    REQUIRE(utf16_conversion_error(s, level) == input.error);
+                }
+            }
+        }
+    }
+}
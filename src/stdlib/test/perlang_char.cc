@@ -1,5 +1,6 @@
 // perlang_string.cc - tests for the perlang::String class
 
+#include <clocale>
 #include <catch2/catch_test_macros.hpp>
 
 #include "perlang_stdlib.h"
@@ -14,7 +15,6 @@ TEST_CASE( "perlang::Char::to_upper, with ASCII content" )
 
 TEST_CASE( "perlang::Char::to_upper, with non-ASCII content" )
 {
-    REQUIRE(std::setlocale(LC_ALL, "sv_SE.UTF-8") != nullptr);
     char16_t c = perlang::Char::to_upper(L'å');
 
     // Assert
@@ -31,9 +31,36 @@ TEST_CASE( "perlang::Char::to_lower, with ASCII content" )
 
 TEST_CASE( "perlang::Char::to_lower, with non-ASCII content" )
 {
-    REQUIRE(std::setlocale(LC_ALL, "sv_SE.UTF-8") != nullptr);
     char16_t c = perlang::Char::to_lower(L'Å');
 
     // Assert
     REQUIRE(c == L'å');
 }
+
+TEST_CASE( "perlang::Char::to_upper, is independent of the current locale" )
+{
+    // The "C" locale doesn't know about any non-ASCII characters, so std::towupper() would leave these unchanged.
+    REQUIRE(std::setlocale(LC_ALL, "C") != nullptr);
+
+    // Assert
+    REQUIRE(perlang::Char::to_upper(u'ä') == u'Ä');
+    REQUIRE(perlang::Char::to_upper(u'ÿ') == u'Ÿ');
+    REQUIRE(perlang::Char::to_upper(u'ж') == u'Ж');
+    REQUIRE(perlang::Char::to_upper(u'σ') == u'Σ');
+}
+
+TEST_CASE( "perlang::Char::to_upper, uses simple case mappings" )
+{
+    // 'ß' uppercases to "SS", which is not a single character, so it is left as-is.
+    REQUIRE(perlang::Char::to_upper(u'ß') == u'ß');
+    REQUIRE(perlang::Char::to_upper(u'ᾳ') == u'ᾼ');
+    REQUIRE(perlang::Char::to_upper(u'1') == u'1');
+}
+
+TEST_CASE( "perlang::Char::to_lower, uses simple case mappings" )
+{
+    REQUIRE(perlang::Char::to_lower(u'İ') == u'i');
+    REQUIRE(perlang::Char::to_lower(u'K') == u'k');
+    REQUIRE(perlang::Char::to_lower(u'Ж') == u'ж');
+    REQUIRE(perlang::Char::to_lower(u'?') == u'?');
+}
@@ -0,0 +1,80 @@
+// perlang_double.cc - tests for the perlang::Double class
+
+#include <cmath>
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+TEST_CASE( "perlang::Double::parse(), parses valid numbers" )
+{
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("0")) == 0.0);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1.5")) == 1.5);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("-0.125")) == -0.125);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("+2e10")) == 2e10);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1E-3")) == 1e-3);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("3.141592653589793")) == 3.141592653589793);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1.7976931348623157e308")) == 1.7976931348623157e308);
+}
+
+TEST_CASE( "perlang::Double::parse(), parses infinity and NaN" )
+{
+    REQUIRE(std::isinf(perlang::Double::parse(*perlang::ASCIIString::from_static_string("inf"))));
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("-Infinity")) < 0);
+    REQUIRE(std::isnan(perlang::Double::parse(*perlang::ASCIIString::from_static_string("NaN"))));
+}
+
+TEST_CASE( "perlang::Double::parse(), round-trips values formatted by string concatenation" )
+{
+    for (double value : { 0.1, -123.456, 6.02214076e23, 1.0 / 3 }) {
+        std::shared_ptr<perlang::String> s = *perlang::ASCIIString::from_static_string("") + value;
+
+        INFO("formatted: " << s->bytes());
+        REQUIRE(perlang::Double::parse(*s) == std::stod(s->bytes()));
+    }
+}
+
+TEST_CASE( "perlang::Double::parse(), throws expected exceptions for invalid input" )
+{
+    for (const char* input : { "", ".", "e5", "1.5.2", " 1", "1 ", "1,5", "+-1" }) {
+        INFO("input: '" << input << "'");
+        REQUIRE_THROWS_AS(perlang::Double::parse(*perlang::ASCIIString::from_static_string(input)), std::invalid_argument);
+    }
+
+    REQUIRE_THROWS_AS(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1e400")), std::out_of_range);
+}
+
+TEST_CASE( "perlang::Double::parse(), behaves the same regardless of the C++ library and locale" )
+{
+    // Hexadecimal floating-point numbers are accepted by strtod(), but not by std::from_chars().
+    for (const char* input : { "0x1p3", "-0X10", "0x" }) {
+        INFO("input: '" << input << "'");
+        REQUIRE_THROWS_AS(perlang::Double::parse(*perlang::ASCIIString::from_static_string(input)), std::invalid_argument);
+    }
+
+    // Values too small to be represented are out of range, while subnormal values are parsed as usual.
+    REQUIRE_THROWS_AS(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1e-400")), std::out_of_range);
+    REQUIRE_THROWS_AS(perlang::Double::parse(*perlang::ASCIIString::from_static_string("-1e-400")), std::out_of_range);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("1e-310")) == 1e-310);
+    REQUIRE(perlang::Double::parse(*perlang::ASCIIString::from_static_string("4.9e-324")) > 0);
+}
+
+TEST_CASE( "perlang::Double::try_parse(), returns false for invalid input" )
+{
+    double result = 1.0;
+
+    REQUIRE(perlang::Double::try_parse(*perlang::ASCIIString::from_static_string("2.5"), result));
+    REQUIRE(result == 2.5);
+    REQUIRE_FALSE(perlang::Double::try_parse(*perlang::ASCIIString::from_static_string("two"), result));
+    REQUIRE(result == 2.5);
+}
+
+TEST_CASE( "perlang::Double::parse_array(), parses delimited values" )
+{
+    std::unique_ptr<perlang::DoubleArray> result = perlang::Double::parse_array(*perlang::ASCIIString::from_static_string("1.5\n-2\n3e2\n"), '\n');
+
+    REQUIRE(result->length() == 3);
+    REQUIRE((*result)[0] == 1.5);
+    REQUIRE((*result)[1] == -2.0);
+    REQUIRE((*result)[2] == 300.0);
+}
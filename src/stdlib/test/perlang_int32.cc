@@ -0,0 +1,101 @@
+// perlang_int32.cc - tests for the perlang::Int32 class
+
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+TEST_CASE( "perlang::Int32::parse(), parses valid integers" )
+{
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("0")) == 0);
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("12345")) == 12345);
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("-12345")) == -12345);
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("+42")) == 42);
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("2147483647")) == INT32_MAX);
+    REQUIRE(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("-2147483648")) == INT32_MIN);
+}
+
+TEST_CASE( "perlang::Int32::parse(), parses UTF8String and UTF16String content" )
+{
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("-987");
+    std::shared_ptr<perlang::String> utf16 = utf8->as_utf16();
+
+    REQUIRE(perlang::Int32::parse(*utf8) == -987);
+    REQUIRE(perlang::Int32::parse(*utf16) == -987);
+}
+
+TEST_CASE( "perlang::Int32::parse(), parses a StringSlice without a terminating NUL" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("values: 123456789012345678901234567890");
+    std::shared_ptr<perlang::String> slice = s->substring(8, 9);
+
+    REQUIRE(perlang::Int32::parse(*slice) == 123456789);
+}
+
+TEST_CASE( "perlang::Int32::parse(), throws std::invalid_argument for invalid input" )
+{
+    for (const char* input : { "", "-", "+", "abc", "12a", " 12", "12 ", "+-1", "1.5", "0x10" }) {
+        INFO("input: '" << input << "'");
+        REQUIRE_THROWS_AS(perlang::Int32::parse(*perlang::ASCIIString::from_static_string(input)), std::invalid_argument);
+    }
+
+    REQUIRE_THROWS_WITH(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("12a")), "Value '12a' is not a valid Int32");
+}
+
+TEST_CASE( "perlang::Int32::parse(), throws std::out_of_range for values outside the range of int32" )
+{
+    REQUIRE_THROWS_AS(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("2147483648")), std::out_of_range);
+    REQUIRE_THROWS_AS(perlang::Int32::parse(*perlang::ASCIIString::from_static_string("-2147483649")), std::out_of_range);
+}
+
+TEST_CASE( "perlang::Int32::try_parse(), returns true and sets the result for valid input" )
+{
+    int32_t result = 0;
+
+    REQUIRE(perlang::Int32::try_parse(*perlang::ASCIIString::from_static_string("-17"), result));
+    REQUIRE(result == -17);
+}
+
+TEST_CASE( "perlang::Int32::try_parse(), returns false and leaves the result unmodified for invalid input" )
+{
+    int32_t result = 4711;
+
+    REQUIRE_FALSE(perlang::Int32::try_parse(*perlang::ASCIIString::from_static_string("seventeen"), result));
+    REQUIRE_FALSE(perlang::Int32::try_parse(*perlang::ASCIIString::from_static_string("99999999999"), result));
+    REQUIRE_FALSE(perlang::Int32::try_parse(*perlang::UTF8String::from_static_string("åäö")->as_utf16(), result));
+    REQUIRE(result == 4711);
+}
+
+TEST_CASE( "perlang::Int32::parse_array(), parses delimited values" )
+{
+    std::unique_ptr<perlang::IntArray> result = perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("1, -2,3 ,\t+4"));
+
+    REQUIRE(result->length() == 4);
+    REQUIRE((*result)[0] == 1);
+    REQUIRE((*result)[1] == -2);
+    REQUIRE((*result)[2] == 3);
+    REQUIRE((*result)[3] == 4);
+}
+
+TEST_CASE( "perlang::Int32::parse_array(), parses newline-separated values with a trailing line break" )
+{
+    std::unique_ptr<perlang::IntArray> result = perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("10\r\n20\r\n30\r\n"), '\n');
+
+    REQUIRE(result->length() == 3);
+    REQUIRE((*result)[0] == 10);
+    REQUIRE((*result)[1] == 20);
+    REQUIRE((*result)[2] == 30);
+}
+
+TEST_CASE( "perlang::Int32::parse_array(), returns an empty array for empty input" )
+{
+    REQUIRE(perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string(""))->length() == 0);
+    REQUIRE(perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("  \n"))->length() == 0);
+}
+
+TEST_CASE( "perlang::Int32::parse_array(), throws an exception including the index of an invalid value" )
+{
+    REQUIRE_THROWS_WITH(perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("1,2,x,4")), "Value 'x' at index 2 is not a valid Int32");
+    REQUIRE_THROWS_WITH(perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("1,,3")), "Value '' at index 1 is not a valid Int32");
+    REQUIRE_THROWS_AS(perlang::Int32::parse_array(*perlang::ASCIIString::from_static_string("1,3000000000")), std::out_of_range);
+}
@@ -0,0 +1,41 @@
+// perlang_int64.cc - tests for the perlang::Int64 class
+
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+TEST_CASE( "perlang::Int64::parse(), parses valid integers" )
+{
+    REQUIRE(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("0")) == 0);
+    REQUIRE(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("-8589934592")) == -8589934592);
+    REQUIRE(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("9223372036854775807")) == INT64_MAX);
+    REQUIRE(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("-9223372036854775808")) == INT64_MIN);
+}
+
+TEST_CASE( "perlang::Int64::parse(), throws expected exceptions for invalid input" )
+{
+    REQUIRE_THROWS_AS(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("1e3")), std::invalid_argument);
+    REQUIRE_THROWS_AS(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("9223372036854775808")), std::out_of_range);
+    REQUIRE_THROWS_WITH(perlang::Int64::parse(*perlang::ASCIIString::from_static_string("99999999999999999999")), "Value '99999999999999999999' is outside the range of Int64");
+}
+
+TEST_CASE( "perlang::Int64::try_parse(), returns false for invalid input" )
+{
+    int64_t result = 1;
+
+    REQUIRE(perlang::Int64::try_parse(*perlang::ASCIIString::from_static_string("-5"), result));
+    REQUIRE(result == -5);
+    REQUIRE_FALSE(perlang::Int64::try_parse(*perlang::ASCIIString::from_static_string("-"), result));
+    REQUIRE(result == -5);
+}
+
+TEST_CASE( "perlang::Int64::parse_array(), parses delimited values" )
+{
+    std::unique_ptr<perlang::LongArray> result = perlang::Int64::parse_array(*perlang::ASCIIString::from_static_string("4294967296;-1;0"), ';');
+
+    REQUIRE(result->length() == 3);
+    REQUIRE((*result)[0] == 4294967296);
+    REQUIRE((*result)[1] == -1);
+    REQUIRE((*result)[2] == 0);
+}
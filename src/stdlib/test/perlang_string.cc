@@ -1,5 +1,6 @@
 // perlang_string.cc - tests for the perlang::String class
 
+#include <typeinfo>
 #include <catch2/catch_test_macros.hpp>
 
 #include "perlang_stdlib.h"
@@ -38,3 +39,378 @@ TEST_CASE( "perlang::String, concatenating ASCIIString with UTF8String" )
 
     REQUIRE(*s3 == *perlang::UTF8String::from_static_string("this is an ASCII string with some non-ASCII characters: åäöÅÄÖéèüÜÿŸïÏすし"));
 }
+
+TEST_CASE( "perlang::String, hash() returns the same hash code for equal strings" )
+{
+    std::shared_ptr<perlang::String> s1 = perlang::ASCIIString::from_static_string("this is a string");
+    std::shared_ptr<perlang::String> s2 = perlang::ASCIIString::from_copied_string("this is a string");
+
+    REQUIRE(s1->hash() == s2->hash());
+}
+
+TEST_CASE( "perlang::String, hash() returns the same hash code for ASCIIString and equal UTF8String" )
+{
+    std::shared_ptr<perlang::String> s1 = perlang::ASCIIString::from_static_string("this is an ASCII-clean string");
+    std::shared_ptr<perlang::String> s2 = perlang::UTF8String::from_static_string("this is an ASCII-clean string");
+
+    REQUIRE(s1->hash() == s2->hash());
+}
+
+TEST_CASE( "perlang::String, hash() returns the same hash code for RopeString and equal flat string" )
+{
+    std::string part(perlang::RopeString::THRESHOLD, 'x');
+    std::shared_ptr<perlang::String> s1 = perlang::ASCIIString::from_copied_string(part.c_str());
+    std::shared_ptr<perlang::String> rope = *s1 + *s1;
+    std::shared_ptr<perlang::String> flat = perlang::ASCIIString::from_copied_string((part + part).c_str());
+
+    REQUIRE(rope->hash() == flat->hash());
+}
+
+TEST_CASE( "perlang::String, hash() returns different hash codes for different strings" )
+{
+    std::shared_ptr<perlang::String> s1 = perlang::ASCIIString::from_static_string("this is a string");
+    std::shared_ptr<perlang::String> s2 = perlang::ASCIIString::from_static_string("this is a strinG");
+
+    REQUIRE(s1->hash() != s2->hash());
+}
+
+TEST_CASE( "perlang::String, hash() returns a stable hash code on subsequent calls" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("åäö");
+
+    uint64_t hash = s->hash();
+
+    REQUIRE(hash != 0);
+    REQUIRE(s->hash() == hash);
+}
+
+TEST_CASE( "perlang::String, encoding() returns the encoding of the string content" )
+{
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("this is a string");
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("åäö");
+    std::shared_ptr<perlang::String> utf16 = ascii->as_utf16();
+
+    REQUIRE(ascii->encoding() == perlang::StringEncoding::ascii);
+    REQUIRE(utf8->encoding() == perlang::StringEncoding::utf8);
+    REQUIRE(utf16->encoding() == perlang::StringEncoding::utf16);
+}
+
+TEST_CASE( "perlang::String, encoding() of RopeString depends on its parts" )
+{
+    std::string part(perlang::RopeString::THRESHOLD, 'x');
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_copied_string(part.c_str());
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("åäö");
+
+    std::shared_ptr<perlang::String> ascii_rope = *ascii + *ascii;
+    std::shared_ptr<perlang::String> utf8_rope = *ascii + *utf8;
+
+    REQUIRE(ascii_rope->encoding() == perlang::StringEncoding::ascii);
+    REQUIRE(utf8_rope->encoding() == perlang::StringEncoding::utf8);
+    REQUIRE(utf8_rope->length() == part.length() + 6);
+}
+
+TEST_CASE( "perlang::String, comparing UTF16String with equal UTF16String" )
+{
+    std::shared_ptr<perlang::String> s1 = perlang::UTF8String::from_static_string("åäö")->as_utf16();
+    std::shared_ptr<perlang::String> s2 = perlang::UTF8String::from_static_string("åäö")->as_utf16();
+
+    REQUIRE(*s1 == *s2);
+}
+
+TEST_CASE( "perlang::String, index_of() returns the byte index of the first occurrence" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello, hello world");
+
+    REQUIRE(s->index_of(*perlang::ASCIIString::from_static_string("hello")) == 0);
+    REQUIRE(s->index_of(*perlang::ASCIIString::from_static_string("hello"), 1) == 7);
+    REQUIRE(s->index_of(*perlang::ASCIIString::from_static_string("world")) == 13);
+    REQUIRE(s->index_of(*perlang::ASCIIString::from_static_string("planet")) == -1);
+    REQUIRE(s->index_of(*perlang::ASCIIString::from_static_string(""), 5) == 5);
+    REQUIRE_THROWS_AS(s->index_of(*perlang::ASCIIString::from_static_string(""), 19), std::out_of_range);
+}
+
+TEST_CASE( "perlang::String, index_of() works across encodings" )
+{
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("smörgåsbord");
+    std::shared_ptr<perlang::String> utf16 = utf8->as_utf16();
+
+    // Byte indices for UTF-8, code unit indices for UTF-16.
+    REQUIRE(utf8->index_of(*perlang::ASCIIString::from_static_string("bord")) == 9);
+    REQUIRE(utf8->index_of(*perlang::UTF8String::from_static_string("gås")->as_utf16()) == 5);
+    REQUIRE(utf16->index_of(*perlang::ASCIIString::from_static_string("bord")) == 7);
+    REQUIRE(utf16->index_of(*perlang::UTF8String::from_static_string("gås")) == 4);
+}
+
+TEST_CASE( "perlang::String, last_index_of() returns the index of the last occurrence" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("åbcåbc");
+
+    REQUIRE(s->last_index_of(*perlang::UTF8String::from_static_string("å")) == 4);
+    REQUIRE(s->last_index_of(*perlang::ASCIIString::from_static_string("x")) == -1);
+    REQUIRE(s->as_utf16()->last_index_of(*perlang::ASCIIString::from_static_string("bc")) == 4);
+}
+
+TEST_CASE( "perlang::String, contains(), starts_with() and ends_with()" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("räksmörgås");
+    std::shared_ptr<perlang::String> utf16 = s->as_utf16();
+
+    for (auto& haystack : { s, utf16 }) {
+        REQUIRE(haystack->contains(*perlang::UTF8String::from_static_string("smör")));
+        REQUIRE_FALSE(haystack->contains(*perlang::ASCIIString::from_static_string("smor")));
+
+        REQUIRE(haystack->starts_with(*perlang::UTF8String::from_static_string("räk")));
+        REQUIRE(haystack->starts_with(*perlang::ASCIIString::from_static_string("")));
+        REQUIRE_FALSE(haystack->starts_with(*perlang::UTF8String::from_static_string("smör")));
+
+        REQUIRE(haystack->ends_with(*perlang::UTF8String::from_static_string("gås")->as_utf16()));
+        REQUIRE_FALSE(haystack->ends_with(*perlang::ASCIIString::from_static_string("gas")));
+        REQUIRE_FALSE(haystack->ends_with(*perlang::UTF8String::from_static_string("xräksmörgås")));
+    }
+}
+
+TEST_CASE( "perlang::String, split() returns the parts between separators" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("a,,bc,def,");
+
+    auto parts = s->split(*perlang::ASCIIString::from_static_string(","));
+
+    REQUIRE(parts->length() == 5);
+    REQUIRE(*(*parts)[0] == *perlang::ASCIIString::from_static_string("a"));
+    REQUIRE((*parts)[1]->length() == 0);
+    REQUIRE(*(*parts)[2] == *perlang::ASCIIString::from_static_string("bc"));
+    REQUIRE(*(*parts)[3] == *perlang::ASCIIString::from_static_string("def"));
+    REQUIRE((*parts)[4]->length() == 0);
+}
+
+TEST_CASE( "perlang::String, split() with multi-byte separator" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("ett → två → tre");
+
+    auto parts = s->split(*perlang::UTF8String::from_static_string(" → "));
+
+    REQUIRE(parts->length() == 3);
+    REQUIRE(*(*parts)[1] == *perlang::UTF8String::from_static_string("två"));
+    REQUIRE(*(*parts)[2] == *perlang::ASCIIString::from_static_string("tre"));
+}
+
+TEST_CASE( "perlang::String, split() without any separator returns the whole string" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("abc");
+
+    auto parts = s->split(*perlang::ASCIIString::from_static_string(";"));
+
+    REQUIRE(parts->length() == 1);
+    REQUIRE(*(*parts)[0] == *s);
+    REQUIRE_THROWS_AS(s->split(*perlang::ASCIIString::from_static_string("")), std::invalid_argument);
+}
+
+TEST_CASE( "perlang::String, replace() replaces all occurrences" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("one two one two one");
+
+    auto result = s->replace(*perlang::ASCIIString::from_static_string("one"), *perlang::ASCIIString::from_static_string("1"));
+
+    REQUIRE(*result == *perlang::ASCIIString::from_static_string("1 two 1 two 1"));
+    REQUIRE(result->encoding() == perlang::StringEncoding::ascii);
+}
+
+TEST_CASE( "perlang::String, replace() with non-ASCII replacement returns a UTF8String" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("a-b-c");
+
+    auto result = s->replace(*perlang::ASCIIString::from_static_string("-"), *perlang::UTF8String::from_static_string(" → "));
+
+    REQUIRE(*result == *perlang::UTF8String::from_static_string("a → b → c"));
+    REQUIRE(result->encoding() == perlang::StringEncoding::utf8);
+}
+
+TEST_CASE( "perlang::String, replace() on UTF16String" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("åäö åäö")->as_utf16();
+
+    auto result = s->replace(*perlang::UTF8String::from_static_string("ä"), *perlang::ASCIIString::from_static_string(""));
+
+    REQUIRE(*result == *perlang::UTF8String::from_static_string("åö åö")->as_utf16());
+}
+
+TEST_CASE( "perlang::String, replace() without matches returns an equal string" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("abc");
+
+    REQUIRE(*s->replace(*perlang::ASCIIString::from_static_string("x"), *perlang::ASCIIString::from_static_string("y")) == *s);
+    REQUIRE_THROWS_AS(s->replace(*perlang::ASCIIString::from_static_string(""), *s), std::invalid_argument);
+}
+
+TEST_CASE( "perlang::String, trim() removes leading and trailing whitespace" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string(" \t\r\n smörgås \n");
+
+    REQUIRE(*s->trim() == *perlang::UTF8String::from_static_string("smörgås"));
+    REQUIRE(*s->as_utf16()->trim() == *perlang::UTF8String::from_static_string("smörgås")->as_utf16());
+    REQUIRE(s->split(*perlang::UTF8String::from_static_string("smörgås"))->length() == 2);
+    REQUIRE(perlang::ASCIIString::from_static_string("   ")->trim()->length() == 0);
+}
+
+TEST_CASE( "perlang::String, comparing UTF16String with equal ASCIIString and UTF8String" )
+{
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("hello world");
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("hello wörld");
+
+    REQUIRE(*ascii == *ascii->as_utf16());
+    REQUIRE(*ascii->as_utf16() == *ascii);
+    REQUIRE(*utf8 == *utf8->as_utf16());
+    REQUIRE(*utf8->as_utf16() == *utf8);
+    REQUIRE_FALSE(*ascii == *utf8->as_utf16());
+    REQUIRE_FALSE(*ascii->as_utf16() == *perlang::ASCIIString::from_static_string("hello"));
+}
+
+TEST_CASE( "perlang::String, equal strings of different encodings have the same hash code" )
+{
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("hello world");
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("räksmörgås 🙂");
+    std::string long_content(1000, 'x');
+    std::shared_ptr<perlang::String> long_ascii = perlang::ASCIIString::from_copied_string(long_content.c_str());
+
+    REQUIRE(ascii->hash() == ascii->as_utf16()->hash());
+    REQUIRE(utf8->hash() == utf8->as_utf16()->hash());
+    REQUIRE(long_ascii->hash() == long_ascii->as_utf16()->hash());
+}
+
+TEST_CASE( "perlang::String, compare() orders strings by code point" )
+{
+    std::shared_ptr<perlang::String> a = perlang::ASCIIString::from_static_string("abc");
+    std::shared_ptr<perlang::String> b = perlang::UTF8String::from_static_string("abå");
+    std::shared_ptr<perlang::String> c = perlang::UTF8String::from_static_string("ab🙂");
+
+    for (auto& lhs : { a, std::shared_ptr<perlang::String>(a->as_utf16()) }) {
+        for (auto& rhs : { b, std::shared_ptr<perlang::String>(b->as_utf16()) }) {
+            REQUIRE(lhs->compare(*rhs) < 0);
+            REQUIRE(rhs->compare(*lhs) > 0);
+        }
+
+        REQUIRE(lhs->compare(*a) == 0);
+        REQUIRE(lhs->compare(*perlang::ASCIIString::from_static_string("ab")) > 0);
+    }
+
+    REQUIRE(b->compare(*c) < 0);
+    REQUIRE(b->as_utf16()->compare(*c->as_utf16()) < 0);
+    REQUIRE(c->as_utf16()->compare(*b) > 0);
+}
+
+TEST_CASE( "perlang::String::to_upper(), converts ASCII content and keeps the encoding" )
+{
+    std::unique_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("Hello, World! 123")->to_upper();
+    std::unique_ptr<perlang::String> utf8 = perlang::UTF8String::from_copied_string("Hello, World! 123")->to_upper();
+
+    // Assert
+    REQUIRE(ascii->encoding() == perlang::StringEncoding::ascii);
+    REQUIRE(std::string(ascii->bytes()) == "HELLO, WORLD! 123");
+    REQUIRE(utf8->encoding() == perlang::StringEncoding::utf8);
+    REQUIRE(std::string(utf8->bytes()) == "HELLO, WORLD! 123");
+    REQUIRE(std::string(perlang::ASCIIString::from_static_string("Hello")->to_lower()->bytes()) == "hello");
+}
+
+TEST_CASE( "perlang::String::to_upper() and to_lower(), with non-ASCII UTF-8 content" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("Räksmörgås, straße, ɐ, K, 𐐨 🎉");
+
+    // Assert
+    REQUIRE(std::string(s->to_upper()->bytes()) == "RÄKSMÖRGÅS, STRAßE, Ɐ, K, 𐐀 🎉");
+    REQUIRE(std::string(s->to_lower()->bytes()) == "räksmörgås, straße, ɐ, k, 𐐨 🎉");
+}
+
+TEST_CASE( "perlang::String::to_upper(), keeps invalid UTF-8 sequences as-is" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("a\xE2\x82 b\xFF\xC3\xA5");
+
+    // Assert
+    REQUIRE(std::string(s->to_upper()->bytes()) == "A\xE2\x82 B\xFF\xC3\x85");
+}
+
+TEST_CASE( "perlang::String::to_upper() and to_lower(), with UTF16String content" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("Räksmörgås");
+    std::unique_ptr<perlang::UTF16String> latin1_to_wide = perlang::UTF16String::from_copied_string("ÿ and µ");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("Ωmega 𐐨");
+
+    std::unique_ptr<perlang::String> compact_upper = compact->to_upper();
+    std::unique_ptr<perlang::String> latin1_to_wide_upper = latin1_to_wide->to_upper();
+
+    // Assert
+    REQUIRE(compact_upper->encoding() == perlang::StringEncoding::utf16);
+    REQUIRE(dynamic_cast<perlang::UTF16String&>(*compact_upper).is_compact());
+    REQUIRE(std::string(compact_upper->as_utf8()->bytes()) == "RÄKSMÖRGÅS");
+    REQUIRE(std::string(compact->to_lower()->as_utf8()->bytes()) == "räksmörgås");
+    REQUIRE(std::string(latin1_to_wide_upper->as_utf8()->bytes()) == "Ÿ AND Μ");
+    REQUIRE(std::string(wide->to_upper()->as_utf8()->bytes()) == "ΩMEGA 𐐀");
+    REQUIRE(std::string(wide->to_lower()->as_utf8()->bytes()) == "ωmega 𐐨");
+}
+
+TEST_CASE( "perlang::concat_shared(), returns the same string types as operator+" )
+{
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("abc");
+    std::shared_ptr<perlang::String> utf8_with_ascii_content = perlang::UTF8String::from_static_string("def");
+    std::shared_ptr<perlang::String> non_ascii = perlang::UTF8String::from_static_string("åäö");
+    std::shared_ptr<perlang::String> parent = perlang::UTF8String::from_static_string("a string long enough to be sliced, with non-ASCII content: åäö");
+    std::shared_ptr<perlang::String> ascii_slice = parent->substring(2, 30);
+    std::shared_ptr<perlang::String> non_ascii_slice = parent->substring(35, 30);
+
+    auto check = [](const perlang::String& lhs, const perlang::String& rhs) {
+        std::shared_ptr<perlang::String> shared = perlang::concat_shared(lhs, rhs);
+        std::unique_ptr<perlang::String> expected = lhs + const_cast<perlang::String&>(rhs);
+
+        REQUIRE(typeid(*shared) == typeid(*expected));
+        REQUIRE(*shared == *expected);
+    };
+
+    // Assert
+    check(*ascii, *ascii);
+    check(*ascii, *non_ascii);
+    check(*utf8_with_ascii_content, *ascii);
+    check(*non_ascii, *ascii);
+    check(*ascii_slice, *ascii);
+    check(*ascii_slice, *non_ascii);
+    check(*non_ascii_slice, *ascii);
+    REQUIRE(typeid(*ascii_slice) == typeid(perlang::StringSlice));
+    REQUIRE(typeid(*perlang::concat_shared(*ascii_slice, *ascii)) == typeid(perlang::ASCIIString));
+    REQUIRE(std::string(perlang::concat_shared(*ascii_slice, *non_ascii)->bytes()) == "string long enough to be sliceåäö");
+}
+
+TEST_CASE( "perlang::concat_shared(), falls back to operator+ for ropes and UTF-16 content" )
+{
+    std::string content(perlang::RopeString::THRESHOLD, 'a');
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("abc");
+    std::shared_ptr<perlang::String> long_ascii = perlang::ASCIIString::from_copied_string(content.c_str());
+    std::shared_ptr<perlang::String> utf16 = perlang::UTF16String::from_copied_string("åäö");
+
+    std::shared_ptr<perlang::String> long_result = perlang::concat_shared(*ascii, *long_ascii);
+    std::shared_ptr<perlang::String> utf16_result = perlang::concat_shared(*ascii, *utf16);
+    std::shared_ptr<perlang::String> rope_number_result = perlang::concat_shared(*long_result, 42);
+
+    // Assert
+    REQUIRE(typeid(*long_result) == typeid(perlang::RopeString));
+    REQUIRE(long_result->length() == content.length() + 3);
+    REQUIRE(std::string(utf16_result->bytes()) == "abcåäö");
+    REQUIRE(typeid(*rope_number_result) == typeid(perlang::RopeString));
+    REQUIRE(std::string(rope_number_result->bytes()) == "abc" + content + "42");
+}
+
+TEST_CASE( "perlang::concat_shared(), formats numbers like operator+" )
+{
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("id=");
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("nummer=");
+    BigInt bigint("123456789012345678901234567890");
+
+    // Assert
+    REQUIRE(*perlang::concat_shared(*ascii, (int32_t)-42) == *(*ascii + (int32_t)-42));
+    REQUIRE(*perlang::concat_shared(*ascii, (uint32_t)42) == *(*ascii + (uint32_t)42));
+    REQUIRE(*perlang::concat_shared(*ascii, (int64_t)-1234567890123) == *(*ascii + (int64_t)-1234567890123));
+    REQUIRE(*perlang::concat_shared(*ascii, (uint64_t)18446744073709551615U) == *(*ascii + (uint64_t)18446744073709551615U));
+    REQUIRE(*perlang::concat_shared(*ascii, 2.5f) == *(*ascii + 2.5f));
+    REQUIRE(*perlang::concat_shared(*ascii, 3.141592653589793) == *(*ascii + 3.141592653589793));
+    REQUIRE(*perlang::concat_shared(*ascii, bigint) == *(*ascii + bigint));
+    REQUIRE(typeid(*perlang::concat_shared(*ascii, 42)) == typeid(perlang::ASCIIString));
+    REQUIRE(typeid(*perlang::concat_shared(*utf8, 42)) == typeid(perlang::UTF8String));
+    REQUIRE(std::string(perlang::concat_shared(*utf8, 42)->bytes()) == "nummer=42");
+}
@@ -4,6 +4,7 @@
 #pragma ide diagnostic ignored "bugprone-reserved-identifier"
 
 #include <cstring>
+#include <unistd.h>
 #include <catch2/catch_test_macros.hpp>
 
 #include "perlang_stdlib.h"
@@ -11,9 +12,10 @@
 bool fwrite_mocked = false;
 std::string captured_output;
 
-extern "C" void __real_fwrite(const void *__restrict __ptr, size_t __size, size_t __n, FILE *__restrict __s);
+extern "C" size_t __real_fwrite(const void *__restrict __ptr, size_t __size, size_t __n, FILE *__restrict __s);
 
-extern "C" void __wrap_fwrite(const void *__restrict __ptr, size_t __size, size_t __n, FILE *__restrict __s)
+// The return value matters, since callers (like perlang::text::StreamWriter) check it for write errors.
+extern "C" size_t __wrap_fwrite(const void *__restrict __ptr, size_t __size, size_t __n, FILE *__restrict __s)
 {
     if (fwrite_mocked) {
         // __ptr is not necessarily NUL-terminated at this point, so we must be careful to only copy the data that would
@@ -27,17 +29,33 @@ extern "C" void __wrap_fwrite(const void *__restrict __ptr, size_t __size, size_
         // TODO: handle multiple lines of output. Possibly append to previous list?
         captured_output.erase();
         captured_output.append(captured_output_buffer);
+
+        return __n;
     }
     else {
-        __real_fwrite(__ptr, __size, __n, __s);
+        return __real_fwrite(__ptr, __size, __n, __s);
     }
 }
 
-TEST_CASE( "perlang::print float, 103.1f" )
+// perlang::print() output is buffered, so any output from other tests must be flushed before the capturing starts, and
+// the output being captured must be flushed before it ends.
+static void begin_capture()
 {
+    perlang::flush();
     fwrite_mocked = true;
-    perlang::print(103.1f);
+}
+
+static void end_capture()
+{
+    perlang::flush();
     fwrite_mocked = false;
+}
+
+TEST_CASE( "perlang::print float, 103.1f" )
+{
+    begin_capture();
+    perlang::print(103.1f);
+    end_capture();
 
     REQUIRE(captured_output == "103.1\n");
 }
@@ -46,65 +64,93 @@ TEST_CASE( "perlang::print float, positive infinity" )
 {
     float f = 1.0f / 0.0f;
 
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(f);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "Infinity\n");
 }
 
 TEST_CASE( "perlang::print double, 123.45" )
 {
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(123.45);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "123.45\n");
 }
 
 TEST_CASE( "perlang::print double, -46.0" )
 {
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(-46.0);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "-46\n");
 }
 
 TEST_CASE( "perlang::print double, 4294967296.123" )
 {
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(4294967296.123);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "4294967296.123\n");
 }
 
 TEST_CASE( "perlang::print double, 4294967283" )
 {
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(4294967283.0);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "4294967283\n");
 }
 
 TEST_CASE( "perlang::print double, 9223372036854775807" )
 {
-    fwrite_mocked = true;
+    begin_capture();
     perlang::print(9223372036854775807.0);
-    fwrite_mocked = false;
+    end_capture();
 
     REQUIRE(captured_output == "9.22337203685478E+18\n");
 }
 
-// TODO: Make this test work. We need to (linker-)wrap puts to make it happen.
 TEST_CASE( "perlang::print BigInt, 18446744073709551616" )
 {
-//    // TODO: delete the above, keep this
-//    fwrite_mocked = true;
-//    perlang::print(BigInt("18446744073709551616"));
-//    fwrite_mocked = false;
-//
-//    CHECK_EQ("18446744073709551616\n", captured_output);
+    begin_capture();
+    perlang::print(BigInt("18446744073709551616"));
+    end_capture();
+
+    REQUIRE(captured_output == "18446744073709551616\n");
+}
+
+TEST_CASE( "perlang::print, output is buffered until flushed" )
+{
+    begin_capture();
+    captured_output = "nothing written";
+
+    perlang::print(int32_t { 42 });
+    perlang::print(int64_t { -9223372036854775807 - 1 });
+    perlang::print(uint64_t { 18446744073709551615U });
+    perlang::print(true);
+    perlang::print('c');
+    perlang::print(u'å');
+    perlang::print(perlang::ASCIIString::from_static_string("ASCII"));
+    perlang::print(perlang::UTF8String::from_static_string("すし"));
+    perlang::print(static_cast<const perlang::String*>(nullptr));
+    perlang::print();
+
+    std::string before_flush = captured_output;
+
+    end_capture();
+
+    // When stdout is a terminal, each line is flushed separately; the last one being the empty line.
+    if (isatty(fileno(stdout))) {
+        REQUIRE(captured_output == "\n");
+    }
+    else {
+        REQUIRE(before_flush == "nothing written");
+        REQUIRE(captured_output == "42\n-9223372036854775808\n18446744073709551615\ntrue\nc\nå\nASCII\nすし\nnull\n\n");
+    }
 }
@@ -0,0 +1,108 @@
+// rope_string.cc - tests for the perlang::RopeString class
+
+#include <memory>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+TEST_CASE( "perlang::RopeString, operator+ returns a flat string below the threshold" )
+{
+    std::unique_ptr<perlang::String> s = *perlang::ASCIIString::from_static_string("foo") + *perlang::UTF8String::from_static_string("bar");
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::RopeString*>(s.get()) == nullptr);
+}
+
+TEST_CASE( "perlang::RopeString, operator+ returns a rope at or above the threshold" )
+{
+    std::string long_content(perlang::RopeString::THRESHOLD, 'a');
+    std::unique_ptr<perlang::String> s = *perlang::ASCIIString::from_static_string("") + *perlang::UTF8String::from_copied_string(long_content.c_str());
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::RopeString*>(s.get()) != nullptr);
+    REQUIRE(s->length() == perlang::RopeString::THRESHOLD);
+    REQUIRE(std::string(s->bytes()) == long_content);
+}
+
+TEST_CASE( "perlang::RopeString, chained concatenation produces the expected content" )
+{
+    std::string expected;
+    std::unique_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("");
+
+    for (int i = 0; i < 1000; i++) {
+        std::string part = "part " + std::to_string(i) + ", ";
+        expected += part;
+
+        // Mimics the code generated for chained string concatenation, where each operand is a temporary.
+        s = *s + *perlang::ASCIIString::from_copied_string(part.c_str());
+    }
+
+    // Assert
+    REQUIRE(s->length() == expected.length());
+    REQUIRE(std::string(s->bytes()) == expected);
+    REQUIRE(s->is_ascii());
+}
+
+TEST_CASE( "perlang::RopeString, shared operands are referenced and may be concatenated repeatedly" )
+{
+    std::shared_ptr<perlang::String> part = perlang::ASCIIString::from_copied_string(std::string(200, 'x').c_str());
+    std::shared_ptr<perlang::String> s = *part + *part;
+
+    for (int i = 0; i < 3; i++) {
+        s = *s + *s;
+    }
+
+    // Assert
+    REQUIRE(s->length() == 200 * 16);
+    REQUIRE(std::string(s->bytes()) == std::string(200 * 16, 'x'));
+}
+
+TEST_CASE( "perlang::RopeString, tracks non-ASCII content and compares equal to the flat string" )
+{
+    std::string long_content(perlang::RopeString::THRESHOLD, 'a');
+    std::unique_ptr<perlang::String> s = *perlang::ASCIIString::from_copied_string(long_content.c_str()) + *perlang::UTF8String::from_static_string("åäö");
+
+    // Assert
+    REQUIRE_FALSE(s->is_ascii());
+    REQUIRE(*s->get_type() == *perlang::ASCIIString::from_static_string("perlang.UTF8String"));
+    std::unique_ptr<perlang::String> flat = perlang::UTF8String::from_copied_string((long_content + "åäö").c_str());
+    REQUIRE(*s == *flat);
+    REQUIRE(*flat == *s);
+}
+
+TEST_CASE( "perlang::RopeString, concatenation with numbers" )
+{
+    std::string long_content(perlang::RopeString::THRESHOLD, 'a');
+    std::unique_ptr<perlang::String> s = *perlang::ASCIIString::from_static_string("") + *perlang::ASCIIString::from_copied_string(long_content.c_str());
+
+    s = *(*(*s + (int64_t)-42) + (uint64_t)42) + 1.5;
+
+    // Assert
+    REQUIRE(std::string(s->bytes()) == long_content + "-42421.5");
+}
+
+TEST_CASE( "perlang::RopeString, UTF16String operands are converted to UTF-8" )
+{
+    std::string long_content(perlang::RopeString::THRESHOLD, 'a');
+    std::unique_ptr<perlang::String> s = *perlang::ASCIIString::from_static_string("") + *perlang::ASCIIString::from_copied_string(long_content.c_str());
+
+    s = *s + *perlang::UTF16String::from_copied_string("åäö");
+
+    // Assert
+    REQUIRE(std::string(s->bytes()) == long_content + "åäö");
+}
+
+TEST_CASE( "perlang::RopeString, very deep ropes can be flattened and destroyed" )
+{
+    std::unique_ptr<perlang::String> s = perlang::ASCIIString::from_copied_string(std::string(perlang::RopeString::THRESHOLD, 'a').c_str());
+    std::shared_ptr<perlang::String> x = perlang::ASCIIString::from_static_string("x");
+
+    for (int i = 0; i < 1000000; i++) {
+        s = *s + *x;
+    }
+
+    // Assert
+    REQUIRE(s->length() == perlang::RopeString::THRESHOLD + 1000000);
+    REQUIRE(s->bytes()[perlang::RopeString::THRESHOLD + 999999] == 'x');
+}
@@ -0,0 +1,145 @@
+// stream_writer.cc - tests for the perlang::text::StreamWriter class
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+// Reads back everything written to a temporary file.
+static std::string read_all(FILE* file)
+{
+    std::string result;
+    char buffer[4096];
+    size_t read;
+
+    rewind(file);
+
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        result.append(buffer, read);
+    }
+
+    return result;
+}
+
+TEST_CASE( "perlang::text::StreamWriter, writes content to a file descriptor when flushed" )
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    perlang::text::StreamWriter writer(fileno(file));
+    writer.append(*perlang::ASCIIString::from_static_string("Hello, "));
+    writer.append("åäö");
+    writer.append(' ');
+    writer.append(int64_t { -42 });
+    writer.append(' ');
+    writer.append(true);
+    writer.append_line();
+
+    // Nothing is written before the buffer is full or flushed.
+    REQUIRE(read_all(file).empty());
+    REQUIRE(writer.bytes_written() == 23);
+
+    writer.flush();
+
+    // Assert
+    REQUIRE(read_all(file) == "Hello, åäö -42 true\n");
+    REQUIRE_FALSE(writer.is_ascii());
+
+    fclose(file);
+}
+
+TEST_CASE( "perlang::text::StreamWriter, writes content to a stream when flushed" )
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    {
+        perlang::text::StreamWriter writer(file);
+        writer.append_line(*perlang::UTF8String::from_static_string("すし"));
+        writer.append(1.5);
+
+        // The content is flushed when the writer is destroyed.
+    }
+
+    // Assert
+    REQUIRE(read_all(file) == "すし\n1.5");
+
+    fclose(file);
+}
+
+TEST_CASE( "perlang::text::StreamWriter, output larger than the buffer is written in chunks" )
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    std::string expected;
+
+    {
+        perlang::text::StreamWriter writer(fileno(file), 100);
+
+        for (int i = 0; i < 1000; i++) {
+            writer.append(int32_t { i });
+            writer.append(',');
+            expected += std::to_string(i) + ",";
+        }
+
+        // Content larger than the buffer, which is written directly, and content which straddles the end of the buffer.
+        std::string large(1000, 'x');
+        writer.append(large.c_str(), large.length());
+        writer.append_repeat('y', 250);
+        writer.append("0123456789012345678901234567890123456789012345678901234567890123456789");
+
+        expected += large + std::string(250, 'y') + "0123456789012345678901234567890123456789012345678901234567890123456789";
+
+        REQUIRE(writer.bytes_written() == expected.length());
+    }
+
+    // Assert
+    REQUIRE(read_all(file) == expected);
+
+    fclose(file);
+}
+
+TEST_CASE( "perlang::text::StreamWriter, tiny buffer sizes are rounded up" )
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    {
+        perlang::text::StreamWriter writer(fileno(file), 1);
+        writer.append(UINT64_MAX);
+        writer.append(INT64_MIN);
+        writer.append(u'す');
+    }
+
+    // Assert
+    REQUIRE(read_all(file) == "18446744073709551615-9223372036854775808す");
+
+    fclose(file);
+}
+
+TEST_CASE( "perlang::text::StreamWriter, throws an exception on write errors" )
+{
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+
+    int fd = dup(fileno(file));
+    perlang::text::StreamWriter writer(fd);
+    writer.append("content");
+
+    close(fd);
+
+    // Assert
+    REQUIRE_THROWS_AS(writer.flush(), std::runtime_error);
+
+    fclose(file);
+}
+
+TEST_CASE( "perlang::text::StreamWriter, invalid arguments" )
+{
+    REQUIRE_THROWS_AS(perlang::text::StreamWriter(-1), std::invalid_argument);
+    REQUIRE_THROWS_AS(perlang::text::StreamWriter(static_cast<FILE*>(nullptr)), std::invalid_argument);
+}
@@ -13,7 +13,7 @@ TEST_CASE( "perlang::text::StringBuilder::append, resizing the string beyond its
         sb.append(*perlang::ASCIIString::from_static_string("this is an ASCII string"));
     }
 
-    uint expected_length = 100 * strlen("this is an ASCII string");
+    size_t expected_length = 100 * strlen("this is an ASCII string");
 
     // Assert
     REQUIRE(sb.length() == expected_length);
@@ -72,3 +72,220 @@ TEST_CASE( "perlang::text::StringBuilder::append, UTF8 string" )
     // Assert
     REQUIRE(*sb.to_string() == *perlang::UTF8String::from_static_string("this is a UTF8 string: åäöÅÄÖéèüÜÿŸïÏすし"));
 }
+
+TEST_CASE( "perlang::text::StringBuilder, short content is kept in the inline buffer" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append(*perlang::ASCIIString::from_static_string("short"));
+
+    // Assert
+    REQUIRE(sb.capacity() == perlang::text::StringBuilder::INLINE_CAPACITY);
+    REQUIRE(std::string(sb.to_string()->bytes()) == "short");
+}
+
+TEST_CASE( "perlang::text::StringBuilder::append, grows the capacity geometrically" )
+{
+    perlang::text::StringBuilder sb;
+    size_t reallocations = 0;
+    size_t previous_capacity = sb.capacity();
+
+    for (int i = 0; i < 100000; i++) {
+        sb.append(*perlang::ASCIIString::from_static_string("0123456789"));
+
+        if (sb.capacity() != previous_capacity) {
+            REQUIRE(sb.capacity() >= previous_capacity * 2);
+
+            previous_capacity = sb.capacity();
+            reallocations++;
+        }
+    }
+
+    // Assert
+    REQUIRE(sb.length() == 1000000);
+    REQUIRE(reallocations < 20);
+}
+
+TEST_CASE( "perlang::text::StringBuilder, reserve() and the capacity constructor preallocate the buffer" )
+{
+    perlang::text::StringBuilder sb1(10000);
+    perlang::text::StringBuilder sb2;
+    sb2.append(*perlang::ASCIIString::from_static_string("content which is kept when growing, "));
+    sb2.reserve(5000);
+
+    // Assert
+    REQUIRE(sb1.capacity() == 10000);
+    REQUIRE(sb1.length() == 0);
+    REQUIRE(sb2.capacity() == 5000);
+
+    sb2.append(*perlang::ASCIIString::from_static_string("and after it"));
+    REQUIRE(std::string(sb2.to_string()->bytes()) == "content which is kept when growing, and after it");
+
+    // Reserving less than the current capacity is a no-op.
+    sb2.reserve(10);
+    REQUIRE(sb2.capacity() == 5000);
+}
+
+TEST_CASE( "perlang::text::StringBuilder::append, numbers are formatted like in string concatenation" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append(int32_t { -2147483647 - 1 });
+    sb.append(' ');
+    sb.append(uint32_t { 4294967295 });
+    sb.append(' ');
+    sb.append(int64_t { INT64_MIN });
+    sb.append(' ');
+    sb.append(int64_t { 0 });
+    sb.append(' ');
+    sb.append(uint64_t { UINT64_MAX });
+    sb.append(' ');
+    sb.append(1.5f);
+    sb.append(' ');
+    sb.append(123.456);
+    sb.append(' ');
+    sb.append(BigInt("-123456789012345678901234567890"));
+
+    // Assert
+    REQUIRE(std::string(sb.to_string()->bytes()) ==
+            "-2147483648 4294967295 -9223372036854775808 0 18446744073709551615 1.5 123.456 "
+            "-123456789012345678901234567890");
+
+    // The results should match the ones from the concatenation operators.
+    auto empty = perlang::ASCIIString::from_static_string("");
+
+    for (double value : { 0.1, 1e100, -0.0, 1.0 / 3 }) {
+        perlang::text::StringBuilder sb2;
+        sb2.append(value);
+
+        REQUIRE(std::string(sb2.to_string()->bytes()) == (*empty + value)->bytes());
+    }
+}
+
+TEST_CASE( "perlang::text::StringBuilder::append, bool, char and C string values" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append(true);
+    sb.append(',');
+    sb.append(false);
+    sb.append(',');
+    sb.append("literal");
+    sb.append(",partial", 5);
+
+    // Assert
+    REQUIRE(std::string(sb.to_string()->bytes()) == "true,false,literal,part");
+    REQUIRE_THROWS_AS(sb.append(static_cast<const char*>(nullptr)), std::invalid_argument);
+}
+
+TEST_CASE( "perlang::text::StringBuilder::append, char16_t values are encoded as UTF-8" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append(u'A');
+    sb.append(u'å');
+    sb.append(u'す');
+    sb.append(char16_t { 0xD83D }); // Unpaired surrogate
+
+    // Assert
+    REQUIRE(std::string(sb.to_string()->bytes()) == "Aåす�");
+}
+
+TEST_CASE( "perlang::text::StringBuilder::append_repeat and append_line" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append_repeat('-', 3);
+    sb.append_line();
+    sb.append_repeat('=', 0);
+    sb.append_line(*perlang::ASCIIString::from_static_string("line"));
+    sb.append_repeat('*', 200);
+
+    // Assert
+    REQUIRE(std::string(sb.to_string()->bytes()) == "---\nline\n" + std::string(200, '*'));
+}
+
+TEST_CASE( "perlang::text::StringBuilder::to_string, returns an ASCIIString for ASCII-only content" )
+{
+    perlang::text::StringBuilder sb;
+    sb.append(*perlang::UTF8String::from_static_string("ASCII content in a UTF8String, "));
+    sb.append(int64_t { 42 });
+    sb.append(u'!');
+
+    REQUIRE(sb.is_ascii());
+
+    auto result = sb.to_string();
+    REQUIRE(dynamic_cast<perlang::ASCIIString*>(result.get()) != nullptr);
+    REQUIRE(std::string(result->bytes()) == "ASCII content in a UTF8String, 42!");
+
+    // The builder can still be used after to_string().
+    sb.append(u'å');
+
+    REQUIRE_FALSE(sb.is_ascii());
+
+    result = sb.to_string();
+    REQUIRE(dynamic_cast<perlang::UTF8String*>(result.get()) != nullptr);
+    REQUIRE(std::string(result->bytes()) == "ASCII content in a UTF8String, 42!å");
+}
+
+TEST_CASE( "perlang::text::StringBuilder, non-ASCII content is detected for all kinds of appends" )
+{
+    perlang::text::StringBuilder sb1;
+    sb1.append("åäö", 2);
+
+    perlang::text::StringBuilder sb2;
+    sb2.append((char)0xC3);
+
+    perlang::text::StringBuilder sb3;
+    sb3.append_repeat((char)0xFF, 1);
+
+    perlang::text::StringBuilder sb4;
+    sb4.append(*perlang::UTF8String::from_static_string("すし"));
+
+    perlang::text::StringBuilder sb5;
+    sb5.append_repeat((char)0xFF, 0);
+
+    // Assert
+    REQUIRE_FALSE(sb1.is_ascii());
+    REQUIRE_FALSE(sb2.is_ascii());
+    REQUIRE_FALSE(sb3.is_ascii());
+    REQUIRE_FALSE(sb4.is_ascii());
+    REQUIRE(sb5.is_ascii());
+}
+
+TEST_CASE( "perlang::text::StringBuilder::release_string, hands over the content and empties the builder" )
+{
+    std::string expected;
+    perlang::text::StringBuilder sb;
+
+    for (int i = 0; i < 1000; i++) {
+        sb.append("a line of text, ");
+        expected += "a line of text, ";
+    }
+
+    auto result = sb.release_string();
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::ASCIIString*>(result.get()) != nullptr);
+    REQUIRE(result->length() == expected.length());
+    REQUIRE(std::string(result->bytes()) == expected);
+
+    REQUIRE(sb.length() == 0);
+    REQUIRE(sb.capacity() == perlang::text::StringBuilder::INLINE_CAPACITY);
+    REQUIRE(sb.is_ascii());
+
+    // The builder can be reused afterwards.
+    sb.append("åäö");
+    result = sb.release_string();
+
+    REQUIRE(dynamic_cast<perlang::UTF8String*>(result.get()) != nullptr);
+    REQUIRE(std::string(result->bytes()) == "åäö");
+}
+
+TEST_CASE( "perlang::text::StringBuilder::release_string, works for oversized buffers" )
+{
+    perlang::text::StringBuilder sb(1024 * 1024);
+    sb.append_repeat('x', 1000);
+    sb.append(u'ÿ');
+
+    auto result = sb.release_string();
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::UTF8String*>(result.get()) != nullptr);
+    REQUIRE(std::string(result->bytes()) == std::string(1000, 'x') + "ÿ");
+}
@@ -0,0 +1,83 @@
+// string_hash_set.cc - tests for the perlang::collections::StringHashSet and MutableStringHashSet classes
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+#include "collections/mutable_string_hash_set.h"
+#include "collections/string_hash_set.h"
+
+TEST_CASE( "perlang::collections::MutableStringHashSet, contains() returns true for existing ASCII key" )
+{
+    perlang::collections::MutableStringHashSet set;
+    set.add("foo");
+    set.add("bar");
+
+    REQUIRE(set.contains("foo"));
+    REQUIRE(set.contains("bar"));
+}
+
+TEST_CASE( "perlang::collections::MutableStringHashSet, contains() returns false for missing key" )
+{
+    perlang::collections::MutableStringHashSet set;
+    set.add("foo");
+
+    REQUIRE_FALSE(set.contains("fo"));
+    REQUIRE_FALSE(set.contains("fooo"));
+    REQUIRE_FALSE(set.contains(""));
+}
+
+TEST_CASE( "perlang::collections::MutableStringHashSet, contains() finds UTF8String key" )
+{
+    perlang::collections::MutableStringHashSet set;
+    set.add(perlang::UTF8String::from_static_string("åäö"));
+
+    REQUIRE(set.contains("åäö"));
+}
+
+TEST_CASE( "perlang::collections::MutableStringHashSet, contains() matches UTF16String key" )
+{
+    // UTF16String instances compare equal to strings of other types with the same content, so they must be found by
+    // UTF-8 lookups.
+    perlang::collections::MutableStringHashSet set;
+    set.add(perlang::UTF8String::from_static_string("ab")->as_utf16());
+    set.add(perlang::UTF8String::from_static_string("åäö")->as_utf16());
+
+    REQUIRE(set.contains("ab"));
+    REQUIRE(set.contains("åäö"));
+    REQUIRE_FALSE(set.contains("abc"));
+}
+
+TEST_CASE( "perlang::collections::MutableStringHashSet, contains() finds ASCIIString key using UTF16String" )
+{
+    perlang::collections::MutableStringHashSet set;
+    set.add("while");
+    set.add(perlang::UTF8String::from_static_string("för"));
+
+    REQUIRE(set.contains(perlang::UTF8String::from_static_string("while")->as_utf16()));
+    REQUIRE(set.contains(perlang::UTF8String::from_static_string("för")->as_utf16()));
+    REQUIRE_FALSE(set.contains(perlang::UTF8String::from_static_string("whilé")->as_utf16()));
+}
+
+TEST_CASE( "perlang::collections::StringHashSet, contains() returns true for existing key" )
+{
+    perlang::collections::MutableStringHashSet mutable_set;
+    mutable_set.add("foo");
+    mutable_set.add("bar");
+
+    perlang::collections::StringHashSet set(mutable_set);
+
+    REQUIRE(set.contains("foo"));
+    REQUIRE(set.contains("bar"));
+    REQUIRE_FALSE(set.contains("baz"));
+}
+
+TEST_CASE( "perlang::collections::StringHashSet, contains() returns false for missing non-ASCII key" )
+{
+    perlang::collections::MutableStringHashSet mutable_set;
+    mutable_set.add("foo");
+
+    perlang::collections::StringHashSet set(mutable_set);
+
+    // The key used to be converted to an ASCIIString for the lookup, which threw an exception for non-ASCII keys.
+    REQUIRE_FALSE(set.contains("föö"));
+}
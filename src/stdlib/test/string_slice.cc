@@ -0,0 +1,163 @@
+// string_slice.cc - tests for the perlang::StringSlice class and String::substring()
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+#include "perlang_stdlib.h"
+
+static std::string content_of(const perlang::String& s)
+{
+    return std::string(s.bytes(), s.length());
+}
+
+TEST_CASE( "perlang::StringSlice, substring of shared ASCIIString shares its content" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello, world! This is a string long enough to be sliced.");
+    std::unique_ptr<perlang::String> slice = s->substring(7, 30);
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::StringSlice*>(slice.get()) != nullptr);
+    REQUIRE(slice->bytes() == s->bytes() + 7);
+    REQUIRE(content_of(*slice) == "world! This is a string long e");
+    REQUIRE(slice->is_ascii());
+    REQUIRE(*slice->get_type() == *perlang::ASCIIString::from_static_string("perlang.ASCIIString"));
+}
+
+TEST_CASE( "perlang::StringSlice, substring which fits inline is copied" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello, world");
+    std::unique_ptr<perlang::String> slice = s->substring(7, 5);
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::StringSlice*>(slice.get()) == nullptr);
+    REQUIRE(content_of(*slice) == "world");
+    REQUIRE(slice->is_ascii());
+}
+
+TEST_CASE( "perlang::StringSlice, keeps the parent string alive" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_copied_string("some heap-allocated content which is not inline");
+    std::unique_ptr<perlang::String> slice = s->substring(5, 27);
+    s.reset();
+
+    // Assert
+    REQUIRE(content_of(*slice) == "heap-allocated content whic");
+}
+
+TEST_CASE( "perlang::StringSlice, substring of temporary string is copied" )
+{
+    std::unique_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello, world! This is a string long enough to be sliced.");
+    std::unique_ptr<perlang::String> slice = s->substring(0, 30);
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::StringSlice*>(slice.get()) == nullptr);
+    REQUIRE(content_of(*slice) == "hello, world! This is a string");
+}
+
+TEST_CASE( "perlang::StringSlice, substring of slice refers to the original parent" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello, world! This is a string long enough to be sliced.");
+    std::shared_ptr<perlang::String> slice = s->substring(7, 40);
+    std::unique_ptr<perlang::String> inner_slice = slice->substring(1, 30);
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::StringSlice*>(inner_slice.get()) != nullptr);
+    REQUIRE(inner_slice->bytes() == s->bytes() + 8);
+    REQUIRE(content_of(*inner_slice) == "orld! This is a string long en");
+}
+
+TEST_CASE( "perlang::StringSlice, substring of UTF8String at code point boundaries" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("åäö abc");
+    std::unique_ptr<perlang::String> non_ascii = s->substring(2, 4);
+    std::unique_ptr<perlang::String> ascii = s->substring(7, 3);
+
+    // Assert
+    REQUIRE(content_of(*non_ascii) == "äö");
+    REQUIRE_FALSE(non_ascii->is_ascii());
+    REQUIRE(content_of(*ascii) == "abc");
+    REQUIRE(ascii->is_ascii());
+}
+
+TEST_CASE( "perlang::StringSlice, substring splitting a UTF-8 sequence throws an exception" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("åäö");
+
+    // Assert
+    REQUIRE_THROWS_AS(s->substring(1, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(s->substring(0, 3), std::invalid_argument);
+}
+
+TEST_CASE( "perlang::StringSlice, substring outside of the string throws an exception" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("hello");
+
+    // Assert
+    REQUIRE_THROWS_AS(s->substring(6, 0), std::out_of_range);
+    REQUIRE_THROWS_AS(s->substring(3, 3), std::out_of_range);
+    REQUIRE(s->substring(5, 0)->length() == 0);
+}
+
+TEST_CASE( "perlang::StringSlice, compares equal to strings with the same content" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("a string which is long enough to be sliced, and then some");
+    std::shared_ptr<perlang::String> slice = s->substring(0, 42);
+    std::shared_ptr<perlang::String> ascii = perlang::ASCIIString::from_static_string("a string which is long enough to be sliced");
+    std::shared_ptr<perlang::String> utf8 = perlang::UTF8String::from_static_string("a string which is long enough to be sliced");
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::StringSlice*>(slice.get()) != nullptr);
+    REQUIRE(*slice == *ascii);
+    REQUIRE(*utf8 == *slice);
+    REQUIRE_FALSE(*slice == *s);
+    REQUIRE(slice->hash() == ascii->hash());
+}
+
+TEST_CASE( "perlang::StringSlice, concatenation" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF8String::from_static_string("a string which is long enough to be sliced, with non-ASCII content: åäö");
+    std::shared_ptr<perlang::String> ascii = s->substring(0, 42);
+    std::shared_ptr<perlang::String> non_ascii = s->substring(44, 30);
+
+    // Assert
+    REQUIRE(content_of(*(*ascii + *non_ascii)) == "a string which is long enough to be slicedwith non-ASCII content: åäö");
+    REQUIRE(content_of(*(*perlang::ASCIIString::from_static_string("> ") + *non_ascii)) == "> with non-ASCII content: åäö");
+    REQUIRE(content_of(*(*ascii + (int64_t)42)) == "a string which is long enough to be sliced42");
+}
+
+TEST_CASE( "perlang::StringSlice, release_bytes() returns a NUL-terminated copy" )
+{
+    std::shared_ptr<perlang::String> s = perlang::ASCIIString::from_static_string("a string which is long enough to be sliced, and then some");
+    std::unique_ptr<perlang::String> slice = s->substring(0, 42);
+
+    // Assert
+    REQUIRE(std::string(slice->release_bytes().get()) == "a string which is long enough to be sliced");
+}
+
+TEST_CASE( "perlang::UTF16String, substring() copies the given range" )
+{
+    std::shared_ptr<perlang::String> s = perlang::UTF16String::from_copied_string("hello, world");
+    std::unique_ptr<perlang::String> slice = s->substring(7, 5);
+
+    // Assert
+    REQUIRE(dynamic_cast<perlang::UTF16String*>(slice.get()) != nullptr);
+    REQUIRE(content_of(*slice->as_utf8()) == "world");
+}
+
+TEST_CASE( "perlang::StringSlice, as_ascii() shares the content of the parent when the slice extends to its end" )
+{
+    std::string content(100, 'x');
+    std::shared_ptr<perlang::String> parent = perlang::ASCIIString::make_shared_copy(content.c_str(), content.length());
+
+    auto tail = parent->substring(50, 50);
+    auto middle = parent->substring(25, 50);
+
+    REQUIRE(tail->as_ascii()->bytes() == tail->bytes());
+    REQUIRE(tail->as_utf8()->bytes() == tail->bytes());
+    REQUIRE(middle->as_ascii()->bytes() != middle->bytes());
+
+    // The copy must be NUL-terminated, unlike the slice itself.
+    REQUIRE(std::string(middle->as_ascii()->bytes()) == content.substr(25, 50));
+}
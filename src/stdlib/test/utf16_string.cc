@@ -44,3 +44,177 @@ TEST_CASE( "perlang::UTF16String::is_ascii(), returns true for non-ASCII string"
     // Assert
     REQUIRE_FALSE(s->is_ascii());
 }
+
+TEST_CASE( "perlang::UTF16String::as_utf8(), returns an identical string for non-ASCII string" )
+{
+    std::string original_utf8 = "this is a string with non-ASCII characters: åäöÅÄÖéèüÜÿŸïÏすし🎉";
+    std::unique_ptr<perlang::UTF16String> s = perlang::UTF16String::from_copied_string(original_utf8.c_str());
+
+    std::unique_ptr<perlang::UTF8String> utf8 = s->as_utf8();
+
+    // Assert
+    REQUIRE(utf8->length() == original_utf8.length());
+    REQUIRE(std::string(utf8->bytes()) == original_utf8);
+}
+
+TEST_CASE( "perlang::UTF16String::as_utf8(), throws an exception for unpaired surrogates" )
+{
+    std::unique_ptr<perlang::UTF16String> s = perlang::UTF16String::from_owned_string({ 'a', 0xD83C, 'b', 0 });
+
+    // Act & Assert
+    REQUIRE_THROWS_WITH(s->as_utf8(), "Invalid UTF-16 sequence encountered (high surrogate not followed by a low surrogate)");
+}
+
+TEST_CASE( "perlang::UTF16String, ASCII and Latin-1 content is stored compactly" )
+{
+    std::unique_ptr<perlang::UTF16String> ascii = perlang::UTF16String::from_copied_string("hello");
+    std::unique_ptr<perlang::UTF16String> latin1 = perlang::UTF16String::from_copied_string("räksmörgås");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("Ÿ is U+0178");
+
+    // Assert
+    REQUIRE(ascii->is_compact());
+    REQUIRE(latin1->is_compact());
+    REQUIRE_FALSE(wide->is_compact());
+    REQUIRE(perlang::ASCIIString::from_static_string("hello")->as_utf16()->is_compact());
+    REQUIRE(perlang::UTF16String::from_owned_string({ 'a', 0xFF, 0 })->is_compact());
+    REQUIRE_FALSE(perlang::UTF16String::from_owned_string({ 'a', 0x100, 0 })->is_compact());
+}
+
+TEST_CASE( "perlang::UTF16String::operator[], returns the same characters for compact and non-compact strings" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("räksmörgås");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("räksmörgås€");
+
+    // Assert
+    REQUIRE(compact->length() == 10);
+    REQUIRE(wide->length() == 11);
+
+    for (size_t i = 0; i < compact->length(); i++) {
+        REQUIRE((*compact)[i] == (*wide)[i]);
+    }
+
+    REQUIRE((*compact)[1] == u'ä');
+    REQUIRE((*wide)[10] == u'€');
+    REQUIRE_THROWS_AS((*compact)[10], std::out_of_range);
+}
+
+TEST_CASE( "perlang::UTF16String::bytes(), returns UTF-16 code units for compact strings" )
+{
+    std::unique_ptr<perlang::UTF16String> s = perlang::UTF16String::from_copied_string("smörgås");
+    auto code_units = reinterpret_cast<const char16_t*>(s->bytes());
+
+    // Assert
+    REQUIRE(std::u16string(code_units, s->length()) == u"smörgås");
+    REQUIRE(code_units[s->length()] == 0);
+
+    // The widened content is created once, and then reused.
+    REQUIRE(s->bytes() == reinterpret_cast<const char*>(code_units));
+}
+
+TEST_CASE( "perlang::UTF16String, conversions of compact strings preserve the content" )
+{
+    std::unique_ptr<perlang::UTF16String> ascii = perlang::UTF16String::from_copied_string("hello world");
+    std::unique_ptr<perlang::UTF16String> latin1 = perlang::UTF16String::from_copied_string("räksmörgås");
+
+    // Assert
+    REQUIRE(std::string(ascii->as_ascii()->bytes()) == "hello world");
+    REQUIRE(std::string(ascii->as_utf8()->bytes()) == "hello world");
+    REQUIRE(std::string(latin1->as_utf8()->bytes()) == "räksmörgås");
+    REQUIRE_THROWS_AS(latin1->as_ascii(), std::invalid_argument);
+    REQUIRE(latin1->as_utf16()->is_compact());
+    REQUIRE(std::string(latin1->substring(4, 6)->as_utf8()->bytes()) == "mörgås");
+    REQUIRE(std::string((*ascii + std::string("!"))->as_utf8()->bytes()) == "hello world!");
+}
+
+TEST_CASE( "perlang::UTF16String, compact strings compare and hash equal to strings of other types" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("räksmörgås");
+    std::unique_ptr<perlang::UTF8String> utf8 = perlang::UTF8String::from_copied_string("räksmörgås");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("räksmörgås€");
+
+    // Assert
+    REQUIRE(*compact == *utf8);
+    REQUIRE(compact->hash() == utf8->hash());
+    REQUIRE(compact->compare(*wide) < 0);
+    REQUIRE(compact->index_of(*perlang::UTF8String::from_copied_string("gås")) == 7);
+}
+
+TEST_CASE( "perlang::UTF16String::operator+(std::string), appends ASCII content to both representations" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("år ");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("€ ");
+
+    std::unique_ptr<perlang::String> compact_result = *compact + int64_t { 2024 };
+    std::unique_ptr<perlang::String> wide_result = *wide + int64_t { 42 };
+
+    // Assert
+    REQUIRE(compact_result->length() == 7);
+    REQUIRE(std::string(compact_result->as_utf8()->bytes()) == "år 2024");
+    REQUIRE(wide_result->length() == 4);
+    REQUIRE(std::string(wide_result->as_utf8()->bytes()) == "€ 42");
+}
+
+TEST_CASE( "perlang::UTF16String::operator+, formats numbers like the other string types" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("å ");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("€ ");
+
+    // Assert
+    REQUIRE(std::string((*compact + uint64_t { 18446744073709551615ULL })->as_utf8()->bytes()) == "å 18446744073709551615");
+    REQUIRE(std::string((*compact + 1.5f)->as_utf8()->bytes()) == "å 1.5");
+    REQUIRE(std::string((*wide + 0.1)->as_utf8()->bytes()) == "€ 0.1");
+    REQUIRE(std::string((*wide + int64_t { -7 })->as_utf8()->bytes()) == "€ -7");
+    REQUIRE(static_cast<perlang::UTF16String&>(*(*compact + 2.25)).is_compact());
+}
+
+TEST_CASE( "perlang::UTF16String, compact strings are compared and searched like other strings" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("  räksmörgås  ");
+    std::unique_ptr<perlang::UTF16String> wide = perlang::UTF16String::from_copied_string("räksmörgås€");
+    std::unique_ptr<perlang::UTF16String> gas = perlang::UTF16String::from_copied_string("gås");
+    std::unique_ptr<perlang::UTF8String> utf8 = perlang::UTF8String::from_copied_string("  räksmörgås  ");
+    std::unique_ptr<perlang::ASCIIString> ascii = perlang::ASCIIString::from_static_string("  r");
+
+    // Assert
+    REQUIRE(*compact == *utf8);
+    REQUIRE(utf8->compare(*compact) == 0);
+    REQUIRE_FALSE(*compact == *ascii);
+    REQUIRE(*perlang::UTF16String::from_copied_string("  r") == *ascii);
+    REQUIRE_FALSE(*compact == *perlang::UTF16String::from_copied_string("  räksmörgås €"));
+    REQUIRE(compact->compare(*utf8) == 0);
+    REQUIRE(compact->compare(*ascii) > 0);
+    REQUIRE(ascii->compare(*compact) < 0);
+    REQUIRE(gas->compare(*wide) < 0);
+    REQUIRE(wide->compare(*gas) > 0);
+    REQUIRE(perlang::UTF8String::from_copied_string("ä")->compare(*gas) > 0);
+
+    REQUIRE(compact->index_of(*gas) == 9);
+    REQUIRE(compact->index_of(*perlang::ASCIIString::from_static_string("s")) == 5);
+    REQUIRE(compact->last_index_of(*perlang::ASCIIString::from_static_string("s")) == 11);
+    REQUIRE(compact->index_of(*wide) == -1);
+    REQUIRE(wide->index_of(*gas) == 7);
+    REQUIRE(wide->last_index_of(*perlang::UTF8String::from_copied_string("r")) == 6);
+    REQUIRE(compact->starts_with(*ascii));
+    REQUIRE(compact->ends_with(*perlang::UTF8String::from_copied_string("ås  ")));
+    REQUIRE_FALSE(compact->ends_with(*perlang::UTF8String::from_copied_string("€ ")));
+    REQUIRE(wide->starts_with(*perlang::UTF8String::from_copied_string("räk")));
+    REQUIRE(wide->ends_with(*perlang::UTF8String::from_copied_string("s€")));
+    REQUIRE_FALSE(wide->ends_with(*gas));
+}
+
+TEST_CASE( "perlang::UTF16String, trim() and replace() keep compact strings compact" )
+{
+    std::unique_ptr<perlang::UTF16String> compact = perlang::UTF16String::from_copied_string("  räksmörgås  ");
+
+    std::unique_ptr<perlang::String> trimmed = compact->trim();
+    std::unique_ptr<perlang::String> replaced = compact->replace(*perlang::UTF8String::from_copied_string("ö"), *perlang::ASCIIString::from_static_string("o"));
+    std::unique_ptr<perlang::String> widened = compact->replace(*perlang::UTF8String::from_copied_string("å"), *perlang::UTF8String::from_copied_string("€"));
+
+    // Assert
+    REQUIRE(std::string(trimmed->as_utf8()->bytes()) == "räksmörgås");
+    REQUIRE(static_cast<perlang::UTF16String&>(*trimmed).is_compact());
+    REQUIRE(std::string(replaced->as_utf8()->bytes()) == "  räksmorgås  ");
+    REQUIRE(static_cast<perlang::UTF16String&>(*replaced).is_compact());
+    REQUIRE(std::string(widened->as_utf8()->bytes()) == "  räksmörg€s  ");
+    REQUIRE_FALSE(static_cast<perlang::UTF16String&>(*widened).is_compact());
+}
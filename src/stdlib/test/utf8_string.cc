@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <memory>
+#include <typeinfo>
 
 #include "perlang_stdlib.h"
 
@@ -20,3 +21,208 @@ TEST_CASE( "perlang::UTF8String::is_ascii(), returns true for non-ASCII string"
     // Assert
     REQUIRE_FALSE(s->is_ascii());
 }
+
+TEST_CASE( "perlang::UTF8String::as_utf16(), returns an empty string for empty input" )
+{
+    std::unique_ptr<perlang::UTF16String> s = perlang::UTF8String::from_static_string("")->as_utf16();
+
+    // Assert
+    REQUIRE(s->length() == 0);
+}
+
+TEST_CASE( "perlang::UTF8String::as_utf16(), throws an exception on overlong sequences" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_static_string("this is an overlong slash: \xC0\xAF");
+
+    // Assert
+    REQUIRE_THROWS_WITH(s->as_utf16(), "Invalid UTF-8 sequence encountered (encoded using more bytes than necessary)");
+}
+
+TEST_CASE( "perlang::UTF8String::release_bytes(), returns a heap-allocated copy for short strings" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("åäö");
+    const char* inline_bytes = s->bytes();
+
+    std::unique_ptr<const char[]> bytes = s->release_bytes();
+
+    // Assert
+    REQUIRE(bytes.get() != inline_bytes);
+    REQUIRE(std::string(bytes.get()) == "åäö");
+}
+
+TEST_CASE( "perlang::UTF8String::operator+, produces correct results for both inline and heap-allocated strings" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("åäöÅÄ");
+
+    // 2 x 10 bytes fits inline, while 3 x 10 bytes does not.
+    std::unique_ptr<perlang::UTF8String> short_result = *s + *s;
+    std::unique_ptr<perlang::UTF8String> long_result = *short_result + *s;
+
+    // Assert
+    REQUIRE(std::string(short_result->bytes()) == "åäöÅÄåäöÅÄ");
+    REQUIRE(std::string(long_result->bytes()) == "åäöÅÄåäöÅÄåäöÅÄ");
+    REQUIRE_FALSE(long_result->is_ascii());
+}
+
+TEST_CASE( "perlang::UTF8String::operator+, converts UTF16String content" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("ö");
+    std::unique_ptr<perlang::UTF16String> ascii = perlang::UTF16String::from_copied_string("cd");
+    std::unique_ptr<perlang::UTF16String> non_ascii = perlang::UTF16String::from_copied_string("å€");
+
+    std::unique_ptr<perlang::String> ascii_result = *s + *ascii;
+    std::unique_ptr<perlang::String> non_ascii_result = *s + *non_ascii;
+
+    // Assert
+    REQUIRE(std::string(ascii_result->bytes()) == "öcd");
+    REQUIRE(std::string(non_ascii_result->bytes()) == "öå€");
+    REQUIRE(non_ascii_result->length() == 7);
+}
+
+TEST_CASE( "perlang::concat_shared(), with UTF8String operands" )
+{
+    std::unique_ptr<perlang::UTF8String> s1 = perlang::UTF8String::from_static_string("räksmörgås");
+    std::unique_ptr<perlang::UTF8String> s2 = perlang::UTF8String::from_static_string(" med ägg");
+    BigInt bigint("123456789012345678901234567890");
+
+    std::shared_ptr<perlang::UTF8String> result = perlang::concat_shared(*s1, *s2);
+    std::shared_ptr<perlang::UTF8String> int_result = perlang::concat_shared((uint32_t)42, *s2);
+    std::shared_ptr<const perlang::String> bigint_result = perlang::concat_shared(bigint, *s2);
+
+    // Assert
+    REQUIRE(std::string(result->bytes()) == "räksmörgås med ägg");
+    REQUIRE(result->to_string().get() == result.get());
+    REQUIRE(std::string(int_result->bytes()) == "42 med ägg");
+    REQUIRE(*perlang::concat_shared((int64_t)-1234567890123, *s2) == *((int64_t)-1234567890123 + *s2));
+    REQUIRE(*perlang::concat_shared(2.5f, *s2) == *(2.5f + *s2));
+    REQUIRE(*perlang::concat_shared(0.1, *s2) == *(0.1 + *s2));
+    REQUIRE(typeid(*bigint_result) == typeid(perlang::UTF8String));
+    REQUIRE(std::string(bigint_result->bytes()) == "123456789012345678901234567890 med ägg");
+}
+
+TEST_CASE( "perlang::UTF8String::from_literal(), includes embedded NUL characters in the length" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_literal("åäö\0x");
+
+    // Assert
+    REQUIRE(s->length() == 8);
+    REQUIRE(s->bytes()[7] == 'x');
+}
+
+TEST_CASE( "perlang::UTF8String::make_shared_copy(), copies strings on both sides of the inline capacity" )
+{
+    for (std::string original : { std::string("åäö"), std::string(perlang::UTF8String::INLINE_CAPACITY, 'x') + "åäö" }) {
+        std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::make_shared_copy(original.c_str(), original.length());
+
+        // Assert
+        REQUIRE(s->length() == original.length());
+        REQUIRE(std::string(s->bytes()) == original);
+        REQUIRE_FALSE(s->is_ascii());
+    }
+}
+
+TEST_CASE( "perlang::UTF8String::make_shared_literal(), borrows the literal" )
+{
+    static const char literal[] = "åäö";
+    std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::make_shared_literal(literal);
+
+    // Assert
+    REQUIRE(s->bytes() == literal);
+    REQUIRE(s->length() == 6);
+}
+
+TEST_CASE( "perlang::UTF8String::as_ascii(), shares the content of strings owned by a shared_ptr" )
+{
+    std::string content(100, 'x');
+    std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::make_shared_copy(content.c_str(), content.length());
+
+    auto ascii = s->as_ascii();
+    auto utf8 = s->as_utf8();
+
+    REQUIRE(ascii->bytes() == s->bytes());
+    REQUIRE(utf8->bytes() == s->bytes());
+    REQUIRE(std::string(ascii->bytes()) == content);
+}
+
+TEST_CASE( "perlang::UTF8String::as_ascii(), throws expected error for non-ASCII content" )
+{
+    std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::from_static_string("a string which is not ASCII: åäö");
+
+    REQUIRE_THROWS_WITH(s->as_ascii(), "Non-ASCII character encountered at index 29. This string cannot be converted to ASCIIString.");
+    REQUIRE(s->as_utf8()->bytes() == s->bytes());
+}
+
+TEST_CASE( "perlang::UTF8String::as_utf8(), copies short strings" )
+{
+    std::shared_ptr<perlang::UTF8String> s = perlang::UTF8String::make_shared_copy("åäö", 6);
+
+    auto utf8 = s->as_utf8();
+
+    REQUIRE(utf8->bytes() != s->bytes());
+    REQUIRE(*utf8 == *s);
+}
+
+TEST_CASE( "perlang::UTF8String::code_points(), iterates over the code points of the string" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("aå€🎉");
+    std::u32string code_points;
+
+    for (char32_t c : s->code_points()) {
+        code_points += c;
+    }
+
+    // Assert
+    REQUIRE(code_points == U"aå€🎉");
+}
+
+TEST_CASE( "perlang::UTF8String::code_points(), yields U+FFFD for each byte of invalid sequences" )
+{
+    // A truncated sequence, an encoded surrogate (CESU-8 style) and an overlong encoding of '/'.
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("a\xE2\x82 \xED\xA0\x80 \xC0\xAF");
+    std::u32string code_points;
+
+    for (char32_t c : s->code_points()) {
+        code_points += c;
+    }
+
+    // Assert
+    REQUIRE(code_points == U"a�� ��� ��");
+}
+
+TEST_CASE( "perlang::UTF8String::code_point_at(), returns code points of ASCII string" )
+{
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string("hello");
+
+    // Assert
+    REQUIRE(s->code_point_count() == 5);
+    REQUIRE(s->code_point_at(0) == U'h');
+    REQUIRE(s->code_point_at(4) == U'o');
+    REQUIRE_THROWS_AS(s->code_point_at(5), std::out_of_range);
+}
+
+TEST_CASE( "perlang::UTF8String::code_point_at(), matches sequential iteration for mixed content" )
+{
+    // Long enough to span many index entries, with ASCII runs of varying lengths between non-ASCII characters.
+    std::string content;
+
+    for (size_t i = 0; i < 500; i++) {
+        content += std::string(i % 97, 'x');
+        content += i % 3 == 0 ? "å" : i % 3 == 1 ? "€" : "🎉";
+    }
+
+    std::unique_ptr<perlang::UTF8String> s = perlang::UTF8String::from_copied_string(content.c_str());
+    std::u32string expected;
+
+    for (char32_t c : s->code_points()) {
+        expected += c;
+    }
+
+    // Assert
+    REQUIRE(s->code_point_count() == expected.length());
+
+    for (size_t i = 0; i < expected.length(); i++) {
+        REQUIRE(s->code_point_at(i) == expected[i]);
+    }
+
+    REQUIRE_THROWS_AS(s->code_point_at(expected.length()), std::out_of_range);
+}